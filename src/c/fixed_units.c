@@ -0,0 +1,64 @@
+#include "fixed_units.h"
+
+int32_t fixed_div_round(int32_t numerator, int32_t denominator) {
+  if (numerator >= 0) {
+    return (numerator + denominator / 2) / denominator;
+  }
+  return (numerator - denominator / 2) / denominator;
+}
+
+// --- Distance --- //
+
+int32_t fixed_steps_to_cm(int32_t steps) {
+  if (steps < 0) {
+    return 0;
+  }
+  if (steps > FIXED_MAX_STEPS) {
+    steps = FIXED_MAX_STEPS;
+  }
+  return steps * FIXED_STEP_LENGTH_CM;
+}
+
+int32_t fixed_cm_to_tenths_mile(int32_t cm) {
+  // 1 mile = 160934.4 cm, so tenths = cm / 16093.44 = cm * 25 / 402336
+  return fixed_div_round(cm * 25, 402336);
+}
+
+int32_t fixed_cm_to_tenths_km(int32_t cm) {
+  return fixed_div_round(cm, 10000);
+}
+
+// --- Temperature --- //
+
+int32_t fixed_dc_to_celsius(int32_t dc) {
+  return fixed_div_round(dc, 10);
+}
+
+int32_t fixed_dc_to_fahrenheit(int32_t dc) {
+  // F = dc / 10 * 9 / 5 + 32, rounded as a whole so ties go the same way as lround()
+  return fixed_div_round(dc * 9 + 1600, 50);
+}
+
+// --- Pressure --- //
+
+int32_t fixed_dhpa_to_hpa(int32_t dhpa) {
+  return fixed_div_round(dhpa, 10);
+}
+
+// --- Wind --- //
+
+int32_t fixed_dkmh_to_kph(int32_t dkmh) {
+  return fixed_div_round(dkmh, 10);
+}
+
+int32_t fixed_dkmh_to_mph(int32_t dkmh) {
+  // 1 mile = 1.609344 km, so mph = dkmh / 16.09344 = dkmh * 6250 / 100584
+  return fixed_div_round(dkmh * 6250, 100584);
+}
+
+// --- Precipitation --- //
+
+int32_t fixed_dmm_to_hundredths_inch(int32_t dmm) {
+  // 1 inch = 25.4 mm, so hundredths = dmm * 10 / 25.4 = dmm * 50 / 127
+  return fixed_div_round(dmm * 50, 127);
+}
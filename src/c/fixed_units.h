@@ -0,0 +1,40 @@
+#pragma once
+
+#include <pebble.h>
+
+// Integer unit conversions for the display. The watch has no FPU, so every
+// conversion is done in fixed point and rounded half away from zero, exactly
+// as lround() would round the real-valued result. Inputs use the record's
+// resolutions (see weather_record.h); results are what the display shows.
+//
+// Intermediate products stay within 32 bits for the documented input ranges.
+
+// Average step length used for walking distance
+#define FIXED_STEP_LENGTH_CM 76
+
+// Largest step count the distance conversions accept (larger counts are clamped)
+#define FIXED_MAX_STEPS 1000000
+
+// numerator / denominator, rounded half away from zero. denominator > 0.
+int32_t fixed_div_round(int32_t numerator, int32_t denominator);
+
+// Walking distance in centimetres for a step count
+int32_t fixed_steps_to_cm(int32_t steps);
+
+// Centimetres to tenths of a mile / tenths of a kilometre
+int32_t fixed_cm_to_tenths_mile(int32_t cm);
+int32_t fixed_cm_to_tenths_km(int32_t cm);
+
+// Tenths of a degree Celsius to whole degrees
+int32_t fixed_dc_to_celsius(int32_t dc);
+int32_t fixed_dc_to_fahrenheit(int32_t dc);
+
+// Tenths of hPa to whole hPa
+int32_t fixed_dhpa_to_hpa(int32_t dhpa);
+
+// Tenths of km/h to whole km/h / mph
+int32_t fixed_dkmh_to_kph(int32_t dkmh);
+int32_t fixed_dkmh_to_mph(int32_t dkmh);
+
+// Tenths of mm to hundredths of an inch
+int32_t fixed_dmm_to_hundredths_inch(int32_t dmm);
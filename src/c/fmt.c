@@ -0,0 +1,100 @@
+#include "fmt.h"
+
+void fmt_begin(Fmt *fmt, char *buffer, size_t size) {
+  fmt->buffer = buffer;
+  fmt->size = size;
+  fmt->length = 0;
+  fmt->changed = false;
+}
+
+bool fmt_end(Fmt *fmt) {
+  // A longer old text ends later
+  if (fmt->buffer[fmt->length] != '\0') {
+    fmt->buffer[fmt->length] = '\0';
+    fmt->changed = true;
+  }
+  return fmt->changed;
+}
+
+void fmt_char(Fmt *fmt, char c) {
+  if (fmt->length + 1 >= fmt->size) {
+    return; // Truncated; the terminator still fits
+  }
+  if (fmt->buffer[fmt->length] != c) {
+    fmt->buffer[fmt->length] = c;
+    fmt->changed = true;
+  }
+  fmt->length++;
+}
+
+void fmt_strn(Fmt *fmt, const char *str, size_t length) {
+  for (size_t i = 0; i < length && str[i]; i++) {
+    fmt_char(fmt, str[i]);
+  }
+}
+
+void fmt_str(Fmt *fmt, const char *str) {
+  while (*str) {
+    fmt_char(fmt, *str++);
+  }
+}
+
+// --- Numbers --- //
+
+// Digits of magnitude, most significant first, at least width of them
+static void fmt_digits(Fmt *fmt, uint32_t magnitude, uint8_t width) {
+  char digits[10];
+  uint8_t count = 0;
+  do {
+    digits[count++] = (char)('0' + magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude);
+  while (width > count) {
+    fmt_char(fmt, '0');
+    width--;
+  }
+  while (count) {
+    fmt_char(fmt, digits[--count]);
+  }
+}
+
+// Unsigned, so INT32_MIN negates without overflow
+static uint32_t magnitude_of(int32_t value) {
+  return value < 0 ? 0u - (uint32_t)value : (uint32_t)value;
+}
+
+void fmt_int_width(Fmt *fmt, int32_t value, uint8_t width) {
+  if (value < 0) {
+    fmt_char(fmt, '-');
+    width = width ? width - 1 : 0; // The sign counts towards the width
+  }
+  fmt_digits(fmt, magnitude_of(value), width);
+}
+
+void fmt_int(Fmt *fmt, int32_t value) {
+  fmt_int_width(fmt, value, 1);
+}
+
+static void fmt_fixed_magnitude(Fmt *fmt, uint32_t magnitude, uint8_t decimals) {
+  uint32_t scale = 1;
+  for (uint8_t i = 0; i < decimals; i++) {
+    scale *= 10;
+  }
+  fmt_digits(fmt, magnitude / scale, 1);
+  if (decimals) {
+    fmt_char(fmt, '.');
+    fmt_digits(fmt, magnitude % scale, decimals);
+  }
+}
+
+void fmt_fixed(Fmt *fmt, int32_t value, uint8_t decimals) {
+  if (value < 0) {
+    fmt_char(fmt, '-');
+  }
+  fmt_fixed_magnitude(fmt, magnitude_of(value), decimals);
+}
+
+void fmt_fixed_signed(Fmt *fmt, int32_t value, uint8_t decimals) {
+  fmt_char(fmt, value < 0 ? '-' : '+');
+  fmt_fixed_magnitude(fmt, magnitude_of(value), decimals);
+}
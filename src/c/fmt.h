@@ -0,0 +1,40 @@
+#pragma once
+
+#include <pebble.h>
+
+// Small text formatting for the display lines: strings, integers and fixed
+// point decimals appended in place, instead of snprintf() with a format
+// string to parse on every call.
+//
+// Text is written straight into the destination, typically a layer's static
+// buffer, comparing as it goes: bytes that already match are not rewritten,
+// and fmt_end() says whether the text changed, so callers can skip the
+// redraw without formatting into a scratch copy first. Like snprintf(), the
+// result is always terminated and silently truncated to fit.
+
+typedef struct {
+  char *buffer;
+  size_t size;
+  size_t length;
+  bool changed;
+} Fmt;
+
+// Start formatting over the text in buffer (size > 0)
+void fmt_begin(Fmt *fmt, char *buffer, size_t size);
+
+// Terminate the text. Returns true if it differs from what buffer held.
+bool fmt_end(Fmt *fmt);
+
+void fmt_char(Fmt *fmt, char c);
+void fmt_str(Fmt *fmt, const char *str);
+void fmt_strn(Fmt *fmt, const char *str, size_t length);
+
+// Decimal integer, padded with zeros to width characters as "%0*d" does
+void fmt_int(Fmt *fmt, int32_t value);
+void fmt_int_width(Fmt *fmt, int32_t value, uint8_t width);
+
+// value in units of 10^-decimals (up to 9), e.g. (25, 1) is "2.5" and
+// (-8, 1) "-0.8". fmt_fixed_signed() also writes '+' for zero and above, as
+// trends are shown.
+void fmt_fixed(Fmt *fmt, int32_t value, uint8_t decimals);
+void fmt_fixed_signed(Fmt *fmt, int32_t value, uint8_t decimals);
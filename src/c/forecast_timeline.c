@@ -0,0 +1,75 @@
+#include "forecast_timeline.h"
+
+// --- Ring --- //
+
+static inline ForecastEntry *entry_at(ForecastTimeline *timeline, uint8_t index) {
+  return &timeline->entries[(timeline->head + index) % FORECAST_TIMELINE_MAX_ENTRIES];
+}
+
+void forecast_timeline_clear(ForecastTimeline *timeline) {
+  timeline->head = 0;
+  timeline->count = 0;
+}
+
+bool forecast_timeline_push(ForecastTimeline *timeline, const ForecastEntry *entry) {
+  if (timeline->count > 0 && entry->time <= entry_at(timeline, timeline->count - 1)->time) {
+    return false;
+  }
+  if (timeline->count == FORECAST_TIMELINE_MAX_ENTRIES) {
+    timeline->head = (timeline->head + 1) % FORECAST_TIMELINE_MAX_ENTRIES;
+    timeline->count--;
+  }
+  *entry_at(timeline, timeline->count) = *entry;
+  timeline->count++;
+  return true;
+}
+
+const ForecastEntry *forecast_timeline_advance(ForecastTimeline *timeline, time_t now) {
+  if (timeline->count == 0 || entry_at(timeline, 0)->time > now) {
+    return NULL;
+  }
+  while (timeline->count > 1 && entry_at(timeline, 1)->time <= now) {
+    timeline->head = (timeline->head + 1) % FORECAST_TIMELINE_MAX_ENTRIES;
+    timeline->count--;
+  }
+  return entry_at(timeline, 0);
+}
+
+// --- Decoding --- //
+
+static inline uint16_t read_u16(const uint8_t *p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t read_u32(const uint8_t *p) {
+  return (uint32_t)read_u16(p) | ((uint32_t)read_u16(p + 2) << 16);
+}
+
+bool forecast_timeline_decode(const uint8_t *data, uint16_t length, ForecastTimeline *timeline) {
+  if (!data || length < FORECAST_TIMELINE_HEADER_SIZE || data[0] != FORECAST_TIMELINE_VERSION) {
+    return false;
+  }
+  uint32_t start = read_u32(&data[1]);
+  uint8_t count = data[5];
+  if (count > FORECAST_TIMELINE_MAX_ENTRIES ||
+      length < FORECAST_TIMELINE_HEADER_SIZE + count * FORECAST_TIMELINE_ENTRY_SIZE) {
+    return false;
+  }
+
+  ForecastTimeline decoded;
+  forecast_timeline_clear(&decoded);
+  const uint8_t *p = data + FORECAST_TIMELINE_HEADER_SIZE;
+  for (uint8_t i = 0; i < count; i++, p += FORECAST_TIMELINE_ENTRY_SIZE) {
+    ForecastEntry entry = {
+      .time = (time_t)(start + p[0] * 15 * 60),
+      .condition = p[1],
+      .temperature_dc = (int16_t)read_u16(&p[2]),
+      .precip_dmm = read_u16(&p[4]),
+    };
+    if (!forecast_timeline_push(&decoded, &entry)) {
+      return false;
+    }
+  }
+  *timeline = decoded;
+  return true;
+}
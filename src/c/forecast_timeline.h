@@ -0,0 +1,60 @@
+#pragma once
+
+#include <pebble.h>
+
+// Forecast for the hours after a fetch, sent by the companion as a single
+// byte-array tuple (MESSAGE_KEY_FORECAST_TIMELINE) after each weather record.
+// Built by src/pkjs/forecast_timeline.js -- the two files must agree on the
+// layout.
+//
+// Layout, little-endian:
+//   u8  version            FORECAST_TIMELINE_VERSION
+//   u32 start              UTC seconds of the first entry
+//   u8  count              entries that follow, at most FORECAST_TIMELINE_MAX_ENTRIES
+// then per entry, in time order:
+//   u8  offset             quarter hours after start
+//   u8  condition          WMO weather code
+//   s16 temperature        tenths of a degree Celsius
+//   u16 precip             total for that entry's day, tenths of mm
+//
+// The companion sends 15-minute entries for the next few hours, then hourly
+// ones; the watch steps its display through them between fetches.
+
+#define FORECAST_TIMELINE_VERSION 1
+#define FORECAST_TIMELINE_HEADER_SIZE 6
+#define FORECAST_TIMELINE_ENTRY_SIZE 6
+#define FORECAST_TIMELINE_MAX_ENTRIES 24
+
+// Must match MAX_SIZE in forecast_timeline.js
+#define FORECAST_TIMELINE_MAX_SIZE \
+  (FORECAST_TIMELINE_HEADER_SIZE + FORECAST_TIMELINE_MAX_ENTRIES * FORECAST_TIMELINE_ENTRY_SIZE)
+
+typedef struct {
+  time_t time;
+  int16_t temperature_dc;
+  uint16_t precip_dmm;
+  uint8_t condition;
+} ForecastEntry;
+
+// Entries in time order in a fixed ring. head is the earliest entry kept.
+typedef struct {
+  ForecastEntry entries[FORECAST_TIMELINE_MAX_ENTRIES];
+  uint8_t head;
+  uint8_t count;
+} ForecastTimeline;
+
+void forecast_timeline_clear(ForecastTimeline *timeline);
+
+// Append an entry later than every entry held, dropping the earliest if the
+// ring is full. Returns false (and appends nothing) if it is out of order.
+bool forecast_timeline_push(ForecastTimeline *timeline, const ForecastEntry *entry);
+
+// Replace the timeline with a decoded one. Returns false, leaving the
+// timeline untouched, if the version is unknown, the data is short or the
+// entries are out of order.
+bool forecast_timeline_decode(const uint8_t *data, uint16_t length, ForecastTimeline *timeline);
+
+// The entry in effect at now - the latest one at or before it - or NULL if
+// the timeline is empty or still in the future. Entries before that one are
+// dropped, so stepping through the timeline is O(1) per call.
+const ForecastEntry *forecast_timeline_advance(ForecastTimeline *timeline, time_t now);
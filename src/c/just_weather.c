@@ -1,35 +1,58 @@
 #include <pebble.h>
 
+#include "fixed_units.h"
+#include "fmt.h"
+#include "forecast_timeline.h"
+#include "memory_telemetry.h"
+#include "pressure_history.h"
+#include "weather_record.h"
+
 // We'll use these keys to send data from JS to C
-#define MESSAGE_KEY_PRESSURE 0
-#define MESSAGE_KEY_TEMPERATURE 1
-#define MESSAGE_KEY_CONDITIONS 2
-#define MESSAGE_KEY_HUMIDITY 3
-#define MESSAGE_KEY_WIND 4
-#define MESSAGE_KEY_PRECIP 5
-#define MESSAGE_KEY_LOCATION 6
-#define MESSAGE_KEY_PRESSURE_TREND 7
-// Diagnostic/test key sent from the companion to indicate HTTPS/XHR test result
-#define MESSAGE_KEY_PRESSURE_TEST 8
-// Unit labels sent from JS to ensure correct display
-#define MESSAGE_KEY_TEMP_UNIT 9
-#define MESSAGE_KEY_WIND_UNIT 10  
-#define MESSAGE_KEY_PRECIP_UNIT 11
-#define MESSAGE_KEY_HOURLY_VIBRATION 12
-#define MESSAGE_KEY_UPDATE_COUNTDOWN 13
-#define MESSAGE_KEY_SHOW_STEPS 14
-#define MESSAGE_KEY_STEP_UNIT 15
-#define MESSAGE_KEY_STEP_COUNT 16
-#define MESSAGE_KEY_STEP_DISTANCE 17
-#define MESSAGE_KEY_STORM_WARNING 18
+// Weather readings, units and settings arrive packed in one byte array (see weather_record.h)
+#define MESSAGE_KEY_WEATHER_RECORD 19
+// The forecast for the next hours follows in its own message (see forecast_timeline.h)
+#define MESSAGE_KEY_FORECAST_TIMELINE 20
+// And from C to JS: 1 when the watch enters low-power mode, 0 when it leaves
+#define MESSAGE_KEY_POWER_MODE 21
+
+// AppMessage buffers: the phone sends one record or timeline tuple per
+// message and the watch only sends its power mode, so the outbox only needs
+// room for one small tuple
+#define INBOX_MAX_TUPLE (FORECAST_TIMELINE_MAX_SIZE > WEATHER_RECORD_MAX_SIZE ? FORECAST_TIMELINE_MAX_SIZE \
+                                                                             : WEATHER_RECORD_MAX_SIZE)
+#define INBOX_SIZE dict_calc_buffer_size(1, INBOX_MAX_TUPLE)
+#define OUTBOX_SIZE dict_calc_buffer_size(1, (uint32_t)sizeof(uint32_t))
+
+// Redraw the step line only once the count has moved this far (override with -D)
+#ifndef STEP_REDRAW_MIN_DELTA
+#define STEP_REDRAW_MIN_DELTA 10
+#endif
+
+// Health movement events arriving within this window share one step query
+#define STEP_COALESCE_MS 5000
+
+// Persistent storage keys
+#define PERSIST_KEY_WEATHER 1
+#define PERSIST_KEY_FORECAST 2 // The last timeline message, as received
+#define PERSIST_KEY_PRESSURE 3 // PressureHistory
+
+// Bump when WeatherSnapshot changes so an old snapshot is dropped, not misread
+#define WEATHER_SNAPSHOT_VERSION 4
+
+// The phone fetches at least hourly; older weather is shown with its age
+#define WEATHER_STALE_SECONDS (90 * 60)
+
+// Countdown length when the companion has not said when it fetches next
+#define DEFAULT_FETCH_INTERVAL_SECONDS (15 * 60)
+
+// On battery the face saves power at or below this charge, and keeps saving
+// until it charges or climbs back to LOW_POWER_LEAVE_PERCENT, so a reading
+// that bounces back a step does not end it
+#define LOW_POWER_ENTER_PERCENT 20
+#define LOW_POWER_LEAVE_PERCENT 40
 
 static Window *s_main_window;
-static TextLayer *s_time_layer;
-static TextLayer *s_location_layer;
 static Layer *s_update_progress_layer;
-static TextLayer *s_temp_cond_layer;
-static TextLayer *s_pressure_layer;
-static TextLayer *s_wind_precip_layer;
 // Icon layer removed: conditions will be shown as text only
 
 // Condition icon code: 0=clear,1=partly,2=cloudy,3=rain,4=snow,5=fog,6=unknown
@@ -37,11 +60,21 @@ static TextLayer *s_wind_precip_layer;
 // Draw a simple 32x32 monochrome icon for the current condition code
 // icon_layer removed — using text-only conditions
 
-// A buffer to hold the pressure string, e.g., "1012 hPa"
-// Buffers for displayed strings
+// Buffers for displayed strings - each holds exactly what its layer shows,
+// so a redraw can be skipped when the new text is the same
+static char s_time_buffer[8]; // "00:00"
 static char s_pressure_buffer[32];
 static char s_temp_cond_buffer[48];
-static char s_wind_precip_buffer[40];
+static char s_wind_precip_buffer[40]; // wind/precip, or steps when enabled
+static char s_location_buffer[WEATHER_RECORD_LOCATION_MAX + 1];
+
+// Layer redraws requested, logged and reset at the top of each hour
+static int s_redraws_this_hour = 0;
+static int s_redraws_last_hour = 0;
+
+// Latest readings and settings from the companion. Messages usually carry
+// only the fields that changed, so every line is redrawn from this state.
+static WeatherRecord s_weather;
 
 // Hourly vibration setting
 static bool s_hourly_vibration_enabled = false;
@@ -50,18 +83,60 @@ static bool s_storm_warning_enabled = false; // Experimental storm warning featu
 static int s_last_hour = -1;
 
 // Storm warning state tracking
-static bool s_storm_warning_active = false;
+static PressureStormLevel s_storm_level = PRESSURE_STORM_NONE;
 static int s_last_storm_trend = 0;
 
+// Pressure at each fetch, for the trend and storm warning
+static PressureHistory s_pressure_history;
+
 // Update progress tracking
 static time_t s_last_weather_update = 0;
+static time_t s_next_fetch_time = 0; // 0 = not announced by the companion
+static int s_shown_stale_hours = 0;
+static int s_shown_filled_dots = -1;
+
+// Forecast steps still to come, and the one shown over the companion's
+// readings since the last fetch (s_forecast_shown is 0 when there is none).
+// Only entries after the last fetch are shown; older ones are superseded by
+// it. s_weather itself only ever holds what the companion sent, so its
+// deltas still apply to it.
+static ForecastTimeline s_forecast;
+static ForecastEntry s_forecast_overlay;
+static time_t s_forecast_shown = 0;
+
+// Pre-rendered progress line with all dots filled / all empty (see progress_layer_draw)
+static GBitmap *s_progress_strip_filled = NULL;
+static GBitmap *s_progress_strip_empty = NULL;
+static bool s_progress_strip_failed = false;
+
+// Everything needed to redraw the last weather after a restart, so the face
+// doesn't sit on "Loading..." until the phone answers
+typedef struct {
+  uint8_t version;
+  uint8_t storm_level;
+  int16_t last_storm_trend;
+  int32_t last_weather_update;
+  int32_t next_fetch_time;
+  WeatherRecord weather; // location is stored separately, the pointer is not restored
+  char location[WEATHER_RECORD_LOCATION_MAX + 1];
+} WeatherSnapshot;
 
 // Step tracking settings and data
 static bool s_show_steps_enabled = false;
 static bool s_step_unit_miles = true; // true = miles, false = kilometers
-static char s_step_display_buffer[64];
 static int s_current_step_count = 0;
 static int s_current_step_distance = 0;
+static int s_shown_step_count = -1;
+static bool s_step_events_subscribed = false;
+static AppTimer *s_step_refresh_timer = NULL;
+
+// Low-power mode: no Health events, no countdown redraws between fetches,
+// and the companion fetches less often. Entered on a low battery or by the
+// power save setting, left on the charger.
+static bool s_power_save_enabled = false;
+static bool s_low_power = false;
+static bool s_power_mode_acked = false; // The companion has acknowledged s_low_power
+static bool s_power_mode_in_flight = false;
 
 // Step icon bitmap resources
 static GBitmap *s_shoe_icon_bitmap = NULL;
@@ -70,404 +145,773 @@ static BitmapLayer *s_shoe_icon_layer = NULL;
 // --- Function Declarations --- //
 static void progress_layer_draw(Layer *layer, GContext *ctx);
 static int calculate_progress_layer_y_position(void);
+static void update_progress_bar(void);
 static void update_step_data(void);
 static void update_step_display(void);
+static void set_step_events_enabled(bool enabled);
 static void load_step_icon(void);
 static void unload_step_icon(void);
 static void destroy_step_icon_layer(void);
+static void apply_settings(uint8_t settings);
+static void update_power_mode(BatteryChargeState charge);
+static void send_power_mode(void);
 
-// --- AppMessage Handlers --- //
+// --- Persistence --- //
 
-// This function runs every time the watch receives a message from the phone
-static void inbox_received_callback(DictionaryIterator *iterator, void *context) {
-  // First, declare all tuples we'll need
-  Tuple *pressure_tuple = dict_find(iterator, MESSAGE_KEY_PRESSURE);
-  Tuple *temp_tuple = dict_find(iterator, MESSAGE_KEY_TEMPERATURE);
-  Tuple *cond_tuple = dict_find(iterator, MESSAGE_KEY_CONDITIONS);
-  Tuple *loc_tuple = dict_find(iterator, MESSAGE_KEY_LOCATION);
-  Tuple *wind_tuple = dict_find(iterator, MESSAGE_KEY_WIND);
-  Tuple *precip_tuple = dict_find(iterator, MESSAGE_KEY_PRECIP);
-  
-  // Unit labels from JS
-  Tuple *temp_unit_tuple = dict_find(iterator, MESSAGE_KEY_TEMP_UNIT);
-  Tuple *wind_unit_tuple = dict_find(iterator, MESSAGE_KEY_WIND_UNIT);  
-  Tuple *precip_unit_tuple = dict_find(iterator, MESSAGE_KEY_PRECIP_UNIT);
-
-  // If the companion sent a diagnostic/test key, show a short status immediately
-  Tuple *test_tuple = dict_find(iterator, MESSAGE_KEY_PRESSURE_TEST);
-  if (test_tuple) {
-    // If it's an integer, 1=success, 0=failure. Otherwise show the raw cstring if present.
-    if (test_tuple->type == TUPLE_INT) {
-      int v = (int)test_tuple->value->int32;
-      if (v) {
-        text_layer_set_text(s_pressure_layer, "Conn OK");
-      } else {
-        text_layer_set_text(s_pressure_layer, "Conn FAIL");
-      }
-    } else if (test_tuple->type == TUPLE_CSTRING && test_tuple->value->cstring) {
-      text_layer_set_text(s_pressure_layer, test_tuple->value->cstring);
-    }
-    // We don't return here — allow pressure/other keys in same message to still be processed
+static void save_weather_snapshot(void) {
+  WeatherSnapshot snapshot;
+  memset(&snapshot, 0, sizeof(snapshot));
+  snapshot.version = WEATHER_SNAPSHOT_VERSION;
+  snapshot.storm_level = (uint8_t)s_storm_level;
+  snapshot.last_storm_trend = s_last_storm_trend;
+  snapshot.last_weather_update = (int32_t)s_last_weather_update;
+  snapshot.next_fetch_time = (int32_t)s_next_fetch_time;
+  snapshot.weather = s_weather;
+  snapshot.weather.location = NULL;
+  snapshot.weather.location_length = 0;
+  memcpy(snapshot.location, s_location_buffer, sizeof(snapshot.location));
+
+  status_t result = persist_write_data(PERSIST_KEY_WEATHER, &snapshot, sizeof(snapshot));
+  if (result < 0) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "save_weather_snapshot: persist_write_data failed (%d)", (int)result);
   }
+}
 
-  if (pressure_tuple) {
-    // We have the pressure! Read it as an integer
-    int pressure_val = (int)pressure_tuple->value->int32;
+// Called before the window loads, so settings only need their flags set
+static void restore_weather_snapshot(void) {
+  WeatherSnapshot snapshot;
+  int read = persist_read_data(PERSIST_KEY_WEATHER, &snapshot, sizeof(snapshot));
+  if (read != (int)sizeof(snapshot) || snapshot.version != WEATHER_SNAPSHOT_VERSION) {
+    return; // Nothing saved yet, or saved by an older build
+  }
 
-    // Update the weather update timestamp
-    s_last_weather_update = time(NULL);
-    
-    // Log the received pressure for diagnostics
-    APP_LOG(APP_LOG_LEVEL_INFO, "inbox_received_callback: received PRESSURE=%d", pressure_val);
-
-    /* If the JS sent a PRESSURE_TREND tuple, prefer to display a short
-       arrow next to the pressure (e.g. "1013 hPa ↑"). The JS currently
-       sends a string like "↑+0.8hPa". We will append that string (or a
-       single arrow derived from an integer trend) after the pressure. */
-    char trend_suffix[24] = "";
-    Tuple *trend_tuple = dict_find(iterator, MESSAGE_KEY_PRESSURE_TREND);
-    if (trend_tuple) {
-      if (trend_tuple->type == TUPLE_CSTRING && trend_tuple->value->cstring) {
-        // Append a space then the provided trend string (expected like "+0.8")
-        snprintf(trend_suffix, sizeof(trend_suffix), " %s", trend_tuple->value->cstring);
-      } else if (trend_tuple->type == TUPLE_INT) {
-        /* If JS sent an integer tenths-of-hPa value, format it as "+X.Y" */
-        int t = (int)trend_tuple->value->int32; /* tenths */
-        char sign = (t >= 0) ? '+' : '-';
-        int a = t >= 0 ? t : -t;
-        snprintf(trend_suffix, sizeof(trend_suffix), " %c%d.%d", sign, a / 10, a % 10);
-      }
-    }
+  s_weather = snapshot.weather;
+  s_storm_level = (PressureStormLevel)snapshot.storm_level;
+  s_last_storm_trend = snapshot.last_storm_trend;
+  s_last_weather_update = (time_t)snapshot.last_weather_update;
+  s_next_fetch_time = (time_t)snapshot.next_fetch_time;
+  memcpy(s_location_buffer, snapshot.location, sizeof(s_location_buffer));
+  s_location_buffer[sizeof(s_location_buffer) - 1] = '\0';
 
-    // Format the pressure with temperature into our buffer with the trend suffix
-    // Get temperature from the global temp value if available
-    if (temp_tuple) {
-      int temp_val = (int)temp_tuple->value->int32;
-      char temp_unit[4] = "C";
-      if (temp_unit_tuple && temp_unit_tuple->type == TUPLE_CSTRING && temp_unit_tuple->value->cstring) {
-        snprintf(temp_unit, sizeof(temp_unit), "%s", temp_unit_tuple->value->cstring);
-      }
-      
-      // Check for storm warning conditions (experimental feature)
-      bool storm_warning = false;
-      if (s_storm_warning_enabled && trend_tuple && trend_tuple->type == TUPLE_INT) {
-        int trend_tenths = (int)trend_tuple->value->int32;
-        // Storm warning: pressure drop of 30+ tenths (3.0+ mb) in 3 hours
-        if (trend_tenths <= -30) {
-          storm_warning = true;
-        }
+  if (s_weather.present & WEATHER_FIELD_SETTINGS) {
+    // main_window_load lays out for the countdown setting, no relayout needed
+    s_update_countdown_enabled = (s_weather.settings & WEATHER_SETTING_UPDATE_COUNTDOWN) != 0;
+    apply_settings(s_weather.settings);
+  }
+  APP_LOG(APP_LOG_LEVEL_INFO, "Restored weather from %d s ago (fields=0x%x)",
+          (int)(time(NULL) - s_last_weather_update), s_weather.present);
+
+  uint8_t forecast[FORECAST_TIMELINE_MAX_SIZE];
+  read = persist_read_data(PERSIST_KEY_FORECAST, forecast, sizeof(forecast));
+  if (read > 0) {
+    forecast_timeline_decode(forecast, (uint16_t)read, &s_forecast);
+  }
+}
+
+// Whole hours since the last fetch once the weather is stale, otherwise 0
+static int stale_weather_hours(void) {
+  if (s_last_weather_update == 0) {
+    return 0;
+  }
+  time_t age = time(NULL) - s_last_weather_update;
+  return age >= WEATHER_STALE_SECONDS ? (int)(age / 3600) : 0;
+}
+
+static void restore_pressure_history(void) {
+  if (persist_read_data(PERSIST_KEY_PRESSURE, &s_pressure_history, sizeof(s_pressure_history)) !=
+          (int)sizeof(s_pressure_history) ||
+      s_pressure_history.count > PRESSURE_HISTORY_SAMPLES) {
+    pressure_history_clear(&s_pressure_history);
+  }
+}
+
+// Once the history covers enough time, show the watch's own 3-hour trend
+// instead of the companion's
+static void apply_pressure_trend(void) {
+  int16_t trend_3h;
+  if (pressure_history_trend(&s_pressure_history, 3 * 60 * 60, &trend_3h)) {
+    s_weather.trend_dhpa = trend_3h;
+    s_weather.present |= WEATHER_FIELD_TREND;
+  }
+}
+
+// Add the reading from a fetch to the history
+static void record_pressure(void) {
+  if (!(s_weather.present & WEATHER_FIELD_PRESSURE)) {
+    return;
+  }
+  pressure_history_add(&s_pressure_history, time(NULL), s_weather.pressure_dhpa);
+  status_t result = persist_write_data(PERSIST_KEY_PRESSURE, &s_pressure_history, sizeof(s_pressure_history));
+  if (result < 0) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "record_pressure: persist_write_data failed (%d)", (int)result);
+  }
+  apply_pressure_trend();
+}
+
+// --- Data Rows --- //
+
+// The lines of text on the face, top to bottom. Each is a TextLayer, or with
+// SINGLE_DATA_LAYER (SINGLE_DATA_LAYER=1 pebble build) a row of one custom
+// layer that draws them all.
+typedef enum {
+  ROW_TIME,
+  ROW_LOCATION,
+  ROW_CONDITIONS,
+  ROW_PRESSURE,
+  ROW_WIND_PRECIP,
+  ROW_COUNT
+} DataRow;
+
+#if defined(SINGLE_DATA_LAYER)
+
+// Room either side of a row's measured text for glyphs that overhang it
+#define ROW_INK_MARGIN 2
+
+typedef struct {
+  const char *text;
+  GFont font;
+  GTextOverflowMode overflow_mode;
+  GRect frame; // Layout box in the data layer
+  GRect drawn; // Where the text went when last drawn, measured when it changed
+  bool changed; // Text or frame changed since the last draw
+} DataRowState;
+
+static Layer *s_data_layer;
+static DataRowState s_rows[ROW_COUNT];
+static bool s_rows_redraw_all = true;
+
+static bool rects_overlap(GRect a, GRect b) {
+  grect_clip(&a, &b);
+  return !grect_is_empty(&a);
+}
+
+// Where the row's text lands, centred in its frame
+static GRect measure_row_text(const DataRowState *row) {
+  if (!row->text[0]) {
+    return GRectZero;
+  }
+  GSize size = graphics_text_layout_get_content_size(row->text, row->font, row->frame, row->overflow_mode,
+                                                     GTextAlignmentCenter);
+  GRect rect = GRect(row->frame.origin.x + (row->frame.size.w - size.w) / 2 - ROW_INK_MARGIN,
+                     row->frame.origin.y, size.w + 2 * ROW_INK_MARGIN, size.h);
+  grect_clip(&rect, &row->frame);
+  return rect;
+}
+
+// The window has no background, so the last frame is still on screen: only
+// rows that changed are cleared and drawn again, along with any row their
+// old or new text overlaps. Text is measured only when it changes.
+static void data_layer_draw(Layer *layer, GContext *ctx) {
+  GRect cleared[2 * ROW_COUNT];
+  int cleared_count = 0;
+  bool redraw[ROW_COUNT];
+
+  graphics_context_set_fill_color(ctx, GColorWhite);
+  if (s_rows_redraw_all) {
+    graphics_fill_rect(ctx, layer_get_bounds(layer), 0, GCornerNone);
+  }
+  for (int i = 0; i < ROW_COUNT; i++) {
+    DataRowState *row = &s_rows[i];
+    redraw[i] = s_rows_redraw_all || row->changed;
+    if (!row->changed) {
+      continue;
+    }
+    GRect was = row->drawn;
+    row->drawn = measure_row_text(row);
+    row->changed = false;
+    if (!s_rows_redraw_all) {
+      if (!grect_is_empty(&was)) {
+        graphics_fill_rect(ctx, was, 0, GCornerNone);
+        cleared[cleared_count++] = was;
       }
-      
-      if (storm_warning) {
-        snprintf(s_pressure_buffer, sizeof(s_pressure_buffer), "%d%s • %d mb%s ⚠️", temp_val, temp_unit, pressure_val, trend_suffix);
-      } else {
-        snprintf(s_pressure_buffer, sizeof(s_pressure_buffer), "%d%s • %d mb%s", temp_val, temp_unit, pressure_val, trend_suffix);
+      if (!grect_is_empty(&row->drawn)) {
+        graphics_fill_rect(ctx, row->drawn, 0, GCornerNone);
+        cleared[cleared_count++] = row->drawn;
       }
-    } else {
-      snprintf(s_pressure_buffer, sizeof(s_pressure_buffer), "%d mb%s", pressure_val, trend_suffix);
     }
+  }
+  for (int i = 0; i < ROW_COUNT; i++) {
+    for (int c = 0; !redraw[i] && c < cleared_count; c++) {
+      redraw[i] = rects_overlap(s_rows[i].drawn, cleared[c]);
+    }
+  }
 
-    // Set the text on our Pressure TextLayer
-    text_layer_set_text(s_pressure_layer, s_pressure_buffer);
-  } else {
-    // Log for diagnosis (the message came in but no PRESSURE tuple was found)
-    APP_LOG(APP_LOG_LEVEL_INFO, "inbox_received_callback: no PRESSURE tuple found in incoming message");
+  graphics_context_set_text_color(ctx, GColorBlack);
+  for (int i = 0; i < ROW_COUNT; i++) {
+    const DataRowState *row = &s_rows[i];
+    if (redraw[i] && row->text[0]) {
+      graphics_draw_text(ctx, row->text, row->font, row->frame, row->overflow_mode, GTextAlignmentCenter, NULL);
+    }
   }
+  s_rows_redraw_all = false;
+}
 
-  // Temperature and Conditions - now just conditions since temp moved to pressure line
-  
-  APP_LOG(APP_LOG_LEVEL_INFO, "Keys found: temp=%s cond=%s wind=%s precip=%s", 
-    temp_tuple ? "YES" : "NO", cond_tuple ? "YES" : "NO", wind_tuple ? "YES" : "NO", precip_tuple ? "YES" : "NO");
+#else
 
-  // Location
-  if (loc_tuple && loc_tuple->type == TUPLE_CSTRING) {
-    text_layer_set_text(s_location_layer, loc_tuple->value->cstring);
+static TextLayer *s_row_layers[ROW_COUNT];
+
+#endif
+
+// Add a centred row of black text; the first one creates the data layer
+static void create_data_row(Layer *window_layer, DataRow row, GRect frame, GFont font,
+                            GTextOverflowMode overflow_mode, const char *text) {
+  #if defined(SINGLE_DATA_LAYER)
+  if (!s_data_layer) {
+    s_data_layer = layer_create(layer_get_bounds(window_layer));
+    layer_set_update_proc(s_data_layer, data_layer_draw);
+    layer_add_child(window_layer, s_data_layer);
+    s_rows_redraw_all = true;
+  }
+  s_rows[row] = (DataRowState) {
+    .text = text, .font = font, .overflow_mode = overflow_mode, .frame = frame, .changed = true
+  };
+  #else
+  TextLayer *layer = text_layer_create(frame);
+  text_layer_set_background_color(layer, GColorClear);
+  text_layer_set_text_color(layer, GColorBlack);
+  text_layer_set_font(layer, font);
+  text_layer_set_text_alignment(layer, GTextAlignmentCenter);
+  text_layer_set_overflow_mode(layer, overflow_mode);
+  text_layer_set_text(layer, text);
+  layer_add_child(window_layer, text_layer_get_layer(layer));
+  s_row_layers[row] = layer;
+  #endif
+}
+
+static void destroy_data_rows(void) {
+  #if defined(SINGLE_DATA_LAYER)
+  layer_destroy(s_data_layer);
+  s_data_layer = NULL;
+  #else
+  for (int i = 0; i < ROW_COUNT; i++) {
+    text_layer_destroy(s_row_layers[i]);
+    s_row_layers[i] = NULL;
   }
+  #endif
+}
 
-  // Temperature and Conditions - now just conditions since temp moved to pressure line
-  // Check for storm warning override (experimental feature)
-  bool show_storm_warning = false;
-  
-  if (s_storm_warning_enabled && pressure_tuple && pressure_tuple->type == TUPLE_INT) {
-    Tuple *trend_tuple = dict_find(iterator, MESSAGE_KEY_PRESSURE_TREND);
-    if (trend_tuple && trend_tuple->type == TUPLE_INT) {
-      int trend_tenths = (int)trend_tuple->value->int32;
-      if (trend_tenths <= -50) {
-        // Severe storm warning (5.0+ mb drop)
-        snprintf(s_temp_cond_buffer, sizeof(s_temp_cond_buffer), "🌩️ SEVERE STORM WARNING");
-        show_storm_warning = true;
-        
-        // Vibrate if this is a new or worsening severe warning
-        if (!s_storm_warning_active || trend_tenths < s_last_storm_trend) {
-          vibes_double_pulse();
-          s_storm_warning_active = true;
-          s_last_storm_trend = trend_tenths;
-        }
-      } else if (trend_tenths <= -30) {
-        // Storm warning (3.0+ mb drop)
-        snprintf(s_temp_cond_buffer, sizeof(s_temp_cond_buffer), "⚠️ STORM WARNING");
-        show_storm_warning = true;
-        
-        // Vibrate if this is a new warning (only on initial trigger)
-        if (!s_storm_warning_active) {
-          vibes_double_pulse();
-          s_storm_warning_active = true;
-          s_last_storm_trend = trend_tenths;
-        }
-      } else {
-        // Reset storm warning state when pressure stabilizes
-        s_storm_warning_active = false;
-        s_last_storm_trend = 0;
-      }
-    }
-  } else {
+static GRect get_row_frame(DataRow row) {
+  #if defined(SINGLE_DATA_LAYER)
+  return s_rows[row].frame;
+  #else
+  return layer_get_frame(text_layer_get_layer(s_row_layers[row]));
+  #endif
+}
+
+static void set_row_frame(DataRow row, GRect frame) {
+  #if defined(SINGLE_DATA_LAYER)
+  s_rows[row].frame = frame;
+  s_rows[row].changed = true;
+  layer_mark_dirty(s_data_layer);
+  #else
+  layer_set_frame(text_layer_get_layer(s_row_layers[row]), frame);
+  #endif
+}
+
+// Show new text from the row's display buffer
+static void set_row_text(DataRow row, const char *text) {
+  #if defined(SINGLE_DATA_LAYER)
+  s_rows[row].text = text;
+  s_rows[row].changed = true;
+  layer_mark_dirty(s_data_layer);
+  #else
+  text_layer_set_text(s_row_layers[row], text);
+  #endif
+}
+
+// Another layer moved or went away: nothing under it may be left on screen.
+// TextLayers are drawn in full every frame anyway.
+static void redraw_all_rows(void) {
+  #if defined(SINGLE_DATA_LAYER)
+  s_rows_redraw_all = true;
+  if (s_data_layer) {
+    layer_mark_dirty(s_data_layer);
+  }
+  #endif
+}
+
+// --- Weather Display --- //
+
+// Finish a line formatted straight into a row's display buffer, marking
+// the row dirty only if the text changed. Returns true if it did.
+static bool show_row_text(DataRow row, Fmt *fmt) {
+  if (!fmt_end(fmt)) {
+    return false;
+  }
+  set_row_text(row, fmt->buffer);
+  s_redraws_this_hour++;
+  return true;
+}
+
+// Show text on a row through its display buffer, as show_row_text()
+static bool set_row_text_copy(DataRow row, char *shown, size_t size, const char *text) {
+  Fmt fmt;
+  fmt_begin(&fmt, shown, size);
+  fmt_str(&fmt, text);
+  return show_row_text(row, &fmt);
+}
+
+// The weather to display: s_weather with any forecast step laid over it
+static const WeatherRecord *shown_weather(void) {
+  static WeatherRecord shown;
+  if (!s_forecast_shown) {
+    return &s_weather;
+  }
+  shown = s_weather;
+  shown.condition = s_forecast_overlay.condition;
+  shown.temperature_dc = s_forecast_overlay.temperature_dc;
+  shown.precip_dmm = s_forecast_overlay.precip_dmm;
+  shown.present |= WEATHER_FIELD_CONDITION | WEATHER_FIELD_TEMPERATURE | WEATHER_FIELD_PRECIP;
+  return &shown;
+}
+
+static void update_pressure_display(void) {
+  const WeatherRecord *weather = shown_weather();
+  if (!(weather->present & WEATHER_FIELD_PRESSURE)) {
+    return; // Keep "Loading..." until the first reading arrives
+  }
+  Fmt fmt;
+  fmt_begin(&fmt, s_pressure_buffer, sizeof(s_pressure_buffer));
+
+  // Temperature shares the pressure line, e.g. "18C • 1013 mb +0.8"
+  bool has_temperature = (weather->present & WEATHER_FIELD_TEMPERATURE) != 0;
+  if (has_temperature) {
+    bool fahrenheit = (weather->units & WEATHER_UNITS_FAHRENHEIT) != 0;
+    fmt_int(&fmt, fahrenheit ? fixed_dc_to_fahrenheit(weather->temperature_dc)
+                             : fixed_dc_to_celsius(weather->temperature_dc));
+    fmt_str(&fmt, fahrenheit ? "F • " : "C • ");
+  }
+  fmt_int(&fmt, fixed_dhpa_to_hpa(weather->pressure_dhpa));
+  fmt_str(&fmt, " mb");
+
+  // Append the 3-hour trend in tenths of hPa
+  if (weather->present & WEATHER_FIELD_TREND) {
+    fmt_char(&fmt, ' ');
+    fmt_fixed_signed(&fmt, weather->trend_dhpa, 1);
+  }
+
+  // Storm warning: see update_storm_warning (experimental feature)
+  if (has_temperature && s_storm_warning_enabled && s_storm_level != PRESSURE_STORM_NONE) {
+    fmt_str(&fmt, " ⚠️");
+  }
+
+  show_row_text(ROW_PRESSURE, &fmt);
+}
+
+// The steeper of the 3-hour trend and the last hour's change projected over
+// 3 hours, so a sharp fall warns before three hours of history build up
+static bool storm_trend(int *trend) {
+  bool has_trend = (s_weather.present & WEATHER_FIELD_TREND) != 0;
+  *trend = s_weather.trend_dhpa;
+  int16_t trend_1h;
+  if (pressure_history_trend(&s_pressure_history, 60 * 60, &trend_1h) && (!has_trend || trend_1h * 3 < *trend)) {
+    *trend = trend_1h * 3;
+    has_trend = true;
+  }
+  return has_trend;
+}
+
+// Returns true if a storm warning should replace the conditions text
+static bool update_storm_warning(void) {
+  if (!s_storm_warning_enabled) {
     // Reset storm warning state when feature is disabled
-    s_storm_warning_active = false;
+    s_storm_level = PRESSURE_STORM_NONE;
     s_last_storm_trend = 0;
+    return false;
   }
-  
-  if (!show_storm_warning) {
-    // Normal conditions display
-    if (cond_tuple && cond_tuple->type == TUPLE_CSTRING && cond_tuple->value->cstring) {
-      char *cond_str = cond_tuple->value->cstring;
-      snprintf(s_temp_cond_buffer, sizeof(s_temp_cond_buffer), "%s", cond_str);
-    } else {
-      snprintf(s_temp_cond_buffer, sizeof(s_temp_cond_buffer), "Loading...");
-    }
+  int trend_tenths;
+  if (!storm_trend(&trend_tenths)) {
+    return s_storm_level != PRESSURE_STORM_NONE;
   }
-  
-  text_layer_set_text(s_temp_cond_layer, s_temp_cond_buffer);
 
-  // Wind and Precip (combined display)
-  /* Handle wind and precip data - can be integers or strings, and display even if only one is available */
-  char wind_display[20] = "";
-  char precip_display[20] = "";
-  
-  // Handle wind data with explicit units
-  if (wind_tuple) {
-    if (wind_tuple->type == TUPLE_INT) {
-      int wind_val = (int)wind_tuple->value->int32;
-      
-      // Get wind unit from JS (default to mph)
-      char wind_unit[8] = "mph";
-      if (wind_unit_tuple && wind_unit_tuple->type == TUPLE_CSTRING && wind_unit_tuple->value->cstring) {
-        snprintf(wind_unit, sizeof(wind_unit), "%s", wind_unit_tuple->value->cstring);
-      }
-      
-      snprintf(wind_display, sizeof(wind_display), "%d %s", wind_val, wind_unit);
-    } else if (wind_tuple->type == TUPLE_CSTRING && wind_tuple->value->cstring) {
-      snprintf(wind_display, sizeof(wind_display), "%s", wind_tuple->value->cstring);
-    }
+  // Falling 3.0+ mb in 3 hours warns, 5.0+ is severe; see pressure_storm_level
+  PressureStormLevel level = pressure_storm_level(s_storm_level, trend_tenths);
+  if (level == PRESSURE_STORM_NONE) {
+    // Reset storm warning state when pressure stabilizes
+    s_storm_level = PRESSURE_STORM_NONE;
+    s_last_storm_trend = 0;
+    return false;
   }
-  
-  // Handle precip data with explicit units
-  if (precip_tuple) {
-    if (precip_tuple->type == TUPLE_INT) {
-      int precip_val = (int)precip_tuple->value->int32;
-      
-      // Get precip unit from JS (default to mm)
-      char precip_unit[8] = "mm";
-      if (precip_unit_tuple && precip_unit_tuple->type == TUPLE_CSTRING && precip_unit_tuple->value->cstring) {
-        snprintf(precip_unit, sizeof(precip_unit), "%s", precip_unit_tuple->value->cstring);
+
+  // Vibrate on a new or stronger warning, and when a severe one worsens
+  if (level > s_storm_level || (level == PRESSURE_STORM_SEVERE && trend_tenths < s_last_storm_trend)) {
+    vibes_double_pulse();
+    s_last_storm_trend = trend_tenths;
+  }
+  s_storm_level = level;
+  return true;
+}
+
+static void update_conditions_display(bool show_storm_warning) {
+  const WeatherRecord *weather = shown_weather();
+  Fmt fmt;
+  fmt_begin(&fmt, s_temp_cond_buffer, sizeof(s_temp_cond_buffer));
+  s_shown_stale_hours = stale_weather_hours();
+  if (show_storm_warning) {
+    fmt_str(&fmt, s_storm_level == PRESSURE_STORM_SEVERE ? "🌩️ SEVERE STORM WARNING" : "⚠️ STORM WARNING");
+  } else {
+    if ((weather->present & WEATHER_FIELD_STATUS) && weather->status != WEATHER_STATUS_OK) {
+      // The companion couldn't fetch fresh data - say why
+      switch (weather->status) {
+        case WEATHER_STATUS_PARSE_ERROR:
+          fmt_str(&fmt, "Parse Error");
+          break;
+        case WEATHER_STATUS_HTTP_FAIL:
+          fmt_str(&fmt, "HTTP Fail ");
+          fmt_int(&fmt, weather->status_detail);
+          break;
+        case WEATHER_STATUS_TIMEOUT:
+          fmt_str(&fmt, "Timeout");
+          break;
+        default:
+          fmt_str(&fmt, "Net Error");
+          break;
       }
-      
-      if (strcmp(precip_unit, "in") == 0) {
-        // Handle inches (sent as hundredths) - use integer arithmetic for Pebble
-        if (precip_val > 0) {
-          int whole = precip_val / 100;
-          int frac = precip_val % 100;
-          snprintf(precip_display, sizeof(precip_display), "%d.%02d %s", whole, frac, precip_unit);
-        } else {
-          snprintf(precip_display, sizeof(precip_display), "0 %s", precip_unit);
-        }
+    } else if (weather->present & WEATHER_FIELD_CONDITION) {
+      const char *cond_str = weather_condition_text(weather->condition);
+      if (cond_str) {
+        fmt_str(&fmt, cond_str);
       } else {
-        // Handle mm (sent as tenths) - use integer arithmetic for Pebble  
-        if (precip_val > 0) {
-          int whole = precip_val / 10;
-          int frac = precip_val % 10;
-          snprintf(precip_display, sizeof(precip_display), "%d.%d %s", whole, frac, precip_unit);
-        } else {
-          snprintf(precip_display, sizeof(precip_display), "0 %s", precip_unit);
-        }
+        fmt_str(&fmt, "Unknown (");
+        fmt_int(&fmt, weather->condition);
+        fmt_char(&fmt, ')');
       }
-    } else if (precip_tuple->type == TUPLE_CSTRING && precip_tuple->value->cstring) {
-      snprintf(precip_display, sizeof(precip_display), "%s", precip_tuple->value->cstring);
+    } else {
+      fmt_str(&fmt, "Loading...");
+    }
+
+    // Restored or not refreshed for a while - say how old it is, e.g. "Overcast (3h)"
+    if (s_shown_stale_hours > 0 && weather->present) {
+      fmt_str(&fmt, " (");
+      fmt_int(&fmt, s_shown_stale_hours);
+      fmt_str(&fmt, "h)");
     }
   }
-  
-  // Display wind and/or precip
-  if (strlen(wind_display) > 0 && strlen(precip_display) > 0) {
-    snprintf(s_wind_precip_buffer, sizeof(s_wind_precip_buffer), "%s • %s", wind_display, precip_display);
-    text_layer_set_text(s_wind_precip_layer, s_wind_precip_buffer);
-  } else if (strlen(wind_display) > 0) {
-    text_layer_set_text(s_wind_precip_layer, wind_display);
-  } else if (strlen(precip_display) > 0) {
-    text_layer_set_text(s_wind_precip_layer, precip_display);
+
+  show_row_text(ROW_CONDITIONS, &fmt);
+}
+
+static void update_wind_precip_display(void) {
+  const WeatherRecord *weather = shown_weather();
+  /* Display wind and precip even if only one is available */
+  bool has_wind = (weather->present & WEATHER_FIELD_WIND) != 0;
+  bool has_precip = (weather->present & WEATHER_FIELD_PRECIP) != 0;
+  if (!has_wind && !has_precip) {
+    return;
   }
-  
-  // Handle step tracking settings
-  Tuple *show_steps_tuple = dict_find(iterator, MESSAGE_KEY_SHOW_STEPS);
-  if (show_steps_tuple) {
-    if (show_steps_tuple->type == TUPLE_INT) {
-      s_show_steps_enabled = (show_steps_tuple->value->int32 != 0);
-      APP_LOG(APP_LOG_LEVEL_INFO, "Show steps setting: %s", 
-              s_show_steps_enabled ? "enabled" : "disabled");
-      
-      // When steps are enabled/disabled, update the display
-      update_step_display();
+  Fmt fmt;
+  fmt_begin(&fmt, s_wind_precip_buffer, sizeof(s_wind_precip_buffer));
+
+  if (has_wind) {
+    // Wind arrives in tenths of km/h
+    if (weather->units & WEATHER_UNITS_WIND_KPH) {
+      fmt_int(&fmt, fixed_dkmh_to_kph(weather->wind_dkmh));
+      fmt_str(&fmt, " kph");
+    } else {
+      fmt_int(&fmt, fixed_dkmh_to_mph(weather->wind_dkmh));
+      fmt_str(&fmt, " mph");
     }
   }
-  
-  Tuple *step_unit_tuple = dict_find(iterator, MESSAGE_KEY_STEP_UNIT);
-  if (step_unit_tuple) {
-    if (step_unit_tuple->type == TUPLE_INT) {
-      s_step_unit_miles = (step_unit_tuple->value->int32 != 0); // 1 = miles, 0 = kilometers
-      APP_LOG(APP_LOG_LEVEL_INFO, "Step unit setting: %s", 
-              s_step_unit_miles ? "miles" : "kilometers");
-      
-      // Update display if steps are enabled
-      if (s_show_steps_enabled) {
-        update_step_display();
+  if (has_wind && has_precip) {
+    fmt_str(&fmt, " • ");
+  }
+
+  if (has_precip) {
+    // Precip arrives in tenths of mm
+    if (weather->units & WEATHER_UNITS_PRECIP_INCHES) {
+      // Show hundredths of an inch
+      int precip_val = fixed_dmm_to_hundredths_inch(weather->precip_dmm);
+      if (precip_val > 0) {
+        fmt_fixed(&fmt, precip_val, 2);
+      } else {
+        fmt_char(&fmt, '0');
       }
+      fmt_str(&fmt, " in");
+    } else {
+      int precip_val = weather->precip_dmm;
+      if (precip_val > 0) {
+        fmt_fixed(&fmt, precip_val, 1);
+      } else {
+        fmt_char(&fmt, '0');
+      }
+      fmt_str(&fmt, " mm");
     }
   }
-  
-  // Handle hourly vibration setting
-  Tuple *vibration_tuple = dict_find(iterator, MESSAGE_KEY_HOURLY_VIBRATION);
-  if (vibration_tuple) {
-    if (vibration_tuple->type == TUPLE_INT) {
-      s_hourly_vibration_enabled = (vibration_tuple->value->int32 != 0);
-      APP_LOG(APP_LOG_LEVEL_INFO, "Hourly vibration setting: %s", 
-              s_hourly_vibration_enabled ? "enabled" : "disabled");
-    }
+
+  show_row_text(ROW_WIND_PRECIP, &fmt);
+}
+
+// Show or hide the progress line, shifting the rows below it to keep the spacing
+static void set_update_countdown_enabled(bool enabled) {
+  if (enabled == s_update_countdown_enabled) {
+    return;
   }
-  
-  // Handle update countdown setting
-  Tuple *countdown_tuple = dict_find(iterator, MESSAGE_KEY_UPDATE_COUNTDOWN);
-  if (countdown_tuple) {
-    if (countdown_tuple->type == TUPLE_INT) {
-      bool old_countdown_enabled = s_update_countdown_enabled;
-      s_update_countdown_enabled = (countdown_tuple->value->int32 != 0);
-      APP_LOG(APP_LOG_LEVEL_INFO, "Update countdown setting: %s", 
-              s_update_countdown_enabled ? "enabled" : "disabled");
-      
-      // If countdown setting changed, adjust the UI dynamically
-      if (old_countdown_enabled != s_update_countdown_enabled) {
-        APP_LOG(APP_LOG_LEVEL_INFO, "Countdown setting changed - adjusting UI dynamically");
-        if (s_update_countdown_enabled) {
-          // Add progress layer
-          if (!s_update_progress_layer) {
-            Layer *window_layer = window_get_root_layer(s_main_window);
-            GRect bounds = layer_get_bounds(window_layer);
-            // Calculate proper Y position to maintain spacing
-            int progress_y = calculate_progress_layer_y_position();
-            s_update_progress_layer = layer_create(GRect(0, progress_y, bounds.size.w, 6));
-            layer_set_update_proc(s_update_progress_layer, progress_layer_draw);
-            layer_add_child(window_layer, s_update_progress_layer);
-            
-            // Move temperature/conditions layer down to add spacing below progress line
-            GRect temp_frame = layer_get_frame(text_layer_get_layer(s_temp_cond_layer));
-            int progress_h = 6;
-            int gap = 0; // No gap below progress line to move it visually closer to conditions
-            temp_frame.origin.y = progress_y + progress_h + gap; // Minimal gap below progress line
-            layer_set_frame(text_layer_get_layer(s_temp_cond_layer), temp_frame);
-            
-            // Also move the remaining layers down by the same amount
-            int shift_down = progress_h + gap; // Total space used: progress height + gap below
-            GRect pressure_frame = layer_get_frame(text_layer_get_layer(s_pressure_layer));
-            pressure_frame.origin.y += shift_down;
-            layer_set_frame(text_layer_get_layer(s_pressure_layer), pressure_frame);
-            
-            GRect wind_frame = layer_get_frame(text_layer_get_layer(s_wind_precip_layer));
-            wind_frame.origin.y += shift_down;
-            layer_set_frame(text_layer_get_layer(s_wind_precip_layer), wind_frame);
-            
-            layer_mark_dirty(s_update_progress_layer);
-          }
-        } else {
-          // Remove progress layer and move temperature up to maintain equal spacing
-          if (s_update_progress_layer) {
-            // Move temperature/conditions to where progress line was (location + 2pt gap)
-            GRect location_frame = layer_get_frame(text_layer_get_layer(s_location_layer));
-            int gap = 2; // Standard gap used throughout layout
-            int new_temp_y = location_frame.origin.y + location_frame.size.h + gap;
-            
-            // Calculate how much we're moving up from current position
-            GRect temp_frame = layer_get_frame(text_layer_get_layer(s_temp_cond_layer));
-            int shift_up = temp_frame.origin.y - new_temp_y;
-            
-            // Move temperature layer to maintain equal spacing
-            temp_frame.origin.y = new_temp_y;
-            layer_set_frame(text_layer_get_layer(s_temp_cond_layer), temp_frame);
-            
-            // Move other layers up by the same amount to maintain their relative spacing
-            GRect pressure_frame = layer_get_frame(text_layer_get_layer(s_pressure_layer));
-            pressure_frame.origin.y -= shift_up;
-            layer_set_frame(text_layer_get_layer(s_pressure_layer), pressure_frame);
-            
-            GRect wind_frame = layer_get_frame(text_layer_get_layer(s_wind_precip_layer));
-            wind_frame.origin.y -= shift_up;
-            layer_set_frame(text_layer_get_layer(s_wind_precip_layer), wind_frame);
-            
-            layer_destroy(s_update_progress_layer);
-            s_update_progress_layer = NULL;
-          }
-        }
-      }
+  s_update_countdown_enabled = enabled;
+  APP_LOG(APP_LOG_LEVEL_INFO, "Countdown setting changed - adjusting UI dynamically");
+
+  if (s_update_countdown_enabled) {
+    // Add progress layer
+    if (!s_update_progress_layer) {
+      Layer *window_layer = window_get_root_layer(s_main_window);
+      GRect bounds = layer_get_bounds(window_layer);
+      // Calculate proper Y position to maintain spacing
+      int progress_y = calculate_progress_layer_y_position();
+      s_update_progress_layer = layer_create(GRect(0, progress_y, bounds.size.w, 6));
+      layer_set_update_proc(s_update_progress_layer, progress_layer_draw);
+      layer_add_child(window_layer, s_update_progress_layer);
+
+      // Move temperature/conditions row down to add spacing below progress line
+      GRect temp_frame = get_row_frame(ROW_CONDITIONS);
+      int progress_h = 6;
+      int gap = 0; // No gap below progress line to move it visually closer to conditions
+      int new_temp_y = progress_y + progress_h + gap; // Minimal gap below progress line
+      int shift_down = new_temp_y - temp_frame.origin.y;
+      temp_frame.origin.y = new_temp_y;
+      set_row_frame(ROW_CONDITIONS, temp_frame);
+
+      // Also move the remaining rows down by the same amount, including the
+      // extra 1pt above the line, so they land where main_window_load puts them
+      GRect pressure_frame = get_row_frame(ROW_PRESSURE);
+      pressure_frame.origin.y += shift_down;
+      set_row_frame(ROW_PRESSURE, pressure_frame);
+
+      GRect wind_frame = get_row_frame(ROW_WIND_PRECIP);
+      wind_frame.origin.y += shift_down;
+      set_row_frame(ROW_WIND_PRECIP, wind_frame);
+
+      layer_mark_dirty(s_update_progress_layer);
     }
-  }
-  
-  // Handle storm warning setting (experimental)
-  Tuple *storm_warning_tuple = dict_find(iterator, MESSAGE_KEY_STORM_WARNING);
-  if (storm_warning_tuple) {
-    if (storm_warning_tuple->type == TUPLE_INT) {
-      s_storm_warning_enabled = (storm_warning_tuple->value->int32 != 0);
-      APP_LOG(APP_LOG_LEVEL_INFO, "Storm warning %s", 
-              s_storm_warning_enabled ? "ENABLED" : "disabled");
+  } else {
+    // Remove progress layer and move temperature up to maintain equal spacing
+    if (s_update_progress_layer) {
+      // Move temperature/conditions to where progress line was (location + 2pt gap)
+      GRect location_frame = get_row_frame(ROW_LOCATION);
+      int gap = 2; // Standard gap used throughout layout
+      int new_temp_y = location_frame.origin.y + location_frame.size.h + gap;
+
+      // Calculate how much we're moving up from current position
+      GRect temp_frame = get_row_frame(ROW_CONDITIONS);
+      int shift_up = temp_frame.origin.y - new_temp_y;
+
+      // Move temperature row to maintain equal spacing
+      temp_frame.origin.y = new_temp_y;
+      set_row_frame(ROW_CONDITIONS, temp_frame);
+
+      // Move other rows up by the same amount to maintain their relative spacing
+      GRect pressure_frame = get_row_frame(ROW_PRESSURE);
+      pressure_frame.origin.y -= shift_up;
+      set_row_frame(ROW_PRESSURE, pressure_frame);
+
+      GRect wind_frame = get_row_frame(ROW_WIND_PRECIP);
+      wind_frame.origin.y -= shift_up;
+      set_row_frame(ROW_WIND_PRECIP, wind_frame);
+
+      layer_destroy(s_update_progress_layer);
+      s_update_progress_layer = NULL;
     }
   }
+  redraw_all_rows();
+  memory_telemetry_sample("relayout");
+}
+
+static void apply_settings(uint8_t settings) {
+  s_hourly_vibration_enabled = (settings & WEATHER_SETTING_HOURLY_VIBRATION) != 0;
+  s_show_steps_enabled = (settings & WEATHER_SETTING_SHOW_STEPS) != 0;
+  s_step_unit_miles = (settings & WEATHER_SETTING_STEP_UNIT_MILES) != 0;
+  s_storm_warning_enabled = (settings & WEATHER_SETTING_STORM_WARNING) != 0;
+  s_power_save_enabled = (settings & WEATHER_SETTING_POWER_SAVE) != 0;
+  APP_LOG(APP_LOG_LEVEL_INFO, "Settings: vibration=%d steps=%d miles=%d storm=%d countdown=%d power_save=%d",
+          s_hourly_vibration_enabled, s_show_steps_enabled, s_step_unit_miles, s_storm_warning_enabled,
+          (settings & WEATHER_SETTING_UPDATE_COUNTDOWN) != 0, s_power_save_enabled);
+
+  set_update_countdown_enabled((settings & WEATHER_SETTING_UPDATE_COUNTDOWN) != 0);
+  update_power_mode(battery_state_service_peek());
+  set_step_events_enabled(s_show_steps_enabled && !s_low_power);
+}
+
+// --- Forecast --- //
+
+// Show the forecast entry for now, if it is newer than both the last fetch
+// and the entry already on screen. Called every minute and when a timeline
+// arrives, so a late or failed fetch still moves the display on.
+static void step_forecast(void) {
+  const ForecastEntry *entry = forecast_timeline_advance(&s_forecast, time(NULL));
+  if (!entry || entry->time <= s_forecast_shown || entry->time <= s_last_weather_update) {
+    return;
+  }
+  s_forecast_shown = entry->time;
+  s_forecast_overlay = *entry;
+
+  update_pressure_display();
+  update_conditions_display(s_storm_level != PRESSURE_STORM_NONE);
+  if (!s_show_steps_enabled) {
+    update_wind_precip_display();
+  }
+}
+
+static void receive_forecast(const uint8_t *data, uint16_t length) {
+  if (!forecast_timeline_decode(data, length, &s_forecast)) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "receive_forecast: bad timeline (%d bytes)", length);
+    return;
+  }
+  APP_LOG(APP_LOG_LEVEL_INFO, "receive_forecast: %d entries", s_forecast.count);
+
+  // Kept as received so a restart can step on without the phone
+  status_t result = persist_write_data(PERSIST_KEY_FORECAST, data, length);
+  if (result < 0) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "receive_forecast: persist_write_data failed (%d)", (int)result);
+  }
+  step_forecast();
+}
+
+// --- AppMessage Handlers --- //
+
+// This function runs every time the watch receives a message from the phone
+static void inbox_received_callback(DictionaryIterator *iterator, void *context) {
+  // The phone is listening again: retry a power mode it never acknowledged
+  if (!s_power_mode_acked) {
+    send_power_mode();
+  }
+
+  Tuple *forecast_tuple = dict_find(iterator, MESSAGE_KEY_FORECAST_TIMELINE);
+  if (forecast_tuple && forecast_tuple->type == TUPLE_BYTE_ARRAY) {
+    receive_forecast(forecast_tuple->value->data, forecast_tuple->length);
+    memory_telemetry_inbox(dict_size(iterator));
+    return;
+  }
+
+  Tuple *record_tuple = dict_find(iterator, MESSAGE_KEY_WEATHER_RECORD);
+  if (!record_tuple || record_tuple->type != TUPLE_BYTE_ARRAY) {
+    APP_LOG(APP_LOG_LEVEL_INFO, "inbox_received_callback: no weather record in incoming message");
+    return;
+  }
+
+  WeatherRecord update;
+  if (!weather_record_decode(record_tuple->value->data, record_tuple->length, &update)) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "inbox_received_callback: bad weather record (%d bytes)", record_tuple->length);
+    return;
+  }
+  // A full resync, or a resend after a lost ACK, repeats settings the
+  // watch already applied; only a new version is applied again
+  bool new_settings = (update.present & WEATHER_FIELD_SETTINGS) &&
+                      !(update.present & s_weather.present & WEATHER_FIELD_SETTINGS_VERSION &&
+                        update.settings_version == s_weather.settings_version);
+  weather_record_merge(&s_weather, &update);
+  APP_LOG(APP_LOG_LEVEL_INFO, "inbox_received_callback: record fields=0x%x (%d bytes)",
+          update.present, record_tuple->length);
+
+  if (new_settings) {
+    apply_settings(update.settings);
+  }
+
+  if (update.flags & WEATHER_RECORD_FLAG_FETCHED) {
+    // Fresh data from the phone, even if none of it changed - restart the countdown
+    s_last_weather_update = time(NULL);
+    s_next_fetch_time = 0;
+    s_forecast_shown = 0; // The fetch supersedes the forecast step
+    record_pressure();
+  } else if (update.flags & WEATHER_RECORD_FLAG_FULL || update.present & WEATHER_FIELD_TREND) {
+    // A resync replaces or leaves out the trend; keep the watch's own
+    apply_pressure_trend();
+  }
+  if (update.present & WEATHER_FIELD_NEXT_FETCH) {
+    s_next_fetch_time = time(NULL) + update.next_fetch_s;
+  }
+  if (update.flags & WEATHER_RECORD_FLAG_FETCHED || update.present & WEATHER_FIELD_NEXT_FETCH) {
+    update_progress_bar();
+  }
+
+  // Location - the inbox buffer is reused, so keep our own copy
+  if (update.present & WEATHER_FIELD_LOCATION) {
+    char location[sizeof(s_location_buffer)];
+    size_t location_length = MIN(update.location_length, sizeof(location) - 1);
+    memcpy(location, update.location, location_length);
+    location[location_length] = '\0';
+    set_row_text_copy(ROW_LOCATION, s_location_buffer, sizeof(s_location_buffer), location);
+  }
+
+  bool storm_warning = update_storm_warning();
+  update_pressure_display();
+  update_conditions_display(storm_warning);
+
+  // Steps replace the wind/precip line when enabled
+  if (!s_show_steps_enabled) {
+    update_wind_precip_display();
+  }
+  if (s_show_steps_enabled || new_settings) {
+    update_step_display();
+  }
+
+  save_weather_snapshot();
+  memory_telemetry_inbox(dict_size(iterator));
 }
 
 static void inbox_dropped_callback(AppMessageResult reason, void *context) {
   APP_LOG(APP_LOG_LEVEL_ERROR, "Message dropped!");
 }
 
+static void outbox_sent_callback(DictionaryIterator *iterator, void *context) {
+  s_power_mode_in_flight = false;
+  // The mode may have changed again while this one was on its way
+  Tuple *mode_tuple = dict_find(iterator, MESSAGE_KEY_POWER_MODE);
+  s_power_mode_acked = mode_tuple && mode_tuple->value->uint8 == (s_low_power ? 1 : 0);
+  if (mode_tuple && !s_power_mode_acked) {
+    send_power_mode();
+  }
+}
+
 static void outbox_failed_callback(DictionaryIterator *iterator, AppMessageResult reason, void *context) {
+  s_power_mode_in_flight = false;
   APP_LOG(APP_LOG_LEVEL_ERROR, "Outbox send failed!");
 }
 
 // --- Update Progress Handler --- //
 
-static void progress_layer_draw(Layer *layer, GContext *ctx) {
-  GRect bounds = layer_get_bounds(layer);
-  
+// Dot layout along the line - 15 dots, 8px apart, centered between the margins
+#define PROGRESS_DOTS 15
+#define PROGRESS_DOT_SPACING 8
+#define PROGRESS_MARGIN 20
+
+// Dots fill from the last fetch to the companion's next one, 0-14. The last
+// dot stays empty until new data arrives, however late that is.
+static int progress_filled_dots(void) {
+  if (s_last_weather_update == 0) {
+    return 0;
+  }
+  time_t next_fetch = s_next_fetch_time > s_last_weather_update
+                          ? s_next_fetch_time
+                          : s_last_weather_update + DEFAULT_FETCH_INTERVAL_SECONDS;
+  int elapsed = (int)(time(NULL) - s_last_weather_update);
+  int interval = (int)(next_fetch - s_last_weather_update);
+  if (elapsed >= interval) {
+    return PROGRESS_DOTS - 1;
+  }
+  return elapsed > 0 ? elapsed * PROGRESS_DOTS / interval : 0;
+}
+
+static int progress_dots_start_x(GRect bounds) {
+  int line_width = bounds.size.w - (2 * PROGRESS_MARGIN);
+  int dots_total_width = (PROGRESS_DOTS - 1) * PROGRESS_DOT_SPACING;
+  return PROGRESS_MARGIN + (line_width - dots_total_width) / 2;
+}
+
+// Draw the line and dots with the drawing primitives
+static void draw_progress_dots(GContext *ctx, GRect bounds, int filled_dots) {
   // Draw a thin horizontal line across the width with centered progress dots
   int line_y = bounds.size.h / 2; // Center vertically in the layer
-  int margin = 20; // Margins from left and right edges
-  int line_width = bounds.size.w - (2 * margin);
+  int line_width = bounds.size.w - (2 * PROGRESS_MARGIN);
   
   // Set drawing color to black
   graphics_context_set_stroke_color(ctx, GColorBlack);
   graphics_context_set_fill_color(ctx, GColorBlack);
   
   // Draw the full base line from margin to margin
-  graphics_draw_line(ctx, GPoint(margin, line_y), GPoint(margin + line_width, line_y));
-  
-  // Calculate dot positioning - center 15 dots within the line
-  int dots_total_width = 14 * 8; // 14 spaces between 15 dots, 8px apart
-  int dots_start_x = margin + (line_width - dots_total_width) / 2; // Center the dots
-  
-  // Calculate how many dots to fill based on elapsed time
-  int filled_dots = 0;
-  if (s_last_weather_update != 0) {
-    time_t now = time(NULL);
-    int elapsed_minutes = (int)((now - s_last_weather_update) / 60);
-    filled_dots = elapsed_minutes % 15; // 0-14 filled dots
-  }
+  graphics_draw_line(ctx, GPoint(PROGRESS_MARGIN, line_y), GPoint(PROGRESS_MARGIN + line_width, line_y));
   
   // Draw progress dots centered on the line
-  for (int i = 0; i < 15; i++) {
-    int dot_x = dots_start_x + (i * 8); // 8px spacing between dots
+  int dots_start_x = progress_dots_start_x(bounds);
+  for (int i = 0; i < PROGRESS_DOTS; i++) {
+    int dot_x = dots_start_x + (i * PROGRESS_DOT_SPACING);
     if (i < filled_dots) {
       // Filled dot - small filled circle
       graphics_fill_circle(ctx, GPoint(dot_x, line_y), 2);
@@ -478,9 +922,96 @@ static void progress_layer_draw(Layer *layer, GContext *ctx) {
   }
 }
 
+// Copy the screen rows under the layer into a new bitmap. The layer spans the
+// full width, so whole rows can be copied whatever the pixel format.
+static GBitmap *capture_progress_strip(Layer *layer, GContext *ctx) {
+  GRect bounds = layer_get_bounds(layer);
+  GPoint origin = layer_convert_point_to_screen(layer, GPoint(0, 0));
+  GBitmap *frame_buffer = graphics_capture_frame_buffer(ctx);
+  if (!frame_buffer) {
+    return NULL;
+  }
+
+  GBitmap *strip = NULL;
+  GRect screen = gbitmap_get_bounds(frame_buffer);
+  if (origin.x == 0 && bounds.size.w == screen.size.w && origin.y >= 0 &&
+      origin.y + bounds.size.h <= screen.size.h) {
+    strip = gbitmap_create_blank(bounds.size, gbitmap_get_format(frame_buffer));
+  }
+  if (strip) {
+    uint16_t src_stride = gbitmap_get_bytes_per_row(frame_buffer);
+    uint16_t dst_stride = gbitmap_get_bytes_per_row(strip);
+    const uint8_t *src = gbitmap_get_data(frame_buffer) + origin.y * src_stride;
+    uint8_t *dst = gbitmap_get_data(strip);
+    for (int y = 0; y < bounds.size.h; y++) {
+      memcpy(dst + y * dst_stride, src + y * src_stride, dst_stride);
+    }
+  }
+  graphics_release_frame_buffer(ctx, frame_buffer);
+  return strip;
+}
+
+// The first draw renders the line with every dot filled and with every dot
+// empty, keeping a copy of each. Later draws blit the filled copy up to the
+// boundary and the empty copy after it - two blits instead of 16 shapes.
+static void progress_layer_draw(Layer *layer, GContext *ctx) {
+  GRect bounds = layer_get_bounds(layer);
+
+  // Calculate how many dots to fill based on elapsed time
+  int filled_dots = progress_filled_dots();
+  s_shown_filled_dots = filled_dots;
+
+  if (!s_progress_strip_filled && !s_progress_strip_failed) {
+    draw_progress_dots(ctx, bounds, PROGRESS_DOTS);
+    s_progress_strip_filled = capture_progress_strip(layer, ctx);
+    // Clear the filled dots, or the outlines would be drawn over them
+    graphics_context_set_fill_color(ctx, GColorWhite);
+    graphics_fill_rect(ctx, bounds, 0, GCornerNone);
+    draw_progress_dots(ctx, bounds, 0);
+    s_progress_strip_empty = capture_progress_strip(layer, ctx);
+    if (!s_progress_strip_filled || !s_progress_strip_empty) {
+      // No frame buffer access or no memory - keep drawing shapes
+      APP_LOG(APP_LOG_LEVEL_WARNING, "Progress strip cache unavailable");
+      gbitmap_destroy(s_progress_strip_filled);
+      gbitmap_destroy(s_progress_strip_empty);
+      s_progress_strip_filled = s_progress_strip_empty = NULL;
+      s_progress_strip_failed = true;
+    }
+  }
+  if (!s_progress_strip_filled) {
+    graphics_context_set_fill_color(ctx, GColorWhite);
+    graphics_fill_rect(ctx, bounds, 0, GCornerNone);
+    draw_progress_dots(ctx, bounds, filled_dots);
+    return;
+  }
+
+  // Split halfway between the last filled dot and the next one
+  int split_x = 0;
+  if (filled_dots > 0) {
+    split_x = progress_dots_start_x(bounds) + filled_dots * PROGRESS_DOT_SPACING - PROGRESS_DOT_SPACING / 2;
+    gbitmap_set_bounds(s_progress_strip_filled, GRect(0, 0, split_x, bounds.size.h));
+    graphics_draw_bitmap_in_rect(ctx, s_progress_strip_filled, GRect(0, 0, split_x, bounds.size.h));
+  }
+  GRect empty = GRect(split_x, 0, bounds.size.w - split_x, bounds.size.h);
+  gbitmap_set_bounds(s_progress_strip_empty, empty);
+  graphics_draw_bitmap_in_rect(ctx, s_progress_strip_empty, empty);
+}
+
+static void destroy_progress_strips(void) {
+  if (s_progress_strip_filled) {
+    gbitmap_destroy(s_progress_strip_filled);
+    s_progress_strip_filled = NULL;
+  }
+  if (s_progress_strip_empty) {
+    gbitmap_destroy(s_progress_strip_empty);
+    s_progress_strip_empty = NULL;
+  }
+  s_progress_strip_failed = false;
+}
+
 static int calculate_progress_layer_y_position(void) {
   // Position progress line for visual centering - match window_load positioning
-  GRect location_frame = layer_get_frame(text_layer_get_layer(s_location_layer));
+  GRect location_frame = get_row_frame(ROW_LOCATION);
   int gap = 3; // 2pt standard gap + 1pt extra for visual centering
   
   int progress_y = location_frame.origin.y + location_frame.size.h + gap;
@@ -488,10 +1019,13 @@ static int calculate_progress_layer_y_position(void) {
   return progress_y;
 }
 
-static void update_progress_bar() {
-  // Just trigger a redraw of the progress layer
-  if (s_update_progress_layer) {
+static void update_progress_bar(void) {
+  // Redraw the progress layer only when another dot fills
+  int filled_dots = progress_filled_dots();
+  if (s_update_progress_layer && filled_dots != s_shown_filled_dots) {
+    s_shown_filled_dots = filled_dots;
     layer_mark_dirty(s_update_progress_layer);
+    s_redraws_this_hour++;
   }
 }
 
@@ -505,35 +1039,13 @@ static void update_step_data(void) {
   
   if (step_count >= 0) {
     s_current_step_count = (int)step_count;
-    
-    // Calculate distance based on step count
-    // Average step length assumptions: ~2.5 feet per step = ~0.76 meters
-    // So: steps * 0.76 meters = total meters
-    // Convert to miles: meters * 0.000621371 = miles
-    // Convert to kilometers: meters / 1000 = km
-    
-    int distance_meters = (int)(s_current_step_count * 0.76f);
-    
-    if (s_step_unit_miles) {
-      // Convert to miles and store as tenths (for 1 decimal place display)
-      s_current_step_distance = (int)(distance_meters * 0.000621371f * 10);
-    } else {
-      // Convert to kilometers and store as tenths
-      s_current_step_distance = (int)(distance_meters / 100.0f); // Convert to km then multiply by 10 for tenths
-    }
-    
-    APP_LOG(APP_LOG_LEVEL_INFO, "Steps: %d, Distance: %d (%s)", 
-            s_current_step_count, s_current_step_distance, 
-            s_step_unit_miles ? "miles*100" : "km*10");
   } else {
     s_current_step_count = 0;
-    s_current_step_distance = 0;
     APP_LOG(APP_LOG_LEVEL_WARNING, "Health data unavailable");
   }
   #else
   // Health API not available on this platform
   s_current_step_count = 0;
-  s_current_step_distance = 0;
   APP_LOG(APP_LOG_LEVEL_WARNING, "Health API not available on this platform");
   #endif
 }
@@ -545,48 +1057,109 @@ static void update_step_display(void) {
       layer_set_hidden(bitmap_layer_get_layer(s_shoe_icon_layer), false);
     }
     
-    // Update step data from Health API
-    update_step_data();
+    // Calculate distance from the last queried count (Health events keep it current)
+    // Average step length assumption: ~2.5 feet per step = 76 cm (FIXED_STEP_LENGTH_CM)
+    int32_t distance_cm = fixed_steps_to_cm(s_current_step_count);
     
-    // Format step display - icon positioned between count and distance
-    if (s_step_unit_miles) {
-      // Display miles with 1 decimal place - extra spacing to prevent overlap
-      int whole_miles = s_current_step_distance / 10;
-      int frac_miles = s_current_step_distance % 10;
-      snprintf(s_step_display_buffer, sizeof(s_step_display_buffer), 
-               " %d        %d.%d mi", s_current_step_count, whole_miles, frac_miles);
-    } else {
-      // Display kilometers with 1 decimal place - extra spacing to prevent overlap
-      int whole_km = s_current_step_distance / 10;
-      int frac_km = s_current_step_distance % 10;
-      snprintf(s_step_display_buffer, sizeof(s_step_display_buffer), 
-               " %d        %d.%d km", s_current_step_count, whole_km, frac_km);
-    }
+    // Store as tenths of a mile or km (for 1 decimal place display)
+    s_current_step_distance = s_step_unit_miles ? fixed_cm_to_tenths_mile(distance_cm)
+                                                : fixed_cm_to_tenths_km(distance_cm);
+    s_shown_step_count = s_current_step_count;
     
     // Update icon position to center it properly in the gap
     if (s_shoe_icon_layer) {
-      // Get the wind/precip layer position for vertical alignment
-      GRect text_frame = layer_get_frame(text_layer_get_layer(s_wind_precip_layer));
+      // Get the wind/precip row position for vertical alignment
+      GRect text_frame = get_row_frame(ROW_WIND_PRECIP);
       
       // Position icon in the center of the screen horizontally
       int icon_x = (144 - 16) / 2; // Center the 16px icon horizontally
       
       GRect icon_frame = GRect(icon_x, text_frame.origin.y + 9, 16, 16); // Align with text baseline
-      layer_set_frame(bitmap_layer_get_layer(s_shoe_icon_layer), icon_frame);
+      Layer *icon_layer = bitmap_layer_get_layer(s_shoe_icon_layer);
+      GRect current_frame = layer_get_frame(icon_layer);
+      if (!grect_equal(&current_frame, &icon_frame)) {
+        layer_set_frame(icon_layer, icon_frame);
+        redraw_all_rows();
+      }
     }
     
-    // Replace the wind/precip layer with step data
-    text_layer_set_text(s_wind_precip_layer, s_step_display_buffer);
-    APP_LOG(APP_LOG_LEVEL_INFO, "Step display updated: %s", s_step_display_buffer);
+    // Format step display - icon positioned between count and distance
+    Fmt fmt;
+    fmt_begin(&fmt, s_wind_precip_buffer, sizeof(s_wind_precip_buffer));
+    fmt_char(&fmt, ' ');
+    fmt_int(&fmt, s_current_step_count);
+    // Display miles or kilometers with 1 decimal place - extra spacing to prevent overlap
+    fmt_str(&fmt, "        ");
+    fmt_fixed(&fmt, s_current_step_distance, 1);
+    fmt_str(&fmt, s_step_unit_miles ? " mi" : " km");
+
+    // Replace the wind/precip row with step data
+    if (show_row_text(ROW_WIND_PRECIP, &fmt)) {
+      APP_LOG(APP_LOG_LEVEL_INFO, "Step display updated: %s", s_wind_precip_buffer);
+    }
   } else {
     // Steps disabled - hide icon and show weather data
-    if (s_shoe_icon_layer) {
+    if (s_shoe_icon_layer && !layer_get_hidden(bitmap_layer_get_layer(s_shoe_icon_layer))) {
       layer_set_hidden(bitmap_layer_get_layer(s_shoe_icon_layer), true);
+      redraw_all_rows();
+      APP_LOG(APP_LOG_LEVEL_INFO, "Step display disabled - showing weather data");
     }
-    APP_LOG(APP_LOG_LEVEL_INFO, "Step display disabled - showing weather data");
   }
 }
 
+// Query Health and redraw if the count moved enough to be worth a redraw
+static void refresh_steps(bool force) {
+  update_step_data();
+  int delta = s_current_step_count - s_shown_step_count;
+  if (force || s_shown_step_count < 0 || delta >= STEP_REDRAW_MIN_DELTA || delta <= -STEP_REDRAW_MIN_DELTA) {
+    update_step_display();
+  }
+}
+
+static void step_refresh_timer_callback(void *data) {
+  s_step_refresh_timer = NULL;
+  refresh_steps(false);
+}
+
+#if defined(PBL_HEALTH)
+static void health_event_handler(HealthEventType event, void *context) {
+  if (event == HealthEventSignificantUpdate) {
+    // New day, or history changed - redraw now whatever the delta
+    if (s_step_refresh_timer) {
+      app_timer_cancel(s_step_refresh_timer);
+      s_step_refresh_timer = NULL;
+    }
+    refresh_steps(true);
+  } else if (event == HealthEventMovementUpdate && !s_step_refresh_timer) {
+    // Coalesce a burst of movement updates into one query
+    s_step_refresh_timer = app_timer_register(STEP_COALESCE_MS, step_refresh_timer_callback, NULL);
+  }
+}
+#endif
+
+// Step counts come from Health events only while the step line is shown, so
+// the minute tick never touches Health
+static void set_step_events_enabled(bool enabled) {
+  #if defined(PBL_HEALTH)
+  if (enabled == s_step_events_subscribed) {
+    return;
+  }
+  if (enabled) {
+    s_step_events_subscribed = health_service_events_subscribe(health_event_handler, NULL);
+    // Read the count now rather than waiting for the first event
+    update_step_data();
+  } else {
+    health_service_events_unsubscribe();
+    s_step_events_subscribed = false;
+    if (s_step_refresh_timer) {
+      app_timer_cancel(s_step_refresh_timer);
+      s_step_refresh_timer = NULL;
+    }
+    s_shown_step_count = -1;
+  }
+  #endif
+}
+
 // --- Step Icon Functions --- //
 
 static void load_step_icon(void) {
@@ -611,28 +1184,91 @@ static void destroy_step_icon_layer(void) {
   }
 }
 
+// --- Power Saving --- //
+
+// Tell the companion the current mode so it can stretch its fetch interval.
+// A mode that does not get through is sent again when the phone next talks.
+static void send_power_mode(void) {
+  if (s_power_mode_in_flight) {
+    return; // outbox_sent_callback follows up if the mode changed meanwhile
+  }
+  DictionaryIterator *iter;
+  AppMessageResult result = app_message_outbox_begin(&iter);
+  if (result != APP_MSG_OK) {
+    APP_LOG(APP_LOG_LEVEL_WARNING, "send_power_mode: outbox unavailable (%d)", (int)result);
+    return;
+  }
+  dict_write_uint8(iter, MESSAGE_KEY_POWER_MODE, s_low_power ? 1 : 0);
+  s_power_mode_in_flight = app_message_outbox_send() == APP_MSG_OK;
+}
+
+static void set_low_power(bool low_power) {
+  if (low_power == s_low_power) {
+    return;
+  }
+  s_low_power = low_power;
+  s_power_mode_acked = false;
+  APP_LOG(APP_LOG_LEVEL_INFO, "Low power mode %s", s_low_power ? "on" : "off");
+
+  // Health stays quiet in low power; the step line keeps the last count
+  if (s_show_steps_enabled) {
+    set_step_events_enabled(!s_low_power);
+    if (!s_low_power) {
+      update_step_display();
+    }
+  }
+  // Catch up on the dots the minute tick left alone
+  if (!s_low_power) {
+    update_progress_bar();
+  }
+  send_power_mode();
+}
+
+// Battery state handler, also run when the setting changes
+static void update_power_mode(BatteryChargeState charge) {
+  if (charge.is_charging || charge.is_plugged) {
+    set_low_power(false);
+    return;
+  }
+  bool low_battery = s_low_power ? charge.charge_percent < LOW_POWER_LEAVE_PERCENT
+                                 : charge.charge_percent <= LOW_POWER_ENTER_PERCENT;
+  set_low_power(s_power_save_enabled || low_battery);
+}
+
 // --- Clock Update Handler --- //
 
 static void tick_handler(struct tm *tick_time, TimeUnits units_changed) {
-  // Use a static buffer so we don't keep it on the stack
-  static char s_time_buffer[8]; // "00:00"
+  if (units_changed & HOUR_UNIT) {
+    APP_LOG(APP_LOG_LEVEL_INFO, "Redraws in the last hour: %d", s_redraws_this_hour);
+    s_redraws_last_hour = s_redraws_this_hour;
+    s_redraws_this_hour = 0;
+  }
 
-  // Format the time into the buffer
-  if(clock_is_24h_style()) {
-    strftime(s_time_buffer, sizeof(s_time_buffer), "%H:%M", tick_time);
-  } else {
-    strftime(s_time_buffer, sizeof(s_time_buffer), "%I:%M", tick_time);
+  // Format the time, as strftime's "%H:%M" or "%I:%M"
+  int hour = tick_time->tm_hour;
+  if (!clock_is_24h_style()) {
+    hour = hour % 12 ? hour % 12 : 12;
   }
+  Fmt fmt;
+  fmt_begin(&fmt, s_time_buffer, sizeof(s_time_buffer));
+  fmt_int_width(&fmt, hour, 2);
+  fmt_char(&fmt, ':');
+  fmt_int_width(&fmt, tick_time->tm_min, 2);
 
-  // Set the text on our Time TextLayer
-  text_layer_set_text(s_time_layer, s_time_buffer);
-  
-  // Update the progress bar
-  update_progress_bar();
+  // Set the text on the time row
+  show_row_text(ROW_TIME, &fmt);
   
-  // Update step display every minute if enabled (minimal battery impact)
-  if (s_show_steps_enabled) {
-    update_step_display();
+  // Update the progress bar; in low power the dots wait for the next fetch
+  if (!s_low_power) {
+    update_progress_bar();
+  }
+
+  // Move on to the next forecast step once its time comes
+  step_forecast();
+
+  // Keep the age shown on stale weather current
+  if (stale_weather_hours() != s_shown_stale_hours) {
+    update_conditions_display(s_storm_level != PRESSURE_STORM_NONE);
   }
   
   // Check for hourly vibration
@@ -662,7 +1298,12 @@ static void main_window_load(Window *window) {
   // Reduce padding to move text up and prevent clipping
   const int vertical_padding = -12;
 
-  // Define heights for each text layer - increased to prevent font clipping
+  #if defined(SINGLE_DATA_LAYER)
+  // The data layer redraws only what changed, over what the last frame left
+  window_set_background_color(window, GColorClear);
+  #endif
+
+  // Define heights for each text row - increased to prevent font clipping
   int time_h = 52; // Height for the time font
   int location_h = 28;  // Increased from 24 to prevent clipping
   int temp_cond_h = 28; // Increased from 24 to prevent clipping  
@@ -670,35 +1311,23 @@ static void main_window_load(Window *window) {
   int wind_precip_h = 28; // Increased from 24 to prevent clipping
   int gap = 2; // Gap between data fields
 
-  // --- Time Layer ---
+  // --- Time Row ---
   // Y position starts with padding, but move time down by 5 pixels
   int current_y = vertical_padding + 5;
-  s_time_layer = text_layer_create(GRect(0, current_y, bounds.size.w, time_h));
-  text_layer_set_background_color(s_time_layer, GColorClear);
-  text_layer_set_text_color(s_time_layer, GColorBlack);
-  text_layer_set_font(s_time_layer, fonts_get_system_font(
-    PBL_IF_COLOR_ELSE(
-      FONT_KEY_BITHAM_42_BOLD,
-      FONT_KEY_LECO_42_NUMBERS
-    )
-  ));
-  text_layer_set_text_alignment(s_time_layer, GTextAlignmentCenter);
-  layer_add_child(window_layer, text_layer_get_layer(s_time_layer));
-
-  // --- Data Layers ---
-  // Reset current_y to original position for data layers (ignore time offset)
+  s_time_buffer[0] = '\0';
+  create_data_row(window_layer, ROW_TIME, GRect(0, current_y, bounds.size.w, time_h),
+                  fonts_get_system_font(PBL_IF_COLOR_ELSE(FONT_KEY_BITHAM_42_BOLD, FONT_KEY_LECO_42_NUMBERS)),
+                  GTextOverflowModeWordWrap, s_time_buffer);
+
+  // --- Data Rows ---
+  // Reset current_y to original position for data rows (ignore time offset)
   // Move data up by 5 pixels for better spacing
   current_y = vertical_padding + time_h - 5;
 
   // Location
-  s_location_layer = text_layer_create(GRect(0, current_y, bounds.size.w, location_h));
-  text_layer_set_background_color(s_location_layer, GColorClear);
-  text_layer_set_text_color(s_location_layer, GColorBlack);
-  text_layer_set_font(s_location_layer, fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD));
-  text_layer_set_text_alignment(s_location_layer, GTextAlignmentCenter);
-  text_layer_set_overflow_mode(s_location_layer, GTextOverflowModeTrailingEllipsis);
-  text_layer_set_text(s_location_layer, "");
-  layer_add_child(window_layer, text_layer_get_layer(s_location_layer));
+  create_data_row(window_layer, ROW_LOCATION, GRect(0, current_y, bounds.size.w, location_h),
+                  fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD), GTextOverflowModeTrailingEllipsis,
+                  s_location_buffer); // Empty, or restored at startup
   current_y += location_h + gap;
 
   // Update Progress Line - positioned for visual centering between location and conditions
@@ -714,33 +1343,21 @@ static void main_window_load(Window *window) {
   }
 
   // Temperature and conditions
-  s_temp_cond_layer = text_layer_create(GRect(0, current_y, bounds.size.w, temp_cond_h));
-  text_layer_set_background_color(s_temp_cond_layer, GColorClear);
-  text_layer_set_text_color(s_temp_cond_layer, GColorBlack);
-  text_layer_set_font(s_temp_cond_layer, fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD));
-  text_layer_set_text_alignment(s_temp_cond_layer, GTextAlignmentCenter);
-  text_layer_set_text(s_temp_cond_layer, "");
-  layer_add_child(window_layer, text_layer_get_layer(s_temp_cond_layer));
+  s_temp_cond_buffer[0] = '\0';
+  create_data_row(window_layer, ROW_CONDITIONS, GRect(0, current_y, bounds.size.w, temp_cond_h),
+                  fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD), GTextOverflowModeWordWrap, s_temp_cond_buffer);
   current_y += temp_cond_h + gap;
 
   // Pressure
-  s_pressure_layer = text_layer_create(GRect(0, current_y, bounds.size.w, pressure_h));
-  text_layer_set_background_color(s_pressure_layer, GColorClear);
-  text_layer_set_text_color(s_pressure_layer, GColorBlack);
-  text_layer_set_font(s_pressure_layer, fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD));
-  text_layer_set_text_alignment(s_pressure_layer, GTextAlignmentCenter);
-  text_layer_set_text(s_pressure_layer, "Loading..."); // Default text
-  layer_add_child(window_layer, text_layer_get_layer(s_pressure_layer));
+  snprintf(s_pressure_buffer, sizeof(s_pressure_buffer), "Loading..."); // Default text
+  create_data_row(window_layer, ROW_PRESSURE, GRect(0, current_y, bounds.size.w, pressure_h),
+                  fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD), GTextOverflowModeWordWrap, s_pressure_buffer);
   current_y += pressure_h + gap;
 
   // Wind and precipitation
-  s_wind_precip_layer = text_layer_create(GRect(0, current_y, bounds.size.w, wind_precip_h));
-  text_layer_set_background_color(s_wind_precip_layer, GColorClear);
-  text_layer_set_text_color(s_wind_precip_layer, GColorBlack);
-  text_layer_set_font(s_wind_precip_layer, fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD));
-  text_layer_set_text_alignment(s_wind_precip_layer, GTextAlignmentCenter);
-  text_layer_set_text(s_wind_precip_layer, "");
-  layer_add_child(window_layer, text_layer_get_layer(s_wind_precip_layer));
+  s_wind_precip_buffer[0] = '\0';
+  create_data_row(window_layer, ROW_WIND_PRECIP, GRect(0, current_y, bounds.size.w, wind_precip_h),
+                  fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD), GTextOverflowModeWordWrap, s_wind_precip_buffer);
   
   // Load step icon (will be shown/hidden based on settings)
   load_step_icon();
@@ -759,19 +1376,31 @@ static void main_window_load(Window *window) {
     // Hide icon initially (will be shown when steps are enabled)
     layer_set_hidden(bitmap_layer_get_layer(s_shoe_icon_layer), true);
   }
+  memory_telemetry_sample("window_load");
+}
+
+// Back on screen after another window: the last frame may be gone
+static void main_window_appear(Window *window) {
+  redraw_all_rows();
+}
+
+// A notification or other system overlay has closed over the face without
+// the window disappearing, and may have drawn over any of it
+static void app_did_focus(bool in_focus) {
+  if (in_focus) {
+    redraw_all_rows();
+  }
 }
 
 static void main_window_unload(Window *window) {
-  // Destroy the TextLayers and custom layers to free up memory
-  text_layer_destroy(s_time_layer);
-  text_layer_destroy(s_location_layer);
+  // Destroy the text rows and custom layers to free up memory
+  destroy_data_rows();
   if (s_update_progress_layer) {
     layer_destroy(s_update_progress_layer);
   }
-  text_layer_destroy(s_temp_cond_layer);
-  text_layer_destroy(s_pressure_layer);
-  text_layer_destroy(s_wind_precip_layer);
   
+  destroy_progress_strips();
+
   // Clean up step icon resources
   destroy_step_icon_layer();
   unload_step_icon();
@@ -780,38 +1409,72 @@ static void main_window_unload(Window *window) {
 // --- Main App Init/Deinit --- //
 
 static void init() {
+  memory_telemetry_sample("init");
+
+  // Register AppMessage handlers
+  app_message_register_inbox_received(inbox_received_callback);
+  app_message_register_inbox_dropped(inbox_dropped_callback);
+  app_message_register_outbox_sent(outbox_sent_callback);
+  app_message_register_outbox_failed(outbox_failed_callback);
+
+  // Open AppMessage first: restoring the settings can already enter low
+  // power and send the mode. Messages only arrive from the event loop.
+  // Size the buffers from the message schema rather than guessing - both
+  // come out of the app heap, so every spare byte counts.
+  app_message_open(INBOX_SIZE, OUTBOX_SIZE);
+
+  // Last known weather and settings, so the first frame isn't "Loading..."
+  restore_pressure_history();
+  restore_weather_snapshot();
+
   // Create the main Window
   s_main_window = window_create();
 
   // Set the window's load/unload handlers
   window_set_window_handlers(s_main_window, (WindowHandlers) {
     .load = main_window_load,
+    .appear = main_window_appear,
     .unload = main_window_unload
   });
 
   // Show the Window
   window_stack_push(s_main_window, true /* Animated */);
+  app_focus_service_subscribe_handlers((AppFocusHandlers) {
+    .did_focus = app_did_focus
+  });
+
+  // Draw the restored weather; the phone's next message refreshes it
+  if (s_weather.present) {
+    bool storm_warning = update_storm_warning();
+    update_pressure_display();
+    update_conditions_display(storm_warning);
+    if (!s_show_steps_enabled) {
+      update_wind_precip_display();
+    }
+  }
 
   // Subscribe to the clock service
   tick_timer_service_subscribe(MINUTE_UNIT, tick_handler);
 
-  // Register AppMessage handlers
-  app_message_register_inbox_received(inbox_received_callback);
-  app_message_register_inbox_dropped(inbox_dropped_callback);
-  app_message_register_outbox_failed(outbox_failed_callback);
-  
-  // Open AppMessage to be ready to receive data
-  // Use smaller, reasonable buffer sizes to avoid large heap usage.
-  // Our payload is small (several integers and short strings), so 2KB inbox / 512B outbox is sufficient.
-  app_message_open(2048, 512);
+  // Follow the battery, and tell the companion which mode we start in
+  battery_state_service_subscribe(update_power_mode);
+  update_power_mode(battery_state_service_peek());
+  if (!s_power_mode_acked) {
+    send_power_mode();
+  }
   
   // Initialize step tracking if enabled
   if (s_show_steps_enabled) {
+    set_step_events_enabled(!s_low_power);
     update_step_display();
   }
 }
 
 static void deinit() {
+  app_focus_service_unsubscribe();
+  battery_state_service_unsubscribe();
+  set_step_events_enabled(false);
+
   // Destroy the Window
   window_destroy(s_main_window);
 }
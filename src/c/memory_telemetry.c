@@ -0,0 +1,35 @@
+#include "memory_telemetry.h"
+
+#if defined(MEMORY_TELEMETRY)
+
+static MemoryTelemetry s_telemetry;
+
+void memory_telemetry_sample(const char *where) {
+  uint32_t used = heap_bytes_used();
+  uint32_t free_bytes = heap_bytes_free();
+
+  if (used > s_telemetry.peak_used) {
+    s_telemetry.peak_used = used;
+  }
+  if (s_telemetry.samples == 0 || free_bytes < s_telemetry.min_free) {
+    s_telemetry.min_free = free_bytes;
+  }
+  s_telemetry.samples++;
+
+  APP_LOG(APP_LOG_LEVEL_INFO, "mem %s: used=%lu free=%lu peak_used=%lu min_free=%lu largest_inbox=%lu",
+          where, (unsigned long)used, (unsigned long)free_bytes, (unsigned long)s_telemetry.peak_used,
+          (unsigned long)s_telemetry.min_free, (unsigned long)s_telemetry.largest_inbox);
+}
+
+void memory_telemetry_inbox(uint32_t size) {
+  if (size > s_telemetry.largest_inbox) {
+    s_telemetry.largest_inbox = size;
+  }
+  memory_telemetry_sample("inbox");
+}
+
+const MemoryTelemetry *memory_telemetry_get(void) {
+  return &s_telemetry;
+}
+
+#endif
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <pebble.h>
+
+// Heap high-water marks for sizing buffers against the smallest platform.
+// Off by default; build with MEMORY_TELEMETRY defined to enable it:
+//   MEMORY_TELEMETRY=1 pebble build     (see wscript)
+//   make memory                         (host run, see the Makefile)
+// Every sample is logged, so read the numbers from `pebble logs`.
+
+typedef struct {
+  uint32_t samples;
+  uint32_t peak_used;      // Largest heap_bytes_used() seen
+  uint32_t min_free;       // Smallest heap_bytes_free() seen
+  uint32_t largest_inbox;  // Largest inbox dictionary, in bytes
+} MemoryTelemetry;
+
+#if defined(MEMORY_TELEMETRY)
+
+// Record heap use at a named point, e.g. "init" or "window_load"
+void memory_telemetry_sample(const char *where);
+
+// Record the size of a received message, then sample the heap
+void memory_telemetry_inbox(uint32_t size);
+
+const MemoryTelemetry *memory_telemetry_get(void);
+
+#else
+
+#define memory_telemetry_sample(where)
+#define memory_telemetry_inbox(size)
+
+#endif
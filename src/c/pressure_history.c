@@ -0,0 +1,117 @@
+#include "pressure_history.h"
+
+// Readings within this long of each end of a trend are averaged
+#define SMOOTHING_WINDOW (30 * 60)
+
+// Storm thresholds in tenths of hPa over 3 hours: entered at the first,
+// left above the second
+#define STORM_WARNING_ENTER (-30)
+#define STORM_WARNING_EXIT (-20)
+#define STORM_SEVERE_ENTER (-50)
+#define STORM_SEVERE_EXIT (-40)
+
+// --- Ring --- //
+
+static inline const PressureSample *sample_at(const PressureHistory *history, uint8_t index) {
+  return &history->samples[(history->head + index) % PRESSURE_HISTORY_SAMPLES];
+}
+
+void pressure_history_clear(PressureHistory *history) {
+  history->head = 0;
+  history->count = 0;
+}
+
+void pressure_history_add(PressureHistory *history, time_t time, int16_t pressure_dhpa) {
+  PressureSample sample = { .time = (int32_t)time, .pressure_dhpa = pressure_dhpa };
+  if (history->count > 0) {
+    const PressureSample *newest = sample_at(history, history->count - 1);
+    if (sample.time < newest->time) {
+      return;
+    }
+    if (sample.time - newest->time < PRESSURE_HISTORY_MIN_SPACING) {
+      sample.time = newest->time;
+      history->count--; // Replaced below
+    }
+  }
+  if (history->count == PRESSURE_HISTORY_SAMPLES) {
+    history->head = (history->head + 1) % PRESSURE_HISTORY_SAMPLES;
+    history->count--;
+  }
+  history->samples[(history->head + history->count) % PRESSURE_HISTORY_SAMPLES] = sample;
+  history->count++;
+}
+
+// --- Trend --- //
+
+// Mean time and pressure of the samples within SMOOTHING_WINDOW of t, in
+// whichever direction stays inside the history
+static void smoothed_at(const PressureHistory *history, int32_t t, int32_t *mean_time, int32_t *mean_dhpa) {
+  int32_t time_sum = 0;
+  int32_t dhpa_sum = 0;
+  int count = 0;
+  for (uint8_t i = 0; i < history->count; i++) {
+    const PressureSample *sample = sample_at(history, i);
+    int32_t distance = sample->time - t;
+    if (distance < 0) {
+      distance = -distance;
+    }
+    if (distance <= SMOOTHING_WINDOW) {
+      time_sum += sample->time - t;
+      dhpa_sum += sample->pressure_dhpa;
+      count++;
+    }
+  }
+  // t is always a sample's time, so count >= 1
+  *mean_time = t + time_sum / count;
+  *mean_dhpa = dhpa_sum / count;
+}
+
+bool pressure_history_trend(const PressureHistory *history, int32_t horizon, int16_t *trend_dhpa) {
+  if (history->count < 2) {
+    return false;
+  }
+  const PressureSample *newest = sample_at(history, history->count - 1);
+
+  // The oldest sample within the horizon
+  const PressureSample *oldest = NULL;
+  for (uint8_t i = 0; i < history->count; i++) {
+    const PressureSample *sample = sample_at(history, i);
+    if (newest->time - sample->time <= horizon) {
+      oldest = sample;
+      break;
+    }
+  }
+  if (!oldest || (newest->time - oldest->time) * 3 < horizon * 2) {
+    return false;
+  }
+
+  int32_t end_time, end_dhpa, start_time, start_dhpa;
+  smoothed_at(history, newest->time, &end_time, &end_dhpa);
+  smoothed_at(history, oldest->time, &start_time, &start_dhpa);
+  int32_t span = end_time - start_time;
+  if (span <= 0) {
+    return false;
+  }
+
+  // Scale to the full horizon, rounding half away from zero
+  int32_t scaled = (end_dhpa - start_dhpa) * horizon;
+  scaled = scaled >= 0 ? (scaled + span / 2) / span : -((-scaled + span / 2) / span);
+  if (scaled > INT16_MAX) scaled = INT16_MAX;
+  if (scaled < INT16_MIN) scaled = INT16_MIN;
+  *trend_dhpa = (int16_t)scaled;
+  return true;
+}
+
+// --- Storm Warning --- //
+
+PressureStormLevel pressure_storm_level(PressureStormLevel current, int trend_3h_dhpa) {
+  if (trend_3h_dhpa <= STORM_SEVERE_ENTER ||
+      (current == PRESSURE_STORM_SEVERE && trend_3h_dhpa <= STORM_SEVERE_EXIT)) {
+    return PRESSURE_STORM_SEVERE;
+  }
+  if (trend_3h_dhpa <= STORM_WARNING_ENTER ||
+      (current != PRESSURE_STORM_NONE && trend_3h_dhpa <= STORM_WARNING_EXIT)) {
+    return PRESSURE_STORM_WARNING;
+  }
+  return PRESSURE_STORM_NONE;
+}
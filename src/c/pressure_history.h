@@ -0,0 +1,48 @@
+#pragma once
+
+#include <pebble.h>
+
+// Surface pressure readings from past fetches, kept on the watch so the
+// pressure trend (and the storm warning built on it) needs no extra requests
+// and survives restarts. The whole history is one persist_write_data() blob.
+
+#define PRESSURE_HISTORY_SAMPLES 24
+
+// Readings closer together than this replace the previous one, so a burst
+// of fetches cannot push the older samples out. The replacement keeps the
+// earlier time: a repeated reading must not look newer than it is.
+#define PRESSURE_HISTORY_MIN_SPACING (10 * 60)
+
+typedef struct {
+  int32_t time;            // UTC seconds
+  int16_t pressure_dhpa;   // Tenths of hPa
+} PressureSample;
+
+// Samples in time order in a fixed ring. head is the oldest.
+typedef struct {
+  PressureSample samples[PRESSURE_HISTORY_SAMPLES];
+  uint8_t head;
+  uint8_t count;
+} PressureHistory;
+
+// Storm warning levels, from the 3-hour trend
+typedef enum {
+  PRESSURE_STORM_NONE = 0,
+  PRESSURE_STORM_WARNING,  // Falling 3.0+ hPa in 3 hours
+  PRESSURE_STORM_SEVERE,   // Falling 5.0+ hPa in 3 hours
+} PressureStormLevel;
+
+void pressure_history_clear(PressureHistory *history);
+
+// Record a reading. Readings older than the newest sample are ignored.
+void pressure_history_add(PressureHistory *history, time_t time, int16_t pressure_dhpa);
+
+// Change in tenths of hPa over the last horizon seconds, scaled to the full
+// horizon. Each end is smoothed over the samples within 30 minutes of it.
+// Returns false if the history spans less than two thirds of the horizon.
+bool pressure_history_trend(const PressureHistory *history, int32_t horizon, int16_t *trend_dhpa);
+
+// Storm level for a 3-hour trend, given the current level. A level is
+// entered at its threshold but only left once the trend has recovered by
+// another 1.0 hPa, so a reading hovering at the threshold does not flap.
+PressureStormLevel pressure_storm_level(PressureStormLevel current, int trend_3h_dhpa);
@@ -0,0 +1,167 @@
+#include "weather_record.h"
+
+// --- Decoding --- //
+
+static inline uint16_t read_u16(const uint8_t *p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline int16_t read_s16(const uint8_t *p) {
+  return (int16_t)read_u16(p);
+}
+
+bool weather_record_decode(const uint8_t *data, uint16_t length, WeatherRecord *record) {
+  if (!data || length < WEATHER_RECORD_HEADER_SIZE || data[0] != WEATHER_RECORD_VERSION) {
+    return false;
+  }
+
+  memset(record, 0, sizeof(*record));
+  record->flags = data[1];
+  record->present = read_u16(&data[2]);
+
+  const uint8_t *p = data + WEATHER_RECORD_HEADER_SIZE;
+  const uint8_t *end = data + length;
+  uint16_t present = record->present;
+
+  // Each field is fixed width, so check the whole fixed part up front
+  uint16_t fixed_size = 0;
+  if (present & WEATHER_FIELD_STATUS) fixed_size += 3;
+  if (present & WEATHER_FIELD_PRESSURE) fixed_size += 2;
+  if (present & WEATHER_FIELD_TREND) fixed_size += 2;
+  if (present & WEATHER_FIELD_TEMPERATURE) fixed_size += 2;
+  if (present & WEATHER_FIELD_HUMIDITY) fixed_size += 1;
+  if (present & WEATHER_FIELD_WIND) fixed_size += 2;
+  if (present & WEATHER_FIELD_PRECIP) fixed_size += 2;
+  if (present & WEATHER_FIELD_CONDITION) fixed_size += 1;
+  if (present & WEATHER_FIELD_UNITS) fixed_size += 1;
+  if (present & WEATHER_FIELD_SETTINGS) fixed_size += 1;
+  if (present & WEATHER_FIELD_NEXT_FETCH) fixed_size += 2;
+  if (present & WEATHER_FIELD_SETTINGS_VERSION) fixed_size += 2;
+  if (present & WEATHER_FIELD_LOCATION) fixed_size += 1;
+  if (end - p < fixed_size) {
+    return false;
+  }
+
+  if (present & WEATHER_FIELD_STATUS) {
+    record->status = p[0];
+    record->status_detail = read_u16(&p[1]);
+    p += 3;
+  }
+  if (present & WEATHER_FIELD_PRESSURE) {
+    record->pressure_dhpa = read_s16(p);
+    p += 2;
+  }
+  if (present & WEATHER_FIELD_TREND) {
+    record->trend_dhpa = read_s16(p);
+    p += 2;
+  }
+  if (present & WEATHER_FIELD_TEMPERATURE) {
+    record->temperature_dc = read_s16(p);
+    p += 2;
+  }
+  if (present & WEATHER_FIELD_HUMIDITY) {
+    record->humidity = *p++;
+  }
+  if (present & WEATHER_FIELD_WIND) {
+    record->wind_dkmh = read_u16(p);
+    p += 2;
+  }
+  if (present & WEATHER_FIELD_PRECIP) {
+    record->precip_dmm = read_u16(p);
+    p += 2;
+  }
+  if (present & WEATHER_FIELD_CONDITION) {
+    record->condition = *p++;
+  }
+  if (present & WEATHER_FIELD_UNITS) {
+    record->units = *p++;
+  }
+  if (present & WEATHER_FIELD_SETTINGS) {
+    record->settings = *p++;
+  }
+  if (present & WEATHER_FIELD_NEXT_FETCH) {
+    record->next_fetch_s = read_u16(p);
+    p += 2;
+  }
+  if (present & WEATHER_FIELD_SETTINGS_VERSION) {
+    record->settings_version = read_u16(p);
+    p += 2;
+  }
+  if (present & WEATHER_FIELD_LOCATION) {
+    uint8_t location_length = *p++;
+    if (location_length > WEATHER_RECORD_LOCATION_MAX || end - p < location_length) {
+      return false;
+    }
+    record->location = (const char *)p;
+    record->location_length = location_length;
+  }
+  return true;
+}
+
+void weather_record_merge(WeatherRecord *state, const WeatherRecord *update) {
+  if (update->flags & WEATHER_RECORD_FLAG_FULL) {
+    memset(state, 0, sizeof(*state));
+  }
+  uint16_t present = update->present;
+  if (present & WEATHER_FIELD_STATUS) {
+    state->status = update->status;
+    state->status_detail = update->status_detail;
+  }
+  if (present & WEATHER_FIELD_PRESSURE) state->pressure_dhpa = update->pressure_dhpa;
+  if (present & WEATHER_FIELD_TREND) state->trend_dhpa = update->trend_dhpa;
+  if (present & WEATHER_FIELD_TEMPERATURE) state->temperature_dc = update->temperature_dc;
+  if (present & WEATHER_FIELD_HUMIDITY) state->humidity = update->humidity;
+  if (present & WEATHER_FIELD_WIND) state->wind_dkmh = update->wind_dkmh;
+  if (present & WEATHER_FIELD_PRECIP) state->precip_dmm = update->precip_dmm;
+  if (present & WEATHER_FIELD_CONDITION) state->condition = update->condition;
+  if (present & WEATHER_FIELD_UNITS) state->units = update->units;
+  if (present & WEATHER_FIELD_SETTINGS) state->settings = update->settings;
+  if (present & WEATHER_FIELD_NEXT_FETCH) state->next_fetch_s = update->next_fetch_s;
+  if (present & WEATHER_FIELD_SETTINGS_VERSION) state->settings_version = update->settings_version;
+  state->present |= present & ~WEATHER_FIELD_LOCATION;
+}
+
+// --- Conditions --- //
+
+// Open-Meteo WMO Weather interpretation codes (WW)
+// https://open-meteo.com/en/docs
+const char *weather_condition_text(uint8_t wmo_code) {
+  switch (wmo_code) {
+    case 0: return "Clear Sky";
+    case 1: return "Mainly Clear";
+    case 2: return "Partly Cloudy";
+    case 3: return "Overcast";
+
+    case 45: return "Fog";
+    case 48: return "Depositing Rime";
+
+    case 51: return "Light Drizzle";
+    case 53: return "Moderate Drizzle";
+    case 55: return "Dense Drizzle";
+    case 56: return "Light Freezing Drizzle";
+    case 57: return "Dense Freezing Drizzle";
+
+    case 61: return "Slight Rain";
+    case 63: return "Moderate Rain";
+    case 65: return "Heavy Rain";
+    case 66: return "Light Freezing Rain";
+    case 67: return "Heavy Freezing Rain";
+
+    case 71: return "Slight Snow";
+    case 73: return "Moderate Snow";
+    case 75: return "Heavy Snow";
+    case 77: return "Snow Grains";
+
+    case 80: return "Slight Rain Showers";
+    case 81: return "Moderate Rain Showers";
+    case 82: return "Violent Rain Showers";
+    case 85: return "Slight Snow Showers";
+    case 86: return "Heavy Snow Showers";
+
+    case 95: return "Thunderstorm";
+    case 96: return "Thunderstorm w/ Slight Hail";
+    case 99: return "Thunderstorm w/ Heavy Hail";
+
+    default: return NULL;
+  }
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <pebble.h>
+
+// Packed weather record sent by the companion as a single byte-array tuple
+// (MESSAGE_KEY_WEATHER_RECORD). Built by src/pkjs/weather_record.js -- the two
+// files must agree on field order, widths and bit assignments.
+//
+// Layout, little-endian:
+//   u8  version            WEATHER_RECORD_VERSION
+//   u8  flags              WeatherRecordFlag bits
+//   u16 present            WeatherRecordField bits, one per field below
+// then, in this order, only the fields whose bit is set:
+//   STATUS       u8 status (WeatherStatus), u16 detail (e.g. HTTP status)
+//   PRESSURE     s16 surface pressure, tenths of hPa
+//   TREND        s16 pressure change over 3h, tenths of hPa
+//   TEMPERATURE  s16 tenths of a degree Celsius
+//   HUMIDITY     u8  percent
+//   WIND         u16 tenths of km/h
+//   PRECIP       u16 today's total, tenths of mm
+//   CONDITION    u8  WMO weather code
+//   UNITS        u8  WEATHER_UNITS_* bits
+//   SETTINGS     u8  WEATHER_SETTING_* bits
+//   NEXT_FETCH   u16 seconds from sending until the companion fetches again
+//   SETTINGS_VERSION u16 bumped by the companion each time UNITS or SETTINGS change
+//   LOCATION     u8 length, then that many UTF-8 bytes (no terminator)
+//
+// Readings are always metric; the watch converts them to the display units.
+
+#define WEATHER_RECORD_VERSION 1
+#define WEATHER_RECORD_HEADER_SIZE 4
+#define WEATHER_RECORD_LOCATION_MAX 31
+
+// Largest record the companion can send: every field and a full-length
+// location. Must match MAX_SIZE in weather_record.js.
+#define WEATHER_RECORD_MAX_SIZE (WEATHER_RECORD_HEADER_SIZE + 3 + 2 + 2 + 2 + 1 + 2 + 2 + 1 + 1 + 1 + \
+                                 2 + 2 + 1 + WEATHER_RECORD_LOCATION_MAX)
+
+typedef enum {
+  WEATHER_FIELD_STATUS = 1 << 0,
+  WEATHER_FIELD_PRESSURE = 1 << 1,
+  WEATHER_FIELD_TREND = 1 << 2,
+  WEATHER_FIELD_TEMPERATURE = 1 << 3,
+  WEATHER_FIELD_HUMIDITY = 1 << 4,
+  WEATHER_FIELD_WIND = 1 << 5,
+  WEATHER_FIELD_PRECIP = 1 << 6,
+  WEATHER_FIELD_CONDITION = 1 << 7,
+  WEATHER_FIELD_UNITS = 1 << 8,
+  WEATHER_FIELD_SETTINGS = 1 << 9,
+  WEATHER_FIELD_LOCATION = 1 << 10,
+  WEATHER_FIELD_NEXT_FETCH = 1 << 11, // Sent before LOCATION, which stays last on the wire
+  WEATHER_FIELD_SETTINGS_VERSION = 1 << 12, // Also before LOCATION
+} WeatherRecordField;
+
+// The companion sends only the fields that changed since the watch last
+// acknowledged a record, with a complete record now and then.
+typedef enum {
+  // Complete state: fields missing from this record no longer apply
+  WEATHER_RECORD_FLAG_FULL = 1 << 0,
+  // Result of a new fetch, even if no field changed: restarts the countdown
+  WEATHER_RECORD_FLAG_FETCHED = 1 << 1,
+} WeatherRecordFlag;
+
+// Why the companion has no fresh readings to send
+typedef enum {
+  WEATHER_STATUS_OK = 0,
+  WEATHER_STATUS_PARSE_ERROR = 1,
+  WEATHER_STATUS_HTTP_FAIL = 2,
+  WEATHER_STATUS_TIMEOUT = 3,
+  WEATHER_STATUS_NET_ERROR = 4,
+} WeatherStatus;
+
+// UNITS byte: one bit per display unit choice, 0 = the default
+#define WEATHER_UNITS_FAHRENHEIT (1 << 0)
+#define WEATHER_UNITS_WIND_KPH (1 << 1)
+#define WEATHER_UNITS_PRECIP_INCHES (1 << 2)
+
+// SETTINGS byte
+#define WEATHER_SETTING_HOURLY_VIBRATION (1 << 0)
+#define WEATHER_SETTING_UPDATE_COUNTDOWN (1 << 1)
+#define WEATHER_SETTING_SHOW_STEPS (1 << 2)
+#define WEATHER_SETTING_STEP_UNIT_MILES (1 << 3)
+#define WEATHER_SETTING_STORM_WARNING (1 << 4)
+#define WEATHER_SETTING_POWER_SAVE (1 << 5) // Low-power mode whenever on battery, not just when low
+
+typedef struct {
+  uint8_t flags;
+  uint16_t present;
+  uint8_t status;
+  uint16_t status_detail;
+  int16_t pressure_dhpa;
+  int16_t trend_dhpa;
+  int16_t temperature_dc;
+  uint8_t humidity;
+  uint16_t wind_dkmh;
+  uint16_t precip_dmm;
+  uint8_t condition;
+  uint8_t units;
+  uint8_t settings;
+  uint16_t next_fetch_s;
+  uint16_t settings_version;
+  // Points into the decoded buffer; copy it out before the inbox is reused
+  const char *location;
+  uint8_t location_length;
+} WeatherRecord;
+
+// Decode a record in one pass. Returns false if the version is unknown or
+// the data is shorter than its present bits claim.
+bool weather_record_decode(const uint8_t *data, uint16_t length, WeatherRecord *record);
+
+// Copy the fields present in update into state (location excluded). A
+// WEATHER_RECORD_FLAG_FULL update replaces state entirely.
+void weather_record_merge(WeatherRecord *state, const WeatherRecord *update);
+
+// Display text for a WMO weather code, or NULL if the code is not known
+const char *weather_condition_text(uint8_t wmo_code);
@@ -14,57 +14,173 @@ var settings = {
   update_countdown: true,
   show_steps: false,
   step_unit: 'miles',
-  storm_warning: false
+  storm_warning: false,
+  power_save: false
 };
 
-// Store last weather data for immediate re-sending when units change
+// Bumped each time the settings page saves a change, and sent with the
+// settings: the watch applies each version once, and a delta leaves the
+// settings out once the watch has acknowledged their version
+var settingsVersion = 0;
+
+// Weather readings, units and settings travel to the watch as one packed record
+var WeatherRecord = require('./weather_record');
+var WEATHER_RECORD_KEY = (MessageKeys && typeof MessageKeys.WEATHER_RECORD !== 'undefined') ? MessageKeys.WEATHER_RECORD : 19;
+
+// The watch reports entering (1) and leaving (0) low-power mode
+var POWER_MODE_KEY = (MessageKeys && typeof MessageKeys.POWER_MODE !== 'undefined') ? MessageKeys.POWER_MODE : 21;
+
+// Decides when to fetch next; its history survives companion restarts
+var Scheduler = require('./scheduler');
+var SCHEDULE_KEY = 'just_weather_schedule';
+var fetchScheduler = null;
+var fetchTimer = null;
+var nextFetchTime = 0;
+var fetchPending = false; // A fetch has started and its result is not yet recorded
+// Geolocation, Nominatim and Open-Meteo time out after 10 + 10 + 30 s; a
+// fetch still without a result after this has lost a callback, and counts
+// as failed so the next one is still scheduled
+var FETCH_WATCHDOG_MS = 90 * 1000;
+var fetchWatchdog = null;
+
+// Place names already resolved near here, so most refreshes skip Nominatim
+var PlaceCache = require('./place_cache');
+var placeCache = null;
+
+// Open-Meteo readings by position and model slot
+var WeatherCache = require('./weather_cache');
+var weatherCache = null;
+
+// Store last weather data (metric) for immediate re-sending when units change
 var lastWeatherData = null;
 
+// Everything for the watch goes through one queue: one message in flight,
+// NACKs and timeouts retried with backoff, and a newer record or timeline
+// taking the place of one still waiting to be sent
+var SendQueue = require('./send_queue');
+var sendQueue = new SendQueue(function(dict, ack, nack) {
+  Pebble.sendAppMessage(dict, ack, nack);
+}, {
+  log: function(text) {
+    console.log('[JS] ' + text);
+  }
+});
+
+// Flags of records queued and not yet built: a status record that replaces
+// a fetched one in the queue must still restart the watch's countdown
+var queuedRecordFlags = 0;
+
+// What the watch has acknowledged (encoded record fields), so later sends
+// only carry the fields that changed. Reset whenever a send fails, since we
+// can no longer be sure what the watch holds.
+var ackedRecord = null;
+var lastFullSyncTime = 0;
+// Send the complete state now and then even if nothing seems to have changed
+var FULL_RESYNC_INTERVAL_MS = 60 * 60 * 1000;
+
+// Send a record (see weather_record.js for the fields) to the watch, as a
+// delta against what it last acknowledged. flags: WeatherRecord.FLAG_*.
+// done, if given, runs once the watch has answered or nothing was sent.
+// The delta is worked out when the record's turn in the queue comes.
+function sendWeatherRecord(data, label, flags, done) {
+  queuedRecordFlags |= flags || 0;
+  var sent = null; // { payload, full, time } once built
+
+  sendQueue.push('record', function() {
+    var flags = queuedRecordFlags;
+    queuedRecordFlags = 0;
+    if (data.settings) {
+      data.settingsVersion = settingsVersion;
+    }
+    var encoded = WeatherRecord.encode(data);
+    var now = Date.now();
+    var full = !ackedRecord || (now - lastFullSyncTime) >= FULL_RESYNC_INTERVAL_MS;
+    var payload = full ? encoded : WeatherRecord.changes(encoded, ackedRecord);
+    // Only a record with readings may replace the watch's state outright;
+    // a status-only resync must not wipe the readings it already shows
+    if (full && 'pressure' in encoded) {
+      flags |= WeatherRecord.FLAG_FULL;
+    }
+
+    // A fresh fetch still goes out when unchanged so the watch restarts its countdown
+    if (!full && WeatherRecord.isEmpty(payload) && !(flags & WeatherRecord.FLAG_FETCHED)) {
+      console.log('[JS] ' + label + ': nothing changed, not sending');
+      return null;
+    }
+
+    var bytes = WeatherRecord.packEncoded(payload, flags);
+    var dict = {};
+    dict[WEATHER_RECORD_KEY] = bytes;
+    sent = { payload: payload, full: full, time: now };
+    console.log('[JS] Sending ' + label + ' record (' + (full ? 'full' : 'delta') + '): ' + bytes.length + ' bytes');
+    return dict;
+  }, function(delivered) {
+    // A record replaced in the queue was never built; the one that replaced it updates ackedRecord
+    if (!delivered) {
+      console.log('[JS] ' + label + ' send FAILED');
+      ackedRecord = null;
+    } else if (sent && sent.full) {
+      ackedRecord = sent.payload;
+      lastFullSyncTime = sent.time;
+    } else if (sent) {
+      ackedRecord = WeatherRecord.merge(ackedRecord, sent.payload);
+    }
+    if (done) done();
+  });
+}
+
+// The forecast timeline goes in its own message, after the record it
+// belongs to. The last one the watch acknowledged is not sent again.
+var ForecastTimeline = require('./forecast_timeline');
+var FORECAST_TIMELINE_KEY = (MessageKeys && typeof MessageKeys.FORECAST_TIMELINE !== 'undefined') ? MessageKeys.FORECAST_TIMELINE : 20;
+var ackedTimeline = null;
+
+function sendForecastTimeline(entries) {
+  var sent = null; // The packed timeline, once built and sent
+
+  sendQueue.push('timeline', function() {
+    var bytes = ForecastTimeline.pack(entries || []);
+    if (!bytes || bytes.join(',') === ackedTimeline) {
+      return null;
+    }
+    var dict = {};
+    dict[FORECAST_TIMELINE_KEY] = bytes;
+    sent = bytes.join(',');
+    console.log('[JS] Sending forecast timeline: ' + bytes[5] + ' entries, ' + bytes.length + ' bytes');
+    return dict;
+  }, function(delivered) {
+    if (!delivered) {
+      console.log('[JS] Forecast timeline send FAILED');
+      ackedTimeline = null;
+    } else if (sent) {
+      ackedTimeline = sent;
+    }
+  });
+}
+
 // Global function to resend weather data with current units
 function resendWeatherWithCurrentUnits() {
   console.log('[JS] resendWeatherWithCurrentUnits called (global scope)');
   console.log('[JS] lastWeatherData exists: ' + (lastWeatherData ? 'YES' : 'NO'));
   console.log('[JS] Current settings: ' + JSON.stringify(settings));
-  
-  // Use real weather data if available, otherwise use test data
-  var useData = lastWeatherData || {
-    pressure: 1013,
-    temperature: 20, // celsius
-    wind: 15, // km/h  
-    precipitation: 2.5, // mm
-    conditions: 'Settings Update'
-  };
-  
-  console.log('[JS] Sending weather update with current units (real data: ' + (lastWeatherData ? 'YES' : 'NO') + ')...');
-  
-  // Simple inline message construction and sending with unit conversions
-  var dict = {};
-  dict[0] = Math.round(useData.pressure); // PRESSURE_KEY = 0
-  dict[1] = Math.round(settings.temperature_unit === 'fahrenheit' ? (useData.temperature * 9/5) + 32 : useData.temperature); // TEMPERATURE_KEY = 1
-  dict[2] = useData.conditions || 'Settings Update'; // CONDITIONS_KEY = 2 - use real conditions if available
-  dict[4] = Math.round(settings.wind_unit === 'mph' ? useData.wind * 0.621371 : useData.wind); // WIND_KEY = 4
-  dict[5] = Math.round(settings.precipitation_unit === 'inches' ? useData.precipitation * 0.0393701 * 100 : useData.precipitation * 10); // PRECIP_KEY = 5
-  dict[6] = useData.location || 'Settings'; // LOCATION_KEY = 6 - use real location if available
-  dict[9] = settings.temperature_unit === 'fahrenheit' ? 'F' : 'C'; // TEMP_UNIT_KEY = 9
-  dict[10] = settings.wind_unit === 'mph' ? 'mph' : 'kph'; // WIND_UNIT_KEY = 10
-  dict[11] = settings.precipitation_unit === 'inches' ? 'in' : 'mm'; // PRECIP_UNIT_KEY = 11
-  dict[12] = settings.hourly_vibration ? 1 : 0; // HOURLY_VIBRATION_KEY = 12
-  dict[13] = settings.update_countdown ? 1 : 0; // UPDATE_COUNTDOWN_KEY = 13
-  dict[14] = settings.show_steps ? 1 : 0; // SHOW_STEPS_KEY = 14  
-  dict[15] = settings.step_unit === 'miles' ? 1 : 0; // STEP_UNIT_KEY = 15
-  dict[16] = settings.storm_warning ? 1 : 0; // STORM_WARNING_KEY = 16
-  
-  console.log('[JS] Test message dict: ' + JSON.stringify(dict));
-  
-  Pebble.sendAppMessage(dict,
-    function() { console.log('[JS] Settings update message sent successfully'); },
-    function(e) { console.log('[JS] Settings update message failed: ' + JSON.stringify(e)); }
-  );
+
+  // Readings are sent in metric and converted on the watch, so new units only
+  // need the settings. The last readings go along in case the watch needs a
+  // full resync; otherwise the delta drops them.
+  var data = {};
+  if (lastWeatherData) {
+    for (var field in lastWeatherData) {
+      data[field] = lastWeatherData[field];
+    }
+  }
+  data.settings = settings;
+  sendWeatherRecord(data, 'Settings update');
 }
 
 // Load settings from localStorage
 function loadSettings() {
   var saved = localStorage.getItem('just_weather_settings');
+  settingsVersion = parseInt(localStorage.getItem('just_weather_settings_version'), 10) || 0;
   if (saved) {
     try {
       var savedSettings = JSON.parse(saved);
@@ -77,6 +193,7 @@ function loadSettings() {
       if (typeof savedSettings.show_steps !== 'undefined') settings.show_steps = savedSettings.show_steps;
       if (savedSettings.step_unit) settings.step_unit = savedSettings.step_unit;
       if (typeof savedSettings.storm_warning !== 'undefined') settings.storm_warning = savedSettings.storm_warning;
+      if (typeof savedSettings.power_save !== 'undefined') settings.power_save = savedSettings.power_save;
       console.log('[JS] Loaded settings:', JSON.stringify(settings));
     } catch (e) {
       console.log('[JS] Error loading settings, using defaults');
@@ -87,254 +204,84 @@ function loadSettings() {
 // Save settings to localStorage
 function saveSettings() {
   localStorage.setItem('just_weather_settings', JSON.stringify(settings));
-  console.log('[JS] Saved settings:', JSON.stringify(settings));
-  
-  // Immediately update display with new units when settings are saved
-  console.log('[JS] Settings saved - immediately updating display with new units...');
-  try {
-    console.log('[JS] About to call resend function...');
-    
-    // Check if the function exists
-    if (typeof resendWeatherWithCurrentUnits === 'function') {
-      console.log('[JS] resendWeatherWithCurrentUnits function exists, calling it...');
-      resendWeatherWithCurrentUnits();
-    } else {
-      console.log('[JS] ERROR: resendWeatherWithCurrentUnits function not found!');
-      console.log('[JS] typeof resendWeatherWithCurrentUnits: ' + typeof resendWeatherWithCurrentUnits);
-    }
-  } catch (error) {
-    console.log('[JS] ERROR calling resend function: ' + error.toString());
-  }
-}
-
-// Unit conversion functions
-function convertTemperature(celsius, targetUnit) {
-  if (targetUnit === 'fahrenheit') {
-    return (celsius * 9/5) + 32;
-  }
-  return celsius; // celsius
-}
-
-function convertWindSpeed(kmh, targetUnit) {
-  if (targetUnit === 'mph') {
-    return kmh * 0.621371; // km/h to mph
-  }
-  return kmh; // kph
-}
-
-function convertPrecipitation(mm, targetUnit) {
-  if (targetUnit === 'inches') {
-    return mm * 0.0393701; // mm to inches
-  }
-  return mm; // mm
-}
-
-function getTemperatureLabel() {
-  return settings.temperature_unit === 'fahrenheit' ? 'F' : 'C';
-}
-
-function getWindLabel() {
-  return settings.wind_unit === 'mph' ? 'mph' : 'kph';
+  localStorage.setItem('just_weather_settings_version', String(settingsVersion));
+  console.log('[JS] Saved settings v' + settingsVersion + ':', JSON.stringify(settings));
 }
 
-function getPrecipitationLabel() {
-  return settings.precipitation_unit === 'inches' ? 'in' : 'mm';
-}
-
-
-
 Pebble.addEventListener('ready', function(e) {
   console.log('[JS] src/pkjs/app.js is ready.');
   
-  // Load settings on startup
+  // Load settings on startup; the first weather record carries them
   loadSettings();
   
-  // Start polling for settings changes every 2 seconds
-  setInterval(function() {
-    var currentSettingsString = JSON.stringify(settings);
-    var savedSettingsString = localStorage.getItem('just_weather_settings');
-    
-    console.log('[JS] Polling check - current: ' + currentSettingsString.substring(0, 50) + '...');
-    console.log('[JS] Polling check - saved: ' + (savedSettingsString ? savedSettingsString.substring(0, 50) + '...' : 'NULL'));
-    
-    if (savedSettingsString && savedSettingsString !== currentSettingsString) {
-      console.log('[JS] Settings changed detected! Old: ' + currentSettingsString);
-      console.log('[JS] New settings: ' + savedSettingsString);
-      
-      // Load the new settings
-      loadSettings();
-      
-      // Immediately update display with new units
-      console.log('[JS] Immediately updating display with new units...');
-      resendWeatherWithCurrentUnits();
-    }
-  }, 3000);
-
-  // --- 1. Define Keys ---
-  var PRESSURE_KEY = (MessageKeys && typeof MessageKeys.PRESSURE !== 'undefined') ? MessageKeys.PRESSURE : 0;
-  var TEMPERATURE_KEY = (MessageKeys && typeof MessageKeys.TEMPERATURE !== 'undefined') ? MessageKeys.TEMPERATURE : 1;
-  var CONDITIONS_KEY = (MessageKeys && typeof MessageKeys.CONDITIONS !== 'undefined') ? MessageKeys.CONDITIONS : 2;
-  var HUMIDITY_KEY = (MessageKeys && typeof MessageKeys.HUMIDITY !== 'undefined') ? MessageKeys.HUMIDITY : 3;
-  var WIND_KEY = (MessageKeys && typeof MessageKeys.WIND !== 'undefined') ? MessageKeys.WIND : 4;
-  var PRECIP_KEY = (MessageKeys && typeof MessageKeys.PRECIP !== 'undefined') ? MessageKeys.PRECIP : 5;
-  var LOCATION_KEY = (MessageKeys && typeof MessageKeys.LOCATION !== 'undefined') ? MessageKeys.LOCATION : 6;
-  var PRESSURE_TREND_KEY = (MessageKeys && typeof MessageKeys.PRESSURE_TREND !== 'undefined') ? MessageKeys.PRESSURE_TREND : 7;
-  var TEST_KEY = (MessageKeys && typeof MessageKeys.PRESSURE_TEST !== 'undefined') ? MessageKeys.PRESSURE_TEST : 8;
-  var TEMP_UNIT_KEY = (MessageKeys && typeof MessageKeys.TEMP_UNIT !== 'undefined') ? MessageKeys.TEMP_UNIT : 9;
-  var WIND_UNIT_KEY = (MessageKeys && typeof MessageKeys.WIND_UNIT !== 'undefined') ? MessageKeys.WIND_UNIT : 10;
-  var PRECIP_UNIT_KEY = (MessageKeys && typeof MessageKeys.PRECIP_UNIT !== 'undefined') ? MessageKeys.PRECIP_UNIT : 11;
-  var HOURLY_VIBRATION_KEY = (MessageKeys && typeof MessageKeys.HOURLY_VIBRATION !== 'undefined') ? MessageKeys.HOURLY_VIBRATION : 12;
-  var UPDATE_COUNTDOWN_KEY = (MessageKeys && typeof MessageKeys.UPDATE_COUNTDOWN !== 'undefined') ? MessageKeys.UPDATE_COUNTDOWN : 13;
-  var SHOW_STEPS_KEY = (MessageKeys && typeof MessageKeys.SHOW_STEPS !== 'undefined') ? MessageKeys.SHOW_STEPS : 14;
-  var STEP_UNIT_KEY = (MessageKeys && typeof MessageKeys.STEP_UNIT !== 'undefined') ? MessageKeys.STEP_UNIT : 15;
-
-  // --- 2. Weather Sending Helper ---
-  function sendWeatherToWatch(pressureValue, tempValue, condText, humidityValue, windValue, precipValue, pressureTrend, locationName) {
+  // --- 2. Weather Sending Helpers ---
+  // cached: readings from the cache rather than a fetch just made - they
+  // must not restart the watch's countdown or be recorded as a new reading
+  // timeline: forecast entries from ForecastTimeline.build(), sent after the record
+  function sendWeatherToWatch(pressureValue, tempValue, weatherCode, humidityValue, windValue, precipValue, pressureTrend, locationName, cached, timeline) {
     console.log('[JS] sendWeatherToWatch called with args:', {p: pressureValue, t: tempValue, w: windValue, pr: precipValue});
-    
-    // Store the raw data for re-sending when units change
+
+    // Store the raw metric data for re-sending when units change
     lastWeatherData = {
+      status: WeatherRecord.STATUS.OK,
       pressure: pressureValue,
-      temperature: tempValue, 
-      conditions: condText,
+      temperature: tempValue,
+      weatherCode: weatherCode,
       humidity: humidityValue,
       wind: windValue,
       precipitation: precipValue,
       trend: pressureTrend,
       location: locationName
     };
-    
-    var dict = {};
-    if (typeof pressureValue !== 'undefined') dict[PRESSURE_KEY] = Math.round(pressureValue);
-    if (typeof pressureTrend !== 'undefined') dict[PRESSURE_TREND_KEY] = pressureTrend.toString();
-    
-    // Apply unit conversions with debug logging
-    if (typeof tempValue !== 'undefined') {
-      var convertedTemp = convertTemperature(tempValue, settings.temperature_unit);
-      console.log('[JS] Temperature conversion: ' + tempValue + 'C -> ' + convertedTemp + getTemperatureLabel());
-      dict[TEMPERATURE_KEY] = Math.round(convertedTemp);
-    }
-    
-    if (typeof condText !== 'undefined') dict[CONDITIONS_KEY] = condText.toString();
-    if (typeof humidityValue !== 'undefined') dict[HUMIDITY_KEY] = Math.round(humidityValue);
-    
-    if (typeof windValue !== 'undefined') {
-      var convertedWind = convertWindSpeed(windValue, settings.wind_unit);
-      console.log('[JS] Wind conversion: ' + windValue + 'km/h -> ' + convertedWind + getWindLabel());
-      dict[WIND_KEY] = Math.round(convertedWind);
+
+    var data = {};
+    for (var field in lastWeatherData) {
+      data[field] = lastWeatherData[field];
     }
-    
-    if (typeof precipValue !== 'undefined') {
-      var convertedPrecip = convertPrecipitation(precipValue, settings.precipitation_unit);
-      console.log('[JS] Precip conversion: ' + precipValue + 'mm -> ' + convertedPrecip + getPrecipitationLabel());
-      if (settings.precipitation_unit === 'inches') {
-        // Send as hundredths of an inch (multiply by 100)
-        dict[PRECIP_KEY] = Math.round(convertedPrecip * 100);
-      } else {
-        // Send as tenths of mm (multiply by 10)
-        dict[PRECIP_KEY] = Math.round(convertedPrecip * 10);
-      }
+    data.settings = settings;
+    data.nextFetch = secondsUntilNextFetch();
+    sendWeatherRecord(data, cached ? 'Cached weather' : 'Weather', cached ? 0 : WeatherRecord.FLAG_FETCHED, function() {
+      sendForecastTimeline(timeline);
+    });
+  }
+
+  // Tell the watch why there is no fresh data; it keeps showing the last readings
+  function sendStatusToWatch(status, detail, locationName) {
+    var data = {};
+    for (var field in lastWeatherData) {
+      data[field] = lastWeatherData[field];
     }
-    
-    if (typeof locationName !== 'undefined') dict[LOCATION_KEY] = locationName.toString();
-    
-    // Send unit labels so watch displays correctly
-    dict[TEMP_UNIT_KEY] = getTemperatureLabel();
-    dict[WIND_UNIT_KEY] = getWindLabel();
-    dict[PRECIP_UNIT_KEY] = getPrecipitationLabel();
-    
-    // Send settings
-    dict[HOURLY_VIBRATION_KEY] = settings.hourly_vibration ? 1 : 0;
-    dict[UPDATE_COUNTDOWN_KEY] = settings.update_countdown ? 1 : 0;
-    dict[SHOW_STEPS_KEY] = settings.show_steps ? 1 : 0;
-    dict[STEP_UNIT_KEY] = settings.step_unit === 'miles' ? 1 : 0; // 1 = miles, 0 = kilometers
-    
-    console.log('[JS] Final message with units: temp=' + dict[TEMP_UNIT_KEY] + ', wind=' + dict[WIND_UNIT_KEY] + ', precip=' + dict[PRECIP_UNIT_KEY] + ', vibration=' + dict[HOURLY_VIBRATION_KEY] + ', countdown=' + dict[UPDATE_COUNTDOWN_KEY] + ', steps=' + dict[SHOW_STEPS_KEY] + ', step_unit=' + dict[STEP_UNIT_KEY]);
-    console.log('[JS] Calling Pebble.sendAppMessage...');
-    
-    Pebble.sendAppMessage(dict,
-      function() { console.log('[JS] Weather sent SUCCESS: ' + JSON.stringify(dict)); },
-      function(e) { console.log('[JS] Weather send FAILED: ' + JSON.stringify(e)); }
-    );
-    console.log('[JS] sendAppMessage call completed (async)');
+    data.status = status;
+    data.statusDetail = detail;
+    data.location = locationName;
+    data.settings = settings;
+    data.nextFetch = secondsUntilNextFetch();
+    sendWeatherRecord(data, 'Status');
   }
 
   // --- 2.6 Test function to send sample data with current unit settings ---
   function sendTestDataWithCurrentUnits() {
     console.log('[JS] Sending test data with current units: ' + JSON.stringify(settings));
-    
-    // Always start with base metric values and let the conversion functions handle it
-    var baseTempC = 20; // 20C
-    var baseWindKmh = 16; // 16 km/h  
-    var basePrecipMm = 2.5; // 2.5 mm
-    
-    console.log('[JS] Base values: temp=' + baseTempC + 'C, wind=' + baseWindKmh + 'kmh, precip=' + basePrecipMm + 'mm');
-    console.log('[JS] Target units: temp=' + settings.temperature_unit + ', wind=' + settings.wind_unit + ', precip=' + settings.precipitation_unit);
-    
-    console.log('[JS] About to call sendWeatherToWatch with converted units...');
-    
+
+    // Readings are always metric; the watch converts them to the user's units
     try {
-      // The sendWeatherToWatch function will convert these to the user's preferred units
       sendWeatherToWatch(
         1013, // pressure
-        baseTempC, // temperature in Celsius (will be converted)
-        'Test Mode',
+        20, // temperature in Celsius
+        2, // Partly Cloudy
         50, // humidity
-        baseWindKmh, // wind in km/h (will be converted)
-        basePrecipMm, // precip in mm (will be converted)
-        '+0.5', // trend
+        16, // wind in km/h
+        2.5, // precip in mm
+        0.5, // trend
         'Settings Test'
       );
-      
+
       console.log('[JS] sendWeatherToWatch call completed');
     } catch (error) {
       console.log('[JS] ERROR in sendWeatherToWatch: ' + error.toString());
     }
   }
 
-  // --- 3. Weather Mapping ---
-  function weatherCodeToString(code) {
-    // Open-Meteo WMO Weather interpretation codes (WW)
-    // https://open-meteo.com/en/docs
-    
-    if (code === 0) return 'Clear Sky';
-    if (code === 1) return 'Mainly Clear';
-    if (code === 2) return 'Partly Cloudy';
-    if (code === 3) return 'Overcast';
-    
-    if (code === 45) return 'Fog';
-    if (code === 48) return 'Depositing Rime';
-    
-    if (code === 51) return 'Light Drizzle';
-    if (code === 53) return 'Moderate Drizzle';
-    if (code === 55) return 'Dense Drizzle';
-    if (code === 56) return 'Light Freezing Drizzle';
-    if (code === 57) return 'Dense Freezing Drizzle';
-    
-    if (code === 61) return 'Slight Rain';
-    if (code === 63) return 'Moderate Rain';
-    if (code === 65) return 'Heavy Rain';
-    if (code === 66) return 'Light Freezing Rain';
-    if (code === 67) return 'Heavy Freezing Rain';
-    
-    if (code === 71) return 'Slight Snow';
-    if (code === 73) return 'Moderate Snow';
-    if (code === 75) return 'Heavy Snow';
-    if (code === 77) return 'Snow Grains';
-    
-    if (code === 80) return 'Slight Rain Showers';
-    if (code === 81) return 'Moderate Rain Showers';
-    if (code === 82) return 'Violent Rain Showers';
-    if (code === 85) return 'Slight Snow Showers';
-    if (code === 86) return 'Heavy Snow Showers';
-    
-    if (code === 95) return 'Thunderstorm';
-    if (code === 96) return 'Thunderstorm w/ Slight Hail';
-    if (code === 99) return 'Thunderstorm w/ Heavy Hail';
-    
-    return 'Unknown (' + code + ')';
-  }
-
   // --- 3.5. Reverse Geocoding (NEW: Using Nominatim for better accuracy) ---
   function reverseGeocode(lat, lon, callback) {
     // Use Nominatim (OpenStreetMap) for more detailed, local results
@@ -409,13 +356,111 @@ Pebble.addEventListener('ready', function(e) {
     xhr.send();
   }
 
+  // --- 3.6. Fetch Scheduling ---
+  function loadSchedule() {
+    var saved = null;
+    try {
+      saved = JSON.parse(localStorage.getItem(SCHEDULE_KEY));
+    } catch (e) {
+      console.log('[JS] Ignoring unreadable fetch schedule');
+    }
+    fetchScheduler = new Scheduler(saved);
+  }
+
+  // Arm the timer for the scheduler's next fetch, replacing any earlier one.
+  // notBefore, if given, holds it back until then.
+  function scheduleNextFetch(notBefore) {
+    var now = Date.now();
+    nextFetchTime = Math.max(fetchScheduler.nextFetchTime(now), notBefore || 0);
+    if (fetchTimer) {
+      clearTimeout(fetchTimer);
+    }
+    fetchTimer = setTimeout(function() {
+      fetchTimer = null;
+      updatePressure();
+    }, nextFetchTime - now);
+    console.log('[JS] Next fetch in ' + Math.round((nextFetchTime - now) / 1000) + ' s');
+  }
+
+  // The watch changed power mode: move the next fetch and tell the watch when
+  // it is, unless a fetch is under way and will do both when it finishes
+  function setLowPower(lowPower) {
+    if (!fetchScheduler.setLowPower(lowPower)) return;
+    console.log('[JS] Watch low power mode ' + (lowPower ? 'on' : 'off'));
+    if (fetchPending) return;
+    scheduleNextFetch();
+    if (lastWeatherData) {
+      var data = {};
+      for (var field in lastWeatherData) {
+        data[field] = lastWeatherData[field];
+      }
+      data.settings = settings;
+      data.nextFetch = secondsUntilNextFetch();
+      sendWeatherRecord(data, 'Schedule');
+    }
+  }
+
+  function secondsUntilNextFetch() {
+    return Math.max(0, Math.round((nextFetchTime - Date.now()) / 1000));
+  }
+
+  // A failed XHR can report through more than one handler; only the first
+  // result of each fetch counts
+  function fetchSucceeded(pressure) {
+    if (!fetchPending) return;
+    fetchPending = false;
+    clearTimeout(fetchWatchdog);
+    fetchScheduler.recordSuccess(pressure, Date.now());
+    localStorage.setItem(SCHEDULE_KEY, JSON.stringify(fetchScheduler));
+    scheduleNextFetch();
+  }
+
+  function fetchFailed() {
+    if (!fetchPending) return;
+    fetchPending = false;
+    clearTimeout(fetchWatchdog);
+    fetchScheduler.recordFailure(Date.now());
+    scheduleNextFetch();
+  }
+
+  // Answered from a cache entry still fresh: the scheduler already has its
+  // reading, and nothing new can be fetched before the next slot is out
+  function fetchAnsweredFromCache(entry) {
+    if (!fetchPending) return;
+    fetchPending = false;
+    clearTimeout(fetchWatchdog);
+    scheduleNextFetch(entry.slotEnd + Scheduler.SLOT_DELAY_MS);
+  }
+
+  function sendCachedWeather(entry, locationName) {
+    var r = entry.readings;
+    sendWeatherToWatch(r.pressure, r.temperature, r.weatherCode, r.humidity, r.wind, r.precipitation, r.trend,
+                       locationName, true, entry.timeline);
+  }
+
   // --- 4. Fetch Function (No Promises) ---
   function fetchPressureFromOpenMeteo(lat, lon, locationName) {
-    // Build API URL to get current data for temperature/pressure/wind, 15-minute forecast for conditions, daily for rainfall
+    // Nothing new upstream until the next model slot: answer from the cache.
+    // Older readings are shown straight away and then revalidated.
+    var now = Date.now();
+    var cached = weatherCache.get(lat, lon, now);
+    if (cached && weatherCache.isFresh(cached, now)) {
+      console.log('[JS] Open-Meteo slot unchanged, using cached readings');
+      fetchAnsweredFromCache(cached);
+      sendCachedWeather(cached, locationName);
+      return;
+    }
+    if (cached) {
+      sendCachedWeather(cached, locationName);
+    }
+
+    // Build API URL to get current data for temperature/pressure/wind, 15-minute forecast for conditions, daily for rainfall,
+    // plus the next hours in 15-minute then hourly steps for the watch to move through on its own
     var url = 'https://api.open-meteo.com/v1/forecast?latitude=' + encodeURIComponent(lat) + '&longitude=' + encodeURIComponent(lon) + 
               '&current=temperature_2m,relative_humidity_2m,wind_speed_10m,surface_pressure' + // Current conditions
-              '&minutely_15=weather_code&forecast_minutely_15=1' + // 15-min forecast for conditions only
-              '&daily=precipitation_sum&forecast_days=1' + // Daily accumulated rainfall
+              '&minutely_15=weather_code,temperature_2m&forecast_minutely_15=17' + // Now and the next 4 hours
+              '&hourly=weather_code,temperature_2m&forecast_hours=12' + // Hourly after that
+              '&daily=precipitation_sum&forecast_days=2' + // Daily accumulated rainfall, today and tomorrow
               '&timeformat=unixtime&timezone=auto';
     
     console.log('[JS] Fetching Open-Meteo: ' + url);
@@ -435,12 +480,12 @@ Pebble.addEventListener('ready', function(e) {
           console.log('[JS] Open-Meteo JSON received and parsed.');
 
           var currentTemp = undefined;
-          var currentCondition = undefined;
+          var weatherCode = undefined;
           var humidity = undefined;
           var windSpeed = undefined;
           var precipitation = undefined;
           var pressure = undefined;
-          var trendStr = undefined;
+          var trend = undefined;
 
           console.log('[JS] Using current data for temperature/pressure/wind, 15-minute forecast for conditions, daily for rainfall');
           
@@ -464,8 +509,9 @@ Pebble.addEventListener('ready', function(e) {
           
           // Extract weather conditions from 15-minute forecast (next 15 minutes)
           if (data.minutely_15 && data.minutely_15.weather_code && data.minutely_15.weather_code.length > 0) {
-            currentCondition = weatherCodeToString(data.minutely_15.weather_code[0]);
-            console.log('[JS] 15-minute forecast conditions: ' + currentCondition);
+            // The watch maps the WMO code to text
+            weatherCode = data.minutely_15.weather_code[0];
+            console.log('[JS] 15-minute forecast weather code: ' + weatherCode);
           }
             
             // Extract daily accumulated rainfall
@@ -474,27 +520,45 @@ Pebble.addEventListener('ready', function(e) {
               console.log('[JS] Daily accumulated rainfall: ' + precipitation + ' mm');
             }
           
-          sendWeatherToWatch(pressure, currentTemp, currentCondition, humidity, windSpeed, precipitation, trendStr, locationName);
+          var timeline = ForecastTimeline.build(data, Math.floor(Date.now() / 1000));
+          var slot = data.current || {};
+          weatherCache.put(lat, lon, {
+            pressure: pressure,
+            temperature: currentTemp,
+            weatherCode: weatherCode,
+            humidity: humidity,
+            wind: windSpeed,
+            precipitation: precipitation,
+            trend: trend
+          }, timeline, slot.time, slot.interval, Date.now());
+
+          fetchSucceeded(pressure);
+          sendWeatherToWatch(pressure, currentTemp, weatherCode, humidity, windSpeed, precipitation, trend, locationName,
+                             false, timeline);
           
         } catch (ex) {
           console.log('[JS] Error parsing Open-Meteo response: ' + ex);
-          sendWeatherToWatch(1013, 20, 'Parse Error', undefined, undefined, undefined, undefined, locationName); // Send specific error
+          fetchFailed();
+          sendStatusToWatch(WeatherRecord.STATUS.PARSE_ERROR, 0, locationName); // Send specific error
         }
       } else {
         // FAILURE (status 0, 404, 500, etc.)
         console.log('[JS] Open-Meteo fetch failed: HTTP status ' + xhr.status + ' -- sending fallback');
-        sendWeatherToWatch(1013, 20, 'HTTP Fail ' + xhr.status, undefined, undefined, undefined, undefined, locationName); // Send specific error
+        fetchFailed();
+        sendStatusToWatch(WeatherRecord.STATUS.HTTP_FAIL, xhr.status, locationName); // Send specific error
       }
     };
 
     xhr.ontimeout = function() {
       console.log('[JS] XHR TIMEOUT after ' + xhr.timeout + 'ms url=' + url);
-      sendWeatherToWatch(1013, 20, 'Timeout', undefined, undefined, undefined, undefined, locationName); // Send specific error
+      fetchFailed();
+      sendStatusToWatch(WeatherRecord.STATUS.TIMEOUT, 0, locationName); // Send specific error
     };
 
     xhr.onerror = function(e) {
       console.log('[JS] XHR ERROR url=' + url);
-      sendWeatherToWatch(1013, 20, 'Net Error', undefined, undefined, undefined, undefined, locationName); // Send specific error
+      fetchFailed();
+      sendStatusToWatch(WeatherRecord.STATUS.NET_ERROR, 0, locationName); // Send specific error
     };
     
     xhr.open('GET', url, true);
@@ -506,6 +570,11 @@ Pebble.addEventListener('ready', function(e) {
   var DEFAULT_LON = -0.1278;
 
   function updatePressure() {
+    fetchPending = true;
+    fetchWatchdog = setTimeout(function() {
+      console.log('[JS] Fetch gave no result after ' + FETCH_WATCHDOG_MS / 1000 + ' s');
+      fetchFailed();
+    }, FETCH_WATCHDOG_MS);
     if (navigator.geolocation) {
       navigator.geolocation.getCurrentPosition(
         function(position) {
@@ -513,8 +582,18 @@ Pebble.addEventListener('ready', function(e) {
           var lon = position.coords.longitude;
           console.log('[JS] Geolocation success: lat=' + lat + ' lon=' + lon);
           
+          var cachedName = placeCache.lookup(lat, lon, Date.now());
+          if (cachedName) {
+            console.log('[JS] Place name from cache: ' + cachedName);
+            fetchPressureFromOpenMeteo(lat, lon, cachedName);
+            return;
+          }
+
           // CORRECT: The weather fetch is now INSIDE the callback.
           reverseGeocode(lat, lon, function(locationName) {
+            if (locationName !== 'Unknown') {
+              placeCache.store(lat, lon, locationName, Date.now());
+            }
             fetchPressureFromOpenMeteo(lat, lon, locationName);
           });
         },
@@ -530,11 +609,19 @@ Pebble.addEventListener('ready', function(e) {
     }
   }
 
-  // Initial immediate update
-  updatePressure();
+  Pebble.addEventListener('appmessage', function(e) {
+    var payload = e.payload || {};
+    var mode = 'POWER_MODE' in payload ? payload.POWER_MODE : payload[POWER_MODE_KEY];
+    if (typeof mode !== 'undefined') {
+      setLowPower(mode === 1 || mode === true);
+    }
+  });
 
-  // Then refresh periodically
-  setInterval(updatePressure, 15 * 60 * 1000);
+  // Initial immediate update; each result then schedules the next fetch
+  loadSchedule();
+  placeCache = new PlaceCache(localStorage);
+  weatherCache = new WeatherCache(localStorage);
+  updatePressure();
 });
 
 // --- Settings Event Handlers ---
@@ -633,6 +720,14 @@ button{padding:12px 25px;font-size:16px;border:none;border-radius:6px;cursor:poi
 </div>
 <div class="description">Get vibration alerts and watch warnings when barometric pressure drops -3mb in 3 hours, indicating potential severe weather</div>
 </div>
+<div class="setting-group">
+<div class="setting-label">Battery Saver</div>
+<div class="radio-option">
+<input type="checkbox" id="power_save" name="power_save" ${settings.power_save ? 'checked' : ''}>
+<label for="power_save">Always save power on battery</label>
+</div>
+<div class="description">The watch saves power by itself below 20% battery: weather is fetched hourly, step count and update progress pause until the next fetch. This keeps it on whatever the charge; charging always ends it</div>
+</div>
 <div class="button-group">
 <div class="button-group">
 <button type="submit" class="save-btn">Save Settings</button>
@@ -651,7 +746,8 @@ document.getElementById('settingsForm').addEventListener('submit', function(e) {
     update_countdown: document.getElementById('update_countdown').checked,
     show_steps: document.getElementById('show_steps').checked,
     step_unit: document.querySelector('input[name="step_unit"]:checked').value,
-    storm_warning: document.getElementById('storm_warning').checked
+    storm_warning: document.getElementById('storm_warning').checked,
+    power_save: document.getElementById('power_save').checked
   };
   document.location = 'pebblejs://close#' + encodeURIComponent(JSON.stringify(settings));
 });
@@ -673,6 +769,7 @@ Pebble.addEventListener('webviewclosed', function(e) {
       var newSettings = JSON.parse(decodeURIComponent(e.response));
       console.log('[JS] Received new settings: ' + JSON.stringify(newSettings));
       console.log('[JS] Old settings: ' + JSON.stringify(settings));
+      var oldSettings = JSON.stringify(settings);
       
       // Update settings
       if (newSettings.temperature_unit) settings.temperature_unit = newSettings.temperature_unit;
@@ -708,25 +805,26 @@ Pebble.addEventListener('webviewclosed', function(e) {
       } else {
         console.log('[JS] storm_warning not found in new settings');
       }
+      if (typeof newSettings.power_save !== 'undefined') {
+        console.log('[JS] Updating power_save from ' + settings.power_save + ' to ' + newSettings.power_save);
+        settings.power_save = newSettings.power_save;
+      } else {
+        console.log('[JS] power_save not found in new settings');
+      }
       
       console.log('[JS] Updated settings: ' + JSON.stringify(settings));
-      
-      // Save settings
+
+      if (JSON.stringify(settings) === oldSettings) {
+        console.log('[JS] Settings unchanged, nothing to send');
+        return;
+      }
+
+      // The send queue retries the record until the watch has it, and a
+      // later change replaces it while it waits
+      settingsVersion = (settingsVersion + 1) & 0xFFFF;
       saveSettings();
-      
-      // Send a test message with new units to verify they work
-      console.log('[JS] Testing units: temp=' + getTemperatureLabel() + ', wind=' + getWindLabel() + ', precip=' + getPrecipitationLabel());
-      
-      // Immediately resend last weather data with new units
-      console.log('[JS] Units changed - resending weather data with new units...');
       resendWeatherWithCurrentUnits();
       
-      // Also refresh real weather data after a short delay
-      console.log('[JS] Settings updated, refreshing weather data in 2 seconds...');
-      setTimeout(function() {
-        updatePressure();
-      }, 2000);
-      
     } catch (ex) {
       console.log('[JS] Error parsing settings response: ' + ex);
       console.log('[JS] Raw response: ' + e.response);
@@ -0,0 +1,107 @@
+// Packs the forecast for the hours after a fetch into the byte array the
+// watch decodes in src/c/forecast_timeline.c. The two files must agree on the
+// layout - see the comment in src/c/forecast_timeline.h.
+
+var VERSION = 1;
+var HEADER_SIZE = 6;
+var ENTRY_SIZE = 6;
+var MAX_ENTRIES = 24;
+var MAX_SIZE = HEADER_SIZE + MAX_ENTRIES * ENTRY_SIZE;
+
+var QUARTER_HOUR = 15 * 60;
+var MINUTELY_SECONDS = 4 * 60 * 60; // 15-minute steps this far ahead, hourly after
+
+function isSet(value) {
+  return typeof value === 'number' && !isNaN(value);
+}
+
+// Today's total for the day containing t, from Open-Meteo's daily arrays
+function dayPrecipitation(daily, t) {
+  var total;
+  if (daily && daily.time && daily.precipitation_sum) {
+    for (var i = 0; i < daily.time.length && daily.time[i] <= t; i++) {
+      total = daily.precipitation_sum[i];
+    }
+  }
+  return total;
+}
+
+// Entries { time, weatherCode, temperature, precipitation } for the slots
+// after nowSeconds, from an Open-Meteo response requested with
+// timeformat=unixtime and minutely_15/hourly weather_code,temperature_2m.
+function build(data, nowSeconds) {
+  var entries = [];
+  var last = nowSeconds;
+
+  function add(series, i) {
+    var t = series.time[i];
+    var code = series.weather_code ? series.weather_code[i] : undefined;
+    var temp = series.temperature_2m ? series.temperature_2m[i] : undefined;
+    if (t <= last || !isSet(code) || !isSet(temp) || entries.length >= MAX_ENTRIES) {
+      return;
+    }
+    var precip = dayPrecipitation(data.daily, t);
+    entries.push({
+      time: t,
+      weatherCode: code,
+      temperature: temp,
+      precipitation: isSet(precip) ? precip : 0
+    });
+    last = t;
+  }
+
+  var i;
+  var minutely = data.minutely_15;
+  if (minutely && minutely.time) {
+    for (i = 0; i < minutely.time.length && minutely.time[i] <= nowSeconds + MINUTELY_SECONDS; i++) {
+      add(minutely, i);
+    }
+  }
+  var hourly = data.hourly;
+  if (hourly && hourly.time) {
+    for (i = 0; i < hourly.time.length; i++) {
+      add(hourly, i);
+    }
+  }
+  return entries;
+}
+
+function pushU16(bytes, value) {
+  bytes.push(value & 0xFF, (value >> 8) & 0xFF);
+}
+
+// Serialise entries from build(). Returns an array of byte values for
+// Pebble.sendAppMessage, or null if there is nothing to send.
+function pack(entries) {
+  if (!entries.length) {
+    return null;
+  }
+  var start = entries[0].time;
+  var bytes = [VERSION];
+  pushU16(bytes, start & 0xFFFF);
+  pushU16(bytes, Math.floor(start / 0x10000) & 0xFFFF);
+  bytes.push(0);
+
+  var count = 0;
+  for (var i = 0; i < entries.length && count < MAX_ENTRIES; i++) {
+    var entry = entries[i];
+    var offset = Math.round((entry.time - start) / QUARTER_HOUR);
+    if (offset > 0xFF) {
+      break;
+    }
+    bytes.push(offset, Math.max(0, Math.min(0xFF, entry.weatherCode)));
+    pushU16(bytes, Math.max(-0x8000, Math.min(0x7FFF, Math.round(entry.temperature * 10))) & 0xFFFF);
+    pushU16(bytes, Math.max(0, Math.min(0xFFFF, Math.round(entry.precipitation * 10))));
+    count++;
+  }
+  bytes[5] = count;
+  return bytes;
+}
+
+module.exports = {
+  VERSION: VERSION,
+  MAX_ENTRIES: MAX_ENTRIES,
+  MAX_SIZE: MAX_SIZE,
+  build: build,
+  pack: pack
+};
@@ -0,0 +1,110 @@
+// Place names from reverse geocoding, cached in localStorage by geohash cell.
+// The wearer is usually within a few hundred metres of where they were last
+// time, so most refreshes can skip Nominatim (and its rate limit) entirely.
+
+var STORAGE_KEY = 'just_weather_places';
+
+var PRECISION = 7;                        // Geohash cells of about 150 x 150 m
+var MOVE_THRESHOLD_M = 300;               // Reuse a nearby name across cell edges
+var TTL_MS = 7 * 24 * 60 * 60 * 1000;     // Place names change rarely
+var MAX_ENTRIES = 32;
+
+var BASE32 = '0123456789bcdefghjkmnpqrstuvwxyz';
+
+// Standard geohash of lat/lon to the given number of characters
+function geohash(lat, lon, precision) {
+  var latRange = [-90, 90];
+  var lonRange = [-180, 180];
+  var hash = '';
+  var bits = 0;
+  var bitCount = 0;
+  var evenBit = true;
+  while (hash.length < precision) {
+    var range = evenBit ? lonRange : latRange;
+    var value = evenBit ? lon : lat;
+    var mid = (range[0] + range[1]) / 2;
+    bits <<= 1;
+    if (value >= mid) {
+      bits |= 1;
+      range[0] = mid;
+    } else {
+      range[1] = mid;
+    }
+    evenBit = !evenBit;
+    if (++bitCount === 5) {
+      hash += BASE32.charAt(bits);
+      bits = 0;
+      bitCount = 0;
+    }
+  }
+  return hash;
+}
+
+// Great-circle distance in metres
+function distanceM(lat1, lon1, lat2, lon2) {
+  var rad = Math.PI / 180;
+  var dLat = (lat2 - lat1) * rad;
+  var dLon = (lon2 - lon1) * rad;
+  var a = Math.sin(dLat / 2) * Math.sin(dLat / 2) +
+          Math.cos(lat1 * rad) * Math.cos(lat2 * rad) * Math.sin(dLon / 2) * Math.sin(dLon / 2);
+  return 6371000 * 2 * Math.atan2(Math.sqrt(a), Math.sqrt(1 - a));
+}
+
+// storage: localStorage, or anything with the same getItem/setItem
+function PlaceCache(storage) {
+  this.storage = storage;
+  this.entries = {}; // geohash -> { name, lat, lon, time }
+  try {
+    this.entries = JSON.parse(storage.getItem(STORAGE_KEY)) || {};
+  } catch (e) {
+    this.entries = {};
+  }
+}
+
+// Cached name for the position, or null if it needs geocoding
+PlaceCache.prototype.lookup = function(lat, lon, now) {
+  var entry = this.entries[geohash(lat, lon, PRECISION)];
+  if (entry && now - entry.time < TTL_MS) {
+    return entry.name;
+  }
+  // Just over a cell edge from a known place still counts as there
+  var best = null;
+  var bestDistance = MOVE_THRESHOLD_M;
+  for (var hash in this.entries) {
+    var candidate = this.entries[hash];
+    if (now - candidate.time >= TTL_MS) {
+      continue;
+    }
+    var distance = distanceM(lat, lon, candidate.lat, candidate.lon);
+    if (distance < bestDistance) {
+      best = candidate;
+      bestDistance = distance;
+    }
+  }
+  return best ? best.name : null;
+};
+
+PlaceCache.prototype.store = function(lat, lon, name, now) {
+  this.entries[geohash(lat, lon, PRECISION)] = { name: name, lat: lat, lon: lon, time: now };
+
+  // Drop expired entries, then the oldest ones over the limit
+  var hashes = [];
+  for (var hash in this.entries) {
+    if (now - this.entries[hash].time >= TTL_MS) {
+      delete this.entries[hash];
+    } else {
+      hashes.push(hash);
+    }
+  }
+  var entries = this.entries;
+  hashes.sort(function(a, b) { return entries[a].time - entries[b].time; });
+  while (hashes.length > MAX_ENTRIES) {
+    delete entries[hashes.shift()];
+  }
+  this.storage.setItem(STORAGE_KEY, JSON.stringify(entries));
+};
+
+PlaceCache.geohash = geohash;
+PlaceCache.distanceM = distanceM;
+
+module.exports = PlaceCache;
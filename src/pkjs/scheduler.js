@@ -0,0 +1,122 @@
+// Decides when the companion fetches the weather next. Open-Meteo refreshes
+// its current conditions in 15-minute slots, so regular fetches land just
+// after a slot opens and never twice in one slot. How many slots to skip
+// depends on how fast the pressure is moving; failed fetches are retried on
+// a backoff instead of waiting for the next slot. While the watch is in
+// low-power mode, regular fetches are at least an hour apart.
+
+var SLOT_MS = 15 * 60 * 1000;
+var SLOT_DELAY_MS = 60 * 1000; // Give Open-Meteo a minute to publish a new slot
+
+// Regular interval by pressure change over the last HISTORY_MS, in hPa
+var HISTORY_MS = 3 * 60 * 60 * 1000;
+var INTERVALS = [
+  { minChange: 3, intervalMs: 15 * 60 * 1000 },  // Front moving through
+  { minChange: 1, intervalMs: 30 * 60 * 1000 },
+  { minChange: 0, intervalMs: 60 * 60 * 1000 }   // Settled weather
+];
+// Until there is enough history to judge, fetch every slot
+var UNKNOWN_INTERVAL_MS = 15 * 60 * 1000;
+var MIN_HISTORY_MS = 30 * 60 * 1000;
+
+// Shortest regular interval while the watch saves power
+var LOW_POWER_INTERVAL_MS = 60 * 60 * 1000;
+
+var RETRY_BASE_MS = 60 * 1000;
+var RETRY_MAX_MS = 30 * 60 * 1000;
+
+// saved: the object from toJSON() of an earlier Scheduler, if any
+function Scheduler(saved) {
+  this.history = [];      // [time, pressure] of successful fetches, oldest first
+  this.lastSuccess = 0;
+  this.failures = 0;      // Consecutive failed fetches
+  this.lastFailure = 0;
+  this.lowPower = false;  // As last reported by the watch; not saved
+  if (saved && saved.history instanceof Array) {
+    this.history = saved.history;
+    this.lastSuccess = saved.lastSuccess || 0;
+  }
+}
+
+Scheduler.prototype.recordSuccess = function(pressure, now) {
+  this.lastSuccess = now;
+  this.failures = 0;
+  if (typeof pressure === 'number' && !isNaN(pressure)) {
+    this.history.push([now, pressure]);
+  }
+  while (this.history.length && now - this.history[0][0] > HISTORY_MS) {
+    this.history.shift();
+  }
+};
+
+Scheduler.prototype.recordFailure = function(now) {
+  this.failures++;
+  this.lastFailure = now;
+};
+
+// Largest pressure swing in the history, or -1 if it spans too little time
+Scheduler.prototype.pressureChange = function() {
+  var history = this.history;
+  if (history.length < 2 || history[history.length - 1][0] - history[0][0] < MIN_HISTORY_MS) {
+    return -1;
+  }
+  var min = history[0][1];
+  var max = min;
+  for (var i = 1; i < history.length; i++) {
+    min = Math.min(min, history[i][1]);
+    max = Math.max(max, history[i][1]);
+  }
+  return max - min;
+};
+
+// Returns whether the mode changed, i.e. the next fetch time may have moved
+Scheduler.prototype.setLowPower = function(lowPower) {
+  lowPower = !!lowPower;
+  if (lowPower === this.lowPower) {
+    return false;
+  }
+  this.lowPower = lowPower;
+  return true;
+};
+
+Scheduler.prototype.intervalMs = function() {
+  var interval = UNKNOWN_INTERVAL_MS;
+  var change = this.pressureChange();
+  for (var i = 0; change >= 0 && i < INTERVALS.length; i++) {
+    if (change >= INTERVALS[i].minChange) {
+      interval = INTERVALS[i].intervalMs;
+      break;
+    }
+  }
+  return this.lowPower ? Math.max(interval, LOW_POWER_INTERVAL_MS) : interval;
+};
+
+// First slot publish time at or after t
+function alignToSlot(t) {
+  return Math.ceil((t - SLOT_DELAY_MS) / SLOT_MS) * SLOT_MS + SLOT_DELAY_MS;
+}
+
+// Time (ms since the epoch) of the next fetch
+Scheduler.prototype.nextFetchTime = function(now) {
+  if (this.failures > 0) {
+    var backoff = Math.min(RETRY_BASE_MS * Math.pow(2, this.failures - 1), RETRY_MAX_MS);
+    return Math.max(now, this.lastFailure + backoff);
+  }
+  if (!this.lastSuccess) {
+    return now;
+  }
+  // Count the interval in slots from the one we already have. Data older than
+  // that is overdue, and the current slot is newer than it: fetch now.
+  var slots = Math.max(1, Math.round(this.intervalMs() / SLOT_MS));
+  var due = alignToSlot(this.lastSuccess + 1) + (slots - 1) * SLOT_MS;
+  return Math.max(due, now);
+};
+
+Scheduler.prototype.toJSON = function() {
+  return { history: this.history, lastSuccess: this.lastSuccess };
+};
+
+Scheduler.SLOT_MS = SLOT_MS;
+Scheduler.SLOT_DELAY_MS = SLOT_DELAY_MS;
+
+module.exports = Scheduler;
@@ -0,0 +1,157 @@
+// Sends AppMessages to the watch one at a time. A NACK, or no answer at all
+// within TIMEOUT_MS, is retried after 1, 2, 4... seconds, and the message is
+// given up after MAX_ATTEMPTS. Each message has a key (e.g. 'record'): a new
+// message pushed while an older one with the same key is still waiting for
+// its turn takes the older one's place, so the watch is only sent the
+// newest state. A message already tried is not replaced, so messages of
+// different keys keep their order.
+
+var TIMEOUT_MS = 15 * 1000;   // Pebble's own timeout NACKs well before this
+var RETRY_BASE_MS = 1000;
+var RETRY_MAX_MS = 30 * 1000;
+var MAX_ATTEMPTS = 6;
+var REPORT_INTERVAL_MS = 60 * 60 * 1000;
+
+// send(dict, ack, nack): Pebble.sendAppMessage, or a stand-in
+// options: log(text), and now/setTimeout/clearTimeout to drive it by hand
+function SendQueue(send, options) {
+  options = options || {};
+  this.send = send;
+  this.log = options.log || function() {};
+  this.now = options.now || Date.now;
+  this.setTimeout = options.setTimeout || setTimeout;
+  this.clearTimeout = options.clearTimeout || clearTimeout;
+  this.queue = [];         // { key, build, done: [], dict, attempts, queuedAt }, oldest first
+  this.sending = false;    // The head is in flight or waiting to be retried
+  this.stats = {
+    delivered: 0,
+    nacks: 0,
+    timeouts: 0,
+    dropped: 0,            // Given up after MAX_ATTEMPTS
+    replaced: 0,           // Superseded while waiting, never sent
+    totalLatencyMs: 0,     // Queued to acknowledged, over the delivered ones
+    maxLatencyMs: 0
+  };
+  this.lastReport = this.now();
+}
+
+// build() runs when the message's turn comes, so it can send the state as it
+// is then, and returns the dictionary to send or null if there is nothing to
+// send any more. done(delivered), if given, runs once the message - or one
+// that replaced it - is acknowledged, given up or found to be empty.
+SendQueue.prototype.push = function(key, build, done) {
+  for (var i = this.sending ? 1 : 0; i < this.queue.length; i++) {
+    var waiting = this.queue[i];
+    if (waiting.key === key) {
+      waiting.build = build;
+      if (done) waiting.done.push(done);
+      this.stats.replaced++;
+      return;
+    }
+  }
+  this.queue.push({ key: key, build: build, done: done ? [done] : [], dict: null, attempts: 0, queuedAt: this.now() });
+  this.next();
+};
+
+SendQueue.prototype.next = function() {
+  while (!this.sending && this.queue.length) {
+    var entry = this.queue[0];
+    entry.dict = entry.build();
+    if (!entry.dict) {
+      this.finish(entry, true);
+      continue;
+    }
+    this.sending = true;
+    this.attempt(entry);
+  }
+};
+
+SendQueue.prototype.attempt = function(entry) {
+  var self = this;
+  var settled = false;
+  var timer = null;
+  entry.attempts++;
+
+  // Pebble may answer late, after the timeout has already counted it
+  function settle(delivered, reason) {
+    if (settled) return;
+    settled = true;
+    self.clearTimeout(timer);
+    self.settle(entry, delivered, reason);
+  }
+
+  timer = this.setTimeout(function() {
+    settle(false, 'timeout');
+  }, TIMEOUT_MS);
+  try {
+    this.send(entry.dict, function() {
+      settle(true);
+    }, function() {
+      settle(false, 'nack');
+    });
+  } catch (e) {
+    settle(false, 'nack');
+  }
+};
+
+SendQueue.prototype.settle = function(entry, delivered, reason) {
+  var self = this;
+  if (delivered) {
+    var latency = this.now() - entry.queuedAt;
+    this.stats.delivered++;
+    this.stats.totalLatencyMs += latency;
+    this.stats.maxLatencyMs = Math.max(this.stats.maxLatencyMs, latency);
+    this.log(entry.key + ' delivered in ' + latency + ' ms' +
+             (entry.attempts > 1 ? ' after ' + entry.attempts + ' attempts' : ''));
+    this.complete(entry, true);
+    return;
+  }
+
+  if (reason === 'timeout') {
+    this.stats.timeouts++;
+  } else {
+    this.stats.nacks++;
+  }
+  if (entry.attempts >= MAX_ATTEMPTS) {
+    this.stats.dropped++;
+    this.log(entry.key + ' dropped after ' + entry.attempts + ' attempts; ' + this.summary());
+    this.complete(entry, false);
+    return;
+  }
+  var delay = Math.min(RETRY_BASE_MS * Math.pow(2, entry.attempts - 1), RETRY_MAX_MS);
+  this.log(entry.key + ' ' + reason + ', retrying in ' + delay + ' ms');
+  this.setTimeout(function() {
+    self.attempt(entry);
+  }, delay);
+};
+
+// The head is done with: move on to the next message
+SendQueue.prototype.complete = function(entry, delivered) {
+  this.sending = false;
+  this.finish(entry, delivered);
+  if (this.now() - this.lastReport >= REPORT_INTERVAL_MS) {
+    this.lastReport = this.now();
+    this.log('AppMessage ' + this.summary());
+  }
+  this.next();
+};
+
+SendQueue.prototype.finish = function(entry, delivered) {
+  this.queue.shift();
+  for (var i = 0; i < entry.done.length; i++) {
+    entry.done[i](delivered);
+  }
+};
+
+SendQueue.prototype.summary = function() {
+  var stats = this.stats;
+  var average = stats.delivered ? Math.round(stats.totalLatencyMs / stats.delivered) : 0;
+  return 'delivered ' + stats.delivered + ' (avg ' + average + ' ms, max ' + stats.maxLatencyMs + ' ms), ' +
+         stats.nacks + ' nacks, ' + stats.timeouts + ' timeouts, ' + stats.dropped + ' dropped, ' +
+         stats.replaced + ' replaced';
+};
+
+SendQueue.TIMEOUT_MS = TIMEOUT_MS;
+SendQueue.MAX_ATTEMPTS = MAX_ATTEMPTS;
+
+module.exports = SendQueue;
@@ -0,0 +1,65 @@
+// Open-Meteo readings cached in localStorage by position, with the model slot
+// they came from. Open-Meteo only changes its current conditions once per
+// 15-minute slot, so a refresh inside the slot a reading came from (after a
+// wake, say) is served from here with no network round trip. Readings from
+// an older slot are still worth showing while a fetch replaces them.
+
+var Scheduler = require('./scheduler');
+
+var STORAGE_KEY = 'just_weather_responses';
+
+var GRID_DEGREES = 0.01;  // ~1 km; Open-Meteo's model grid is coarser than this
+var MAX_ENTRIES = 8;
+var MAX_AGE_MS = 24 * 60 * 60 * 1000; // Too old to be worth showing at all
+
+function cellKey(lat, lon) {
+  return Math.round(lat / GRID_DEGREES) + ',' + Math.round(lon / GRID_DEGREES);
+}
+
+// storage: localStorage, or anything with the same getItem/setItem
+function WeatherCache(storage) {
+  this.storage = storage;
+  this.entries = {}; // cellKey -> { readings, timeline, fetched, slotEnd }
+  try {
+    this.entries = JSON.parse(storage.getItem(STORAGE_KEY)) || {};
+  } catch (e) {
+    this.entries = {};
+  }
+}
+
+// The cached entry for the position, or null
+WeatherCache.prototype.get = function(lat, lon, now) {
+  var entry = this.entries[cellKey(lat, lon)];
+  return entry && now - entry.fetched < MAX_AGE_MS ? entry : null;
+};
+
+// True until Open-Meteo publishes the slot after the entry's
+WeatherCache.prototype.isFresh = function(entry, now) {
+  return now < entry.slotEnd + Scheduler.SLOT_DELAY_MS;
+};
+
+// readings: the metric values sent to the watch; timeline: the forecast
+// entries that went with them. slotStart and slotSeconds are Open-Meteo's
+// current.time and current.interval, if it sent them.
+WeatherCache.prototype.put = function(lat, lon, readings, timeline, slotStart, slotSeconds, now) {
+  var slotEnd;
+  if (slotStart && slotSeconds) {
+    slotEnd = (slotStart + slotSeconds) * 1000;
+  } else {
+    slotEnd = (Math.floor(now / Scheduler.SLOT_MS) + 1) * Scheduler.SLOT_MS;
+  }
+  this.entries[cellKey(lat, lon)] = { readings: readings, timeline: timeline, fetched: now, slotEnd: slotEnd };
+
+  var entries = this.entries;
+  var keys = [];
+  for (var key in entries) {
+    keys.push(key);
+  }
+  keys.sort(function(a, b) { return entries[a].fetched - entries[b].fetched; });
+  while (keys.length > MAX_ENTRIES) {
+    delete entries[keys.shift()];
+  }
+  this.storage.setItem(STORAGE_KEY, JSON.stringify(entries));
+};
+
+module.exports = WeatherCache;
@@ -0,0 +1,263 @@
+// Packs weather readings and settings into the single byte-array record the
+// watch decodes in src/c/weather_record.c. The two files must agree on field
+// order, widths and bit assignments - see the layout comment in
+// src/c/weather_record.h.
+
+var VERSION = 1;
+var HEADER_SIZE = 4;
+var LOCATION_MAX = 31; // bytes of UTF-8, no terminator
+
+var FIELD = {
+  STATUS: 1 << 0,
+  PRESSURE: 1 << 1,
+  TREND: 1 << 2,
+  TEMPERATURE: 1 << 3,
+  HUMIDITY: 1 << 4,
+  WIND: 1 << 5,
+  PRECIP: 1 << 6,
+  CONDITION: 1 << 7,
+  UNITS: 1 << 8,
+  SETTINGS: 1 << 9,
+  LOCATION: 1 << 10,
+  NEXT_FETCH: 1 << 11,
+  SETTINGS_VERSION: 1 << 12
+};
+
+// Header flags
+var FLAG_FULL = 1 << 0;     // Complete state: the watch drops fields not in this record
+var FLAG_FETCHED = 1 << 1;  // Result of a new fetch: restarts the watch's update countdown
+
+var STATUS = {
+  OK: 0,
+  PARSE_ERROR: 1,
+  HTTP_FAIL: 2,
+  TIMEOUT: 3,
+  NET_ERROR: 4
+};
+
+var UNITS_FAHRENHEIT = 1 << 0;
+var UNITS_WIND_KPH = 1 << 1;
+var UNITS_PRECIP_INCHES = 1 << 2;
+
+var SETTING_HOURLY_VIBRATION = 1 << 0;
+var SETTING_UPDATE_COUNTDOWN = 1 << 1;
+var SETTING_SHOW_STEPS = 1 << 2;
+var SETTING_STEP_UNIT_MILES = 1 << 3;
+var SETTING_STORM_WARNING = 1 << 4;
+var SETTING_POWER_SAVE = 1 << 5;
+
+function isSet(value) {
+  return typeof value !== 'undefined' && value !== null && !(typeof value === 'number' && isNaN(value));
+}
+
+// Fixed-point helpers: round to the field's resolution and clamp to its width
+function clamp(value, min, max) {
+  return Math.max(min, Math.min(max, value));
+}
+
+function tenths(value) {
+  return Math.round(value * 10);
+}
+
+function pushU8(bytes, value) {
+  bytes.push(clamp(Math.round(value), 0, 0xFF));
+}
+
+function pushU16(bytes, value) {
+  var v = clamp(Math.round(value), 0, 0xFFFF);
+  bytes.push(v & 0xFF, (v >> 8) & 0xFF);
+}
+
+function pushS16(bytes, value) {
+  var v = clamp(Math.round(value), -0x8000, 0x7FFF) & 0xFFFF;
+  bytes.push(v & 0xFF, (v >> 8) & 0xFF);
+}
+
+// UTF-8 encode, truncated to maxBytes without splitting a character
+function utf8Bytes(text, maxBytes) {
+  var encoded = unescape(encodeURIComponent(String(text)));
+  var bytes = [];
+  for (var i = 0; i < encoded.length; i++) {
+    bytes.push(encoded.charCodeAt(i));
+  }
+  if (bytes.length > maxBytes) {
+    var cut = maxBytes;
+    // Back up over continuation bytes (10xxxxxx) to a character boundary
+    while (cut > 0 && (bytes[cut] & 0xC0) === 0x80) {
+      cut--;
+    }
+    bytes = bytes.slice(0, cut);
+  }
+  return bytes;
+}
+
+function unitsByte(settings) {
+  var units = 0;
+  if (settings.temperature_unit === 'fahrenheit') units |= UNITS_FAHRENHEIT;
+  if (settings.wind_unit === 'kph') units |= UNITS_WIND_KPH;
+  if (settings.precipitation_unit === 'inches') units |= UNITS_PRECIP_INCHES;
+  return units;
+}
+
+function settingsByte(settings) {
+  var flags = 0;
+  if (settings.hourly_vibration) flags |= SETTING_HOURLY_VIBRATION;
+  if (settings.update_countdown) flags |= SETTING_UPDATE_COUNTDOWN;
+  if (settings.show_steps) flags |= SETTING_SHOW_STEPS;
+  if (settings.step_unit === 'miles') flags |= SETTING_STEP_UNIT_MILES;
+  if (settings.storm_warning) flags |= SETTING_STORM_WARNING;
+  if (settings.power_save) flags |= SETTING_POWER_SAVE;
+  return flags;
+}
+
+// Field order on the wire, with each field's presence bit and width
+var LAYOUT = [
+  { name: 'status', bit: FIELD.STATUS },
+  { name: 'pressure', bit: FIELD.PRESSURE, write: pushS16 },
+  { name: 'trend', bit: FIELD.TREND, write: pushS16 },
+  { name: 'temperature', bit: FIELD.TEMPERATURE, write: pushS16 },
+  { name: 'humidity', bit: FIELD.HUMIDITY, write: pushU8 },
+  { name: 'wind', bit: FIELD.WIND, write: pushU16 },
+  { name: 'precipitation', bit: FIELD.PRECIP, write: pushU16 },
+  { name: 'weatherCode', bit: FIELD.CONDITION, write: pushU8 },
+  { name: 'units', bit: FIELD.UNITS, write: pushU8 },
+  { name: 'settings', bit: FIELD.SETTINGS, write: pushU8 },
+  { name: 'nextFetch', bit: FIELD.NEXT_FETCH, write: pushU16 },
+  { name: 'settingsVersion', bit: FIELD.SETTINGS_VERSION, write: pushU16 },
+  { name: 'location', bit: FIELD.LOCATION }
+];
+
+// Convert metric readings to the record's fixed-point wire values. Every
+// property is optional; only the ones present are encoded:
+//   status, statusDetail     STATUS.*, e.g. HTTP status for HTTP_FAIL
+//   pressure, trend          hPa
+//   temperature              degrees Celsius
+//   humidity                 percent
+//   wind                     km/h
+//   precipitation            mm
+//   weatherCode              WMO code
+//   settings                 the companion's settings object (units + toggles)
+//   settingsVersion          bumped each time settings changes; sent with it
+//   nextFetch                seconds until the companion fetches again
+//   location                 place name
+// Two readings that encode the same look the same on the watch, so deltas
+// are computed on encoded values.
+function encode(data) {
+  var encoded = {};
+  if (isSet(data.status)) encoded.status = [data.status, isSet(data.statusDetail) ? data.statusDetail : 0];
+  if (isSet(data.pressure)) encoded.pressure = tenths(data.pressure);
+  if (isSet(data.trend)) encoded.trend = tenths(data.trend);
+  if (isSet(data.temperature)) encoded.temperature = tenths(data.temperature);
+  if (isSet(data.humidity)) encoded.humidity = Math.round(data.humidity);
+  if (isSet(data.wind)) encoded.wind = tenths(data.wind);
+  if (isSet(data.precipitation)) encoded.precipitation = tenths(data.precipitation);
+  if (isSet(data.weatherCode)) encoded.weatherCode = data.weatherCode;
+  if (data.settings) {
+    encoded.units = unitsByte(data.settings);
+    encoded.settings = settingsByte(data.settings);
+    if (isSet(data.settingsVersion)) encoded.settingsVersion = data.settingsVersion & 0xFFFF;
+  }
+  if (isSet(data.nextFetch)) encoded.nextFetch = Math.round(data.nextFetch);
+  if (isSet(data.location)) encoded.location = utf8Bytes(data.location, LOCATION_MAX);
+  return encoded;
+}
+
+function sameValue(a, b) {
+  if (a instanceof Array && b instanceof Array) {
+    return a.join(',') === b.join(',');
+  }
+  return a === b;
+}
+
+var SETTINGS_GROUP = ['units', 'settings', 'settingsVersion'];
+
+// Fields of encoded whose value differs from (or is missing in) acked.
+// Versioned units and settings go as one group, keyed by the version: all
+// of them when the watch has not acknowledged that version, none when it has.
+function changes(encoded, acked) {
+  var changed = {};
+  var name;
+  for (name in encoded) {
+    if (!acked || !(name in acked) || !sameValue(encoded[name], acked[name])) {
+      changed[name] = encoded[name];
+    }
+  }
+  if ('settingsVersion' in encoded) {
+    var known = acked && acked.settingsVersion === encoded.settingsVersion;
+    for (var i = 0; i < SETTINGS_GROUP.length; i++) {
+      name = SETTINGS_GROUP[i];
+      if (known) {
+        delete changed[name];
+      } else if (name in encoded) {
+        changed[name] = encoded[name];
+      }
+    }
+  }
+  return changed;
+}
+
+// Copy of acked with the fields of update applied
+function merge(acked, update) {
+  var merged = {};
+  var name;
+  for (name in acked) merged[name] = acked[name];
+  for (name in update) merged[name] = update[name];
+  return merged;
+}
+
+function isEmpty(encoded) {
+  for (var name in encoded) {
+    return false;
+  }
+  return true;
+}
+
+// Serialise encoded fields (from encode() or changes()). flags is a
+// combination of FLAG_* values. Returns an array of byte values for
+// Pebble.sendAppMessage.
+function packEncoded(encoded, flags) {
+  var present = 0;
+  var body = [];
+  for (var i = 0; i < LAYOUT.length; i++) {
+    var field = LAYOUT[i];
+    if (!(field.name in encoded)) {
+      continue;
+    }
+    var value = encoded[field.name];
+    present |= field.bit;
+    if (field.name === 'status') {
+      pushU8(body, value[0]);
+      pushU16(body, value[1]);
+    } else if (field.name === 'location') {
+      body.push(value.length);
+      Array.prototype.push.apply(body, value);
+    } else {
+      field.write(body, value);
+    }
+  }
+
+  var header = [VERSION, flags || 0, present & 0xFF, (present >> 8) & 0xFF];
+  return header.concat(body);
+}
+
+function pack(data, flags) {
+  return packEncoded(encode(data), flags);
+}
+
+// Largest record pack() can produce: every field plus a full-length location
+var MAX_SIZE = HEADER_SIZE + 3 + 2 + 2 + 2 + 1 + 2 + 2 + 1 + 1 + 1 + 2 + 2 + 1 + LOCATION_MAX;
+
+module.exports = {
+  VERSION: VERSION,
+  FIELD: FIELD,
+  STATUS: STATUS,
+  FLAG_FULL: FLAG_FULL,
+  FLAG_FETCHED: FLAG_FETCHED,
+  MAX_SIZE: MAX_SIZE,
+  encode: encode,
+  changes: changes,
+  merge: merge,
+  isEmpty: isEmpty,
+  packEncoded: packEncoded,
+  pack: pack
+};
@@ -0,0 +1,187 @@
+// Host microbenchmarks for the watchface's hot paths.
+//
+// Compiles the real src/c/just_weather.c against the SDK stand-in and reports
+// wall time and stub-heap allocations per call for each handler. Absolute
+// numbers are for the build machine, not the watch; compare runs of the same
+// binary before and after a change.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wreturn-type" // the watch's main() relies on C99's implicit return
+#define main just_weather_main
+#include "../../src/c/just_weather.c"
+#undef main
+#pragma GCC diagnostic pop
+
+#include "companion.h"
+
+#define BENCH_DEFAULT_ITERATIONS 200000
+
+typedef struct BenchCase {
+  const char *name;
+  void (*setup)(void);
+  void (*run)(void);
+} BenchCase;
+
+static uint8_t s_msg_buffer[1024];
+static DictionaryIterator s_msg_iter;
+static struct tm s_tick_tm;
+
+// The "+change" cases alternate between two inputs, so every call redraws
+// something rather than finding it already on screen
+static uint8_t s_alt_buffer[1024];
+static DictionaryIterator s_alt_iter;
+static uint8_t s_alt_record[sizeof(COMPANION_WEATHER_RECORD)];
+static unsigned s_alternate;
+
+static uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// --- Cases --- //
+
+static void setup_inbox_weather(void) {
+  companion_weather_message(&s_msg_iter, s_msg_buffer, sizeof(s_msg_buffer));
+}
+
+static void run_inbox_weather(void) {
+  inbox_received_callback(&s_msg_iter, NULL);
+}
+
+// A fetch an hour later: 1014.7 hPa, 18.6 C and rain
+static void setup_inbox_weather_change(void) {
+  setup_inbox_weather();
+  memcpy(s_alt_record, COMPANION_WEATHER_RECORD, sizeof(s_alt_record));
+  s_alt_record[7] = 0xa3; // Pressure 0x27a3
+  s_alt_record[11] = 0xba; // Temperature 0x00ba
+  s_alt_record[19] = 61;   // WMO Slight Rain
+  companion_record_message(&s_alt_iter, s_alt_buffer, sizeof(s_alt_buffer), s_alt_record, sizeof(s_alt_record));
+}
+
+static void run_inbox_weather_change(void) {
+  inbox_received_callback(++s_alternate & 1 ? &s_alt_iter : &s_msg_iter, NULL);
+}
+
+static void setup_tick(void) {
+  s_show_steps_enabled = false;
+  s_tick_tm = (struct tm){ .tm_hour = 10, .tm_min = 42 };
+}
+
+static void setup_tick_steps(void) {
+  setup_tick();
+  s_show_steps_enabled = true;
+}
+
+static void run_tick(void) {
+  tick_handler(&s_tick_tm, MINUTE_UNIT);
+}
+
+static void run_tick_minute(void) {
+  s_tick_tm.tm_min = ++s_alternate & 1 ? 43 : 42;
+  tick_handler(&s_tick_tm, MINUTE_UNIT);
+}
+
+static void setup_step_display(void) {
+  s_show_steps_enabled = true;
+  stub_set_health_steps(8431);
+}
+
+static void run_step_display(void) {
+  update_step_display();
+}
+
+static void setup_step_refresh(void) {
+  setup_step_display();
+  s_current_step_count = 0;
+}
+
+static void run_step_refresh(void) {
+  // What a coalesced Health movement event costs: one query, plus a redraw
+  // when the count has moved far enough (it hasn't, after the first call)
+  refresh_steps(false);
+}
+
+static void run_step_refresh_change(void) {
+  stub_set_health_steps(++s_alternate & 1 ? 8431 + STEP_REDRAW_MIN_DELTA : 8431);
+  refresh_steps(false);
+}
+
+// The display lines an inbox message rebuilds, with every field present
+static void setup_display_lines(void) {
+  s_show_steps_enabled = false;
+  companion_weather_message(&s_msg_iter, s_msg_buffer, sizeof(s_msg_buffer));
+  inbox_received_callback(&s_msg_iter, NULL);
+}
+
+static void run_pressure_display(void) {
+  update_pressure_display();
+}
+
+static void run_conditions_display(void) {
+  update_conditions_display(false);
+}
+
+static void run_wind_precip_display(void) {
+  update_wind_precip_display();
+}
+
+static void setup_progress_draw(void) {
+  s_last_weather_update = time(NULL) - 7 * 60;
+}
+
+static void run_progress_draw(void) {
+  if (s_update_progress_layer) {
+    progress_layer_draw(s_update_progress_layer, stub_graphics_context());
+  }
+}
+
+static const BenchCase s_cases[] = {
+  { "inbox_received_callback", setup_inbox_weather, run_inbox_weather },
+  { "inbox_received_callback+change", setup_inbox_weather_change, run_inbox_weather_change },
+  { "tick_handler", setup_tick, run_tick },
+  { "tick_handler+steps", setup_tick_steps, run_tick },
+  { "tick_handler+steps+change", setup_tick_steps, run_tick_minute },
+  { "update_pressure_display", setup_display_lines, run_pressure_display },
+  { "update_conditions_display", setup_display_lines, run_conditions_display },
+  { "update_wind_precip_display", setup_display_lines, run_wind_precip_display },
+  { "update_step_display", setup_step_display, run_step_display },
+  { "health_movement_refresh", setup_step_refresh, run_step_refresh },
+  { "health_movement_refresh+change", setup_step_refresh, run_step_refresh_change },
+  { "progress_layer_draw", setup_progress_draw, run_progress_draw },
+};
+
+int main(int argc, char **argv) {
+  long iterations = argc > 1 ? strtol(argv[1], NULL, 10) : BENCH_DEFAULT_ITERATIONS;
+  if (iterations <= 0) {
+    iterations = BENCH_DEFAULT_ITERATIONS;
+  }
+
+  stub_set_time(1761820800); // 2025-10-30 10:40 UTC
+  stub_set_health_steps(8431);
+  init();
+
+  printf("%-32s %12s %12s %12s %12s %12s\n", "handler", "ns/op", "allocs/op", "texts/op", "dirty/op",
+         "draws/op");
+  for (size_t i = 0; i < sizeof(s_cases) / sizeof(s_cases[0]); i++) {
+    const BenchCase *bench = &s_cases[i];
+    bench->setup();
+    bench->run(); // warm up
+    stub_reset_stats();
+
+    uint64_t start = now_ns();
+    for (long n = 0; n < iterations; n++) {
+      bench->run();
+    }
+    uint64_t elapsed = now_ns() - start;
+
+    printf("%-32s %12.1f %12.3f %12.3f %12.3f %12.3f\n", bench->name,
+           (double)elapsed / iterations,
+           (double)g_stub_stats.allocs / iterations,
+           (double)g_stub_stats.text_sets / iterations,
+           (double)g_stub_stats.dirty_marks / iterations,
+           (double)g_stub_stats.draw_calls / iterations);
+  }
+
+  deinit();
+  return 0;
+}
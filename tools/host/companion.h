@@ -0,0 +1,63 @@
+// Builders for the AppMessages the phone companion (src/pkjs/app.js) sends.
+// Include after src/c/just_weather.c so the MESSAGE_KEY_* values match.
+#pragma once
+
+#include <pebble.h>
+
+// Output of src/pkjs/weather_record.js pack(data, FLAG_FULL | FLAG_FETCHED)
+// for the first weather update after launch: 1013.2 hPa, trend -0.8, 17.6 C,
+// 72 %, 14.5 km/h, 2.5 mm, WMO 2, default settings (C, mph, mm, countdown on,
+// miles), the next fetch in 15 minutes and "King's Lynn". Regenerate from the
+// JS packer if the record layout changes.
+static const uint8_t COMPANION_WEATHER_RECORD[] = {
+  0x01, 0x03, 0xff, 0x0f, 0x00, 0x00, 0x00, 0x94, 0x27, 0xf8, 0xff, 0xb0, 0x00, 0x48, 0x91, 0x00,
+  0x19, 0x00, 0x02, 0x00, 0x0a, 0x84, 0x03, 0x0b, 0x4b, 0x69, 0x6e, 0x67, 0x27, 0x73, 0x20, 0x4c,
+  0x79, 0x6e, 0x6e,
+};
+
+// The largest record pack() produces (WEATHER_RECORD_MAX_SIZE bytes): every
+// field, an HTTP_FAIL 504 status, every setting on, the next fetch in an hour,
+// settings version 1 and a location cut to 31 bytes.
+static const uint8_t COMPANION_MAX_RECORD[] = {
+  0x01, 0x03, 0xff, 0x1f, 0x02, 0xf8, 0x01, 0x94, 0x27, 0xf8, 0xff, 0xb0, 0x00, 0x48, 0x91, 0x00,
+  0x19, 0x00, 0x02, 0x00, 0x1f, 0x10, 0x0e, 0x01, 0x00, 0x1f, 0x4c, 0x6c, 0x61, 0x6e, 0x66, 0x61,
+  0x69, 0x72, 0x70, 0x77, 0x6c, 0x6c, 0x67, 0x77, 0x79, 0x6e, 0x67, 0x79, 0x6c, 0x6c, 0x2d, 0x67,
+  0x6f, 0x67, 0x65, 0x72, 0x79, 0x63, 0x68, 0x77, 0x79,
+};
+
+// Output of src/pkjs/forecast_timeline.js pack(build(data, 1761820800)) for
+// 15-minute steps to Slight Rain 15.0 C and Moderate Rain 14.5 C (2.5 mm
+// today), then Overcast 13.0 C on the hour, in a new day with 0.4 mm.
+static const uint8_t COMPANION_FORECAST_TIMELINE[] = {
+  0x01, 0x04, 0x44, 0x03, 0x69, 0x03, 0x00, 0x3d, 0x96, 0x00, 0x19, 0x00, 0x01, 0x3f, 0x91, 0x00,
+  0x19, 0x00, 0x03, 0x03, 0x82, 0x00, 0x04, 0x00,
+};
+
+static inline void companion_forecast_message(DictionaryIterator *iter, uint8_t *buffer, uint16_t size) {
+  dict_write_begin(iter, buffer, size);
+  dict_write_data(iter, MESSAGE_KEY_FORECAST_TIMELINE, COMPANION_FORECAST_TIMELINE, sizeof(COMPANION_FORECAST_TIMELINE));
+  dict_write_end(iter);
+}
+
+static inline void companion_record_message(DictionaryIterator *iter, uint8_t *buffer, uint16_t size,
+                                            const uint8_t *record, uint16_t record_size) {
+  dict_write_begin(iter, buffer, size);
+  dict_write_data(iter, MESSAGE_KEY_WEATHER_RECORD, record, record_size);
+  dict_write_end(iter);
+}
+
+// Mirrors sendWeatherToWatch(): every reading, the units and every setting.
+static inline void companion_weather_message(DictionaryIterator *iter, uint8_t *buffer, uint16_t size) {
+  companion_record_message(iter, buffer, size, COMPANION_WEATHER_RECORD, sizeof(COMPANION_WEATHER_RECORD));
+}
+
+// A units + settings only record, as sent after the settings page closes
+// with no readings cached on the phone.
+static inline void companion_settings_message(DictionaryIterator *iter, uint8_t *buffer, uint16_t size,
+                                              uint8_t units, uint8_t settings, uint16_t version) {
+  uint16_t present = WEATHER_FIELD_UNITS | WEATHER_FIELD_SETTINGS | WEATHER_FIELD_SETTINGS_VERSION;
+  const uint8_t record[] = {
+    WEATHER_RECORD_VERSION, 0, present & 0xFF, present >> 8, units, settings, version & 0xFF, version >> 8,
+  };
+  companion_record_message(iter, buffer, size, record, sizeof(record));
+}
@@ -0,0 +1,64 @@
+// Host memory-budget run of the watchface, built with MEMORY_TELEMETRY.
+//
+// Walks through startup, the largest record the companion can send, a
+// forecast timeline and the settings relayouts, logging each telemetry
+// sample, then prints the high-water marks next to the AppMessage buffer
+// sizes. Heap figures count the stub's own
+// allocations (layers, bitmaps), so they track changes in what the face
+// allocates rather than the SDK's exact object sizes; run the watch build with
+// MEMORY_TELEMETRY=1 for those.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wreturn-type" // the watch's main() relies on C99's implicit return
+#define main just_weather_main
+#include "../../src/c/just_weather.c"
+#undef main
+#pragma GCC diagnostic pop
+
+#include "companion.h"
+
+static uint8_t s_msg_buffer[1024];
+static DictionaryIterator s_msg_iter;
+
+static void deliver_record(const uint8_t *record, uint16_t size) {
+  companion_record_message(&s_msg_iter, s_msg_buffer, sizeof(s_msg_buffer), record, size);
+  stub_deliver_inbox(&s_msg_iter);
+}
+
+// Each save on the settings page is a new version; COMPANION_MAX_RECORD has 1
+static uint16_t s_settings_version = 1;
+
+static void deliver_settings(uint8_t settings) {
+  companion_settings_message(&s_msg_iter, s_msg_buffer, sizeof(s_msg_buffer), 0, settings, ++s_settings_version);
+  stub_deliver_inbox(&s_msg_iter);
+}
+
+int main(void) {
+  stub_set_log_echo(true);
+  stub_set_time(1761820800);
+  stub_set_health_steps(8431);
+  init();
+  stub_render_window(stub_top_window()); // First frame builds the progress strips
+
+  deliver_record(COMPANION_WEATHER_RECORD, sizeof(COMPANION_WEATHER_RECORD));
+  deliver_record(COMPANION_MAX_RECORD, sizeof(COMPANION_MAX_RECORD));
+  companion_forecast_message(&s_msg_iter, s_msg_buffer, sizeof(s_msg_buffer));
+  stub_deliver_inbox(&s_msg_iter);
+  deliver_settings(WEATHER_SETTING_STEP_UNIT_MILES);
+  deliver_settings(WEATHER_SETTING_UPDATE_COUNTDOWN | WEATHER_SETTING_SHOW_STEPS);
+
+  const MemoryTelemetry *telemetry = memory_telemetry_get();
+  uint32_t inbox_size = stub_inbox_size();
+  printf("\n%-22s %8s\n", "memory", "bytes");
+  printf("%-22s %8lu\n", "peak heap used", (unsigned long)telemetry->peak_used);
+  printf("%-22s %8lu\n", "min heap free", (unsigned long)telemetry->min_free);
+  printf("%-22s %8lu\n", "largest inbox message", (unsigned long)telemetry->largest_inbox);
+  printf("%-22s %8lu\n", "inbox buffer", (unsigned long)inbox_size);
+  printf("%-22s %8lu\n", "outbox buffer", (unsigned long)stub_outbox_size());
+
+  deinit();
+  if (telemetry->largest_inbox > inbox_size) {
+    fprintf(stderr, "largest message (%lu bytes) does not fit the inbox\n", (unsigned long)telemetry->largest_inbox);
+    return 1;
+  }
+  return 0;
+}
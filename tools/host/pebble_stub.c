@@ -0,0 +1,1397 @@
+// Host implementation of the pebble.h stand-in. See pebble.h for scope.
+#define PEBBLE_STUB_IMPLEMENTATION
+#include "pebble.h"
+
+StubStats g_stub_stats;
+
+static bool s_log_echo = false;
+static time_t s_now = 0;
+static bool s_24h_style = true;
+static HealthValue s_health_steps = -1;
+static BatteryChargeState s_battery = { 100, false, false };
+
+// --- Allocation accounting --- //
+
+// Every allocation carries a small header with its size so frees can be
+// subtracted from the live byte count.
+typedef struct AllocHeader {
+  size_t size;
+  size_t pad;
+} AllocHeader;
+
+void *stub_malloc(size_t size) {
+  AllocHeader *header = malloc(sizeof(AllocHeader) + size);
+  if (!header) {
+    return NULL;
+  }
+  header->size = size;
+  g_stub_stats.allocs++;
+  g_stub_stats.bytes_allocated += size;
+  g_stub_stats.bytes_live += size;
+  return header + 1;
+}
+
+void *stub_calloc(size_t count, size_t size) {
+  void *ptr = stub_malloc(count * size);
+  if (ptr) {
+    memset(ptr, 0, count * size);
+  }
+  return ptr;
+}
+
+void stub_free(void *ptr) {
+  if (!ptr) {
+    return;
+  }
+  AllocHeader *header = (AllocHeader *)ptr - 1;
+  g_stub_stats.frees++;
+  g_stub_stats.bytes_live -= header->size;
+  free(header);
+}
+
+void *stub_realloc(void *ptr, size_t size) {
+  if (!ptr) {
+    return stub_malloc(size);
+  }
+  AllocHeader *header = (AllocHeader *)ptr - 1;
+  void *copy = stub_malloc(size);
+  if (copy) {
+    memcpy(copy, ptr, header->size < size ? header->size : size);
+    stub_free(ptr);
+  }
+  return copy;
+}
+
+size_t heap_bytes_used(void) {
+  return g_stub_stats.bytes_live;
+}
+
+size_t heap_bytes_free(void) {
+  return g_stub_stats.bytes_live < STUB_HEAP_SIZE ? STUB_HEAP_SIZE - g_stub_stats.bytes_live : 0;
+}
+
+// --- Logging --- //
+
+void app_log(uint8_t log_level, const char *src_filename, int src_line_number, const char *fmt, ...) {
+  // Format even when not echoing so the benchmark pays the same formatting
+  // cost the watch does for every APP_LOG.
+  char buffer[256];
+  va_list args;
+  va_start(args, fmt);
+  vsnprintf(buffer, sizeof(buffer), fmt, args);
+  va_end(args);
+  g_stub_stats.logs++;
+  if (log_level <= APP_LOG_LEVEL_WARNING) {
+    g_stub_stats.warnings++;
+  }
+  if (s_log_echo) {
+    fprintf(stderr, "[%u] %s:%d> %s\n", log_level, src_filename, src_line_number, buffer);
+  }
+}
+
+// --- Geometry --- //
+
+bool grect_equal(const GRect *const rect_a, const GRect *const rect_b) {
+  return rect_a->origin.x == rect_b->origin.x && rect_a->origin.y == rect_b->origin.y &&
+         rect_a->size.w == rect_b->size.w && rect_a->size.h == rect_b->size.h;
+}
+
+bool grect_is_empty(const GRect *const rect) {
+  return rect->size.w <= 0 || rect->size.h <= 0;
+}
+
+static GRect grect_intersect(GRect a, GRect b) {
+  int x0 = a.origin.x > b.origin.x ? a.origin.x : b.origin.x;
+  int y0 = a.origin.y > b.origin.y ? a.origin.y : b.origin.y;
+  int x1 = a.origin.x + a.size.w < b.origin.x + b.size.w ? a.origin.x + a.size.w : b.origin.x + b.size.w;
+  int y1 = a.origin.y + a.size.h < b.origin.y + b.size.h ? a.origin.y + a.size.h : b.origin.y + b.size.h;
+  if (x1 <= x0 || y1 <= y0) {
+    return GRect(x0, y0, 0, 0);
+  }
+  return GRect(x0, y0, x1 - x0, y1 - y0);
+}
+
+void grect_clip(GRect *const rect_to_clip, const GRect *const rect_clipper) {
+  *rect_to_clip = grect_intersect(*rect_to_clip, *rect_clipper);
+}
+
+// --- Fonts and bitmaps --- //
+
+// The system fonts' glyphs aren't available off the watch, so text is drawn
+// as one block per glyph ("greeked") with approximate metrics for each font:
+// enough to show where every line sits and how wide it runs, which is what
+// the layout depends on. As with the system fonts, every glyph stays within
+// its line.
+typedef struct FontMetrics {
+  const char *key;
+  uint8_t line_height; // distance between the tops of two lines
+  uint8_t top;         // blank rows above the cap height
+  uint8_t cap_height;
+  uint8_t x_height;
+  uint8_t descent;
+  uint8_t advance;     // most glyphs
+  uint8_t narrow;      // i, l, punctuation
+  uint8_t space;
+} FontMetrics;
+
+static const FontMetrics s_font_metrics[] = {
+  { FONT_KEY_GOTHIC_18_BOLD, 18, 5, 11, 8, 2, 7, 3, 4 },
+  { FONT_KEY_GOTHIC_24_BOLD, 24, 7, 14, 10, 3, 9, 4, 5 },
+  { FONT_KEY_BITHAM_42_BOLD, 42, 10, 30, 22, 0, 24, 10, 12 },
+  { FONT_KEY_LECO_42_NUMBERS, 42, 11, 29, 22, 0, 22, 9, 11 },
+};
+
+struct GFontStub {
+  const char *key;
+  const FontMetrics *metrics;
+};
+
+GFont fonts_get_system_font(const char *font_key) {
+  static struct GFontStub s_fonts[8];
+  for (size_t i = 0; i < sizeof(s_fonts) / sizeof(s_fonts[0]); i++) {
+    if (!s_fonts[i].key || strcmp(s_fonts[i].key, font_key) == 0) {
+      s_fonts[i].key = font_key;
+      s_fonts[i].metrics = &s_font_metrics[0];
+      for (size_t m = 0; m < sizeof(s_font_metrics) / sizeof(s_font_metrics[0]); m++) {
+        if (strcmp(s_font_metrics[m].key, font_key) == 0) {
+          s_fonts[i].metrics = &s_font_metrics[m];
+        }
+      }
+      return &s_fonts[i];
+    }
+  }
+  return &s_fonts[0];
+}
+
+struct GBitmap {
+  GRect bounds;
+  GBitmapFormat format;
+  uint16_t bytes_per_row;
+  uint8_t *data;
+};
+
+#define STUB_SCREEN_WIDTH 144
+#define STUB_SCREEN_HEIGHT 168
+
+#if defined(PBL_COLOR)
+#define STUB_FRAMEBUFFER_FORMAT GBitmapFormat8Bit
+#else
+#define STUB_FRAMEBUFFER_FORMAT GBitmapFormat1Bit
+#endif
+
+// Rows are padded to a 32-bit word, as on the watch
+static uint16_t bitmap_row_size(int16_t width, GBitmapFormat format) {
+  int bits = format == GBitmapFormat8Bit ? width * 8 : width;
+  return (uint16_t)(((bits + 31) / 32) * 4);
+}
+
+GBitmap *gbitmap_create_with_resource(uint32_t resource_id) {
+  GBitmap *bitmap = stub_calloc(1, sizeof(GBitmap));
+  bitmap->bounds = GRect(0, 0, 16, 16);
+  return bitmap;
+}
+
+GBitmap *gbitmap_create_blank(GSize size, GBitmapFormat format) {
+  GBitmap *bitmap = stub_calloc(1, sizeof(GBitmap));
+  if (!bitmap) {
+    return NULL;
+  }
+  bitmap->bounds = GRect(0, 0, size.w, size.h);
+  bitmap->format = format;
+  bitmap->bytes_per_row = bitmap_row_size(size.w, format);
+  bitmap->data = stub_calloc(size.h, bitmap->bytes_per_row);
+  if (!bitmap->data) {
+    stub_free(bitmap);
+    return NULL;
+  }
+  return bitmap;
+}
+
+void gbitmap_destroy(GBitmap *bitmap) {
+  if (bitmap) {
+    stub_free(bitmap->data);
+  }
+  stub_free(bitmap);
+}
+
+GRect gbitmap_get_bounds(const GBitmap *bitmap) {
+  return bitmap->bounds;
+}
+
+void gbitmap_set_bounds(GBitmap *bitmap, GRect bounds) {
+  bitmap->bounds = bounds;
+}
+
+uint8_t *gbitmap_get_data(const GBitmap *bitmap) {
+  return bitmap->data;
+}
+
+uint16_t gbitmap_get_bytes_per_row(const GBitmap *bitmap) {
+  return bitmap->bytes_per_row;
+}
+
+GBitmapFormat gbitmap_get_format(const GBitmap *bitmap) {
+  return bitmap->format;
+}
+
+// --- Graphics --- //
+
+// Drawing is rasterised into the screen framebuffer, in the platform's
+// format: GColor8 bytes on basalt, 1 bit per pixel (set = white) on diorite.
+// Each layer draws in its own coordinates, offset to its place on screen and
+// clipped to its frame, as the firmware does.
+struct GContext {
+  GColor stroke_color;
+  GColor fill_color;
+  GColor text_color;
+  GPoint offset; // screen position of the drawing layer's bounds origin
+  GRect clip;    // screen rectangle drawing is limited to
+};
+
+static uint8_t s_framebuffer_data[STUB_SCREEN_HEIGHT * ((STUB_SCREEN_WIDTH * 8 + 31) / 32) * 4];
+static GBitmap s_framebuffer;
+
+static GBitmap *framebuffer(void) {
+  s_framebuffer.bounds = GRect(0, 0, STUB_SCREEN_WIDTH, STUB_SCREEN_HEIGHT);
+  s_framebuffer.format = STUB_FRAMEBUFFER_FORMAT;
+  s_framebuffer.bytes_per_row = bitmap_row_size(STUB_SCREEN_WIDTH, STUB_FRAMEBUFFER_FORMAT);
+  s_framebuffer.data = s_framebuffer_data;
+  return &s_framebuffer;
+}
+
+static void graphics_context_reset(GContext *ctx) {
+  ctx->offset = GPoint(0, 0);
+  ctx->clip = GRect(0, 0, STUB_SCREEN_WIDTH, STUB_SCREEN_HEIGHT);
+}
+
+GContext *stub_graphics_context(void) {
+  static GContext s_ctx;
+  if (s_ctx.clip.size.w == 0) {
+    graphics_context_reset(&s_ctx);
+  }
+  return &s_ctx;
+}
+
+// 1-bit pixels are white when the colour is closer to white than to black
+static bool color_is_light(GColor color) {
+  int r = (color.argb >> 4) & 3, g = (color.argb >> 2) & 3, b = color.argb & 3;
+  return r + g + b >= 5;
+}
+
+static void bitmap_set_pixel(GBitmap *bitmap, int x, int y, GColor color) {
+  uint8_t *row = bitmap->data + y * bitmap->bytes_per_row;
+  if (bitmap->format == GBitmapFormat8Bit) {
+    row[x] = color.argb;
+  } else if (color_is_light(color)) {
+    row[x / 8] |= (uint8_t)(1 << (x % 8));
+  } else {
+    row[x / 8] &= (uint8_t)~(1 << (x % 8));
+  }
+}
+
+static GColor bitmap_get_pixel(const GBitmap *bitmap, int x, int y) {
+  const uint8_t *row = bitmap->data + y * bitmap->bytes_per_row;
+  if (bitmap->format == GBitmapFormat8Bit) {
+    return (GColor8){ .argb = row[x] };
+  }
+  return (row[x / 8] >> (x % 8)) & 1 ? GColorWhite : GColorBlack;
+}
+
+// Fill a rectangle in layer coordinates, clipped. Clear colours draw nothing.
+static void fill_pixels(GContext *ctx, GRect rect, GColor color) {
+  if ((color.argb >> 6) == 0) {
+    return;
+  }
+  rect.origin.x += ctx->offset.x;
+  rect.origin.y += ctx->offset.y;
+  rect = grect_intersect(rect, ctx->clip);
+  GBitmap *screen = framebuffer();
+  for (int y = rect.origin.y; y < rect.origin.y + rect.size.h; y++) {
+    for (int x = rect.origin.x; x < rect.origin.x + rect.size.w; x++) {
+      bitmap_set_pixel(screen, x, y, color);
+    }
+  }
+}
+
+static void set_pixel(GContext *ctx, int x, int y, GColor color) {
+  fill_pixels(ctx, GRect(x, y, 1, 1), color);
+}
+
+void graphics_context_set_stroke_color(GContext *ctx, GColor color) {
+  ctx->stroke_color = color;
+}
+
+void graphics_context_set_fill_color(GContext *ctx, GColor color) {
+  ctx->fill_color = color;
+}
+
+void graphics_context_set_text_color(GContext *ctx, GColor color) {
+  ctx->text_color = color;
+}
+
+void graphics_draw_line(GContext *ctx, GPoint p0, GPoint p1) {
+  g_stub_stats.draw_calls++;
+  // Bresenham, one pixel wide
+  int dx = abs(p1.x - p0.x), sx = p0.x < p1.x ? 1 : -1;
+  int dy = -abs(p1.y - p0.y), sy = p0.y < p1.y ? 1 : -1;
+  int err = dx + dy;
+  int x = p0.x, y = p0.y;
+  for (;;) {
+    set_pixel(ctx, x, y, ctx->stroke_color);
+    if (x == p1.x && y == p1.y) {
+      break;
+    }
+    int e2 = 2 * err;
+    if (e2 >= dy) {
+      err += dy;
+      x += sx;
+    }
+    if (e2 <= dx) {
+      err += dx;
+      y += sy;
+    }
+  }
+}
+
+// Pixels whose centre is within half a pixel of the circle of the radius
+static void circle_pixels(GContext *ctx, GPoint p, int radius, bool fill, GColor color) {
+  int outer = radius * radius + radius;
+  int inner = radius * radius - radius;
+  for (int dy = -radius; dy <= radius; dy++) {
+    for (int dx = -radius; dx <= radius; dx++) {
+      int d = dx * dx + dy * dy;
+      if (d <= outer && (fill || d > inner)) {
+        set_pixel(ctx, p.x + dx, p.y + dy, color);
+      }
+    }
+  }
+}
+
+void graphics_draw_circle(GContext *ctx, GPoint p, uint16_t radius) {
+  g_stub_stats.draw_calls++;
+  circle_pixels(ctx, p, radius, false, ctx->stroke_color);
+}
+
+void graphics_fill_circle(GContext *ctx, GPoint p, uint16_t radius) {
+  g_stub_stats.draw_calls++;
+  circle_pixels(ctx, p, radius, true, ctx->fill_color);
+}
+
+// Corner radii aren't drawn; nothing in the watchface rounds its corners
+void graphics_fill_rect(GContext *ctx, GRect rect, uint16_t corner_radius, GCornerMask corner_mask) {
+  g_stub_stats.draw_calls++;
+  fill_pixels(ctx, rect, ctx->fill_color);
+}
+
+// Copies the bitmap's bounds into rect, cropped to the smaller of the two.
+// Resource bitmaps carry no pixels on the host and draw as an outlined box.
+void graphics_draw_bitmap_in_rect(GContext *ctx, const GBitmap *bitmap, GRect rect) {
+  g_stub_stats.draw_calls++;
+  int w = rect.size.w < bitmap->bounds.size.w ? rect.size.w : bitmap->bounds.size.w;
+  int h = rect.size.h < bitmap->bounds.size.h ? rect.size.h : bitmap->bounds.size.h;
+  if (!bitmap->data) {
+    fill_pixels(ctx, GRect(rect.origin.x, rect.origin.y, w, 1), GColorBlack);
+    fill_pixels(ctx, GRect(rect.origin.x, rect.origin.y + h - 1, w, 1), GColorBlack);
+    fill_pixels(ctx, GRect(rect.origin.x, rect.origin.y, 1, h), GColorBlack);
+    fill_pixels(ctx, GRect(rect.origin.x + w - 1, rect.origin.y, 1, h), GColorBlack);
+    return;
+  }
+  for (int y = 0; y < h; y++) {
+    for (int x = 0; x < w; x++) {
+      GColor color = bitmap_get_pixel(bitmap, bitmap->bounds.origin.x + x, bitmap->bounds.origin.y + y);
+      set_pixel(ctx, rect.origin.x + x, rect.origin.y + y, color);
+    }
+  }
+}
+
+// The screen, for code that reads back what it drew
+GBitmap *graphics_capture_frame_buffer(GContext *ctx) {
+  g_stub_stats.frame_captures++;
+  return framebuffer();
+}
+
+bool graphics_release_frame_buffer(GContext *ctx, GBitmap *buffer) {
+  return buffer == &s_framebuffer;
+}
+
+// --- Text --- //
+
+// Decode one UTF-8 sequence, returning its length in bytes
+static size_t utf8_next(const char *text, uint32_t *codepoint) {
+  const uint8_t *s = (const uint8_t *)text;
+  size_t length = s[0] < 0x80 ? 1 : s[0] < 0xE0 ? 2 : s[0] < 0xF0 ? 3 : 4;
+  uint32_t cp = length == 1 ? s[0] : s[0] & (0x3F >> (length - 1));
+  for (size_t i = 1; i < length; i++) {
+    if ((s[i] & 0xC0) != 0x80) {
+      *codepoint = 0xFFFD;
+      return i;
+    }
+    cp = (cp << 6) | (s[i] & 0x3F);
+  }
+  *codepoint = cp;
+  return length;
+}
+
+static bool glyph_is_narrow(uint32_t c) {
+  return c < 0x80 && strchr("ijlI.,:;'!|", (int)c) != NULL;
+}
+
+static int glyph_advance(const FontMetrics *font, uint32_t c) {
+  if (c == ' ') {
+    return font->space;
+  }
+  if (c >= 0xFE00 && c <= 0xFE0F) {
+    return 0; // Variation selectors, e.g. after a warning sign
+  }
+  return glyph_is_narrow(c) ? font->narrow : font->advance;
+}
+
+static int text_width(const FontMetrics *font, const char *text, size_t length) {
+  int width = 0;
+  for (size_t i = 0; i < length;) {
+    uint32_t c;
+    i += utf8_next(text + i, &c);
+    width += glyph_advance(font, c);
+  }
+  return width;
+}
+
+typedef struct TextLine {
+  size_t shown;    // bytes drawn on this line
+  size_t consumed; // bytes up to the start of the next line
+} TextLine;
+
+// The next line of text that fits width, broken after the last space that
+// fits, or mid-word when a single word is wider than the line
+static TextLine text_next_line(const FontMetrics *font, const char *text, int width) {
+  TextLine space_break = { 0, 0 };
+  int x = 0;
+  size_t i = 0;
+  while (text[i]) {
+    uint32_t c;
+    size_t length = utf8_next(text + i, &c);
+    if (c == '\n') {
+      return (TextLine){ i, i + 1 };
+    }
+    if (c == ' ') {
+      space_break = (TextLine){ i, i + 1 };
+    }
+    x += glyph_advance(font, c);
+    if (x > width && c != ' ') {
+      if (space_break.consumed) {
+        return space_break;
+      }
+      size_t fit = i ? i : length;
+      return (TextLine){ fit, fit };
+    }
+    i += length;
+  }
+  return (TextLine){ i, i };
+}
+
+// One greeked glyph with its left edge at x and the line's top at y:
+// capitals and digits fill the cap height, lower case the x-height (plus
+// ascenders and descenders), punctuation a dot or a bar
+static void draw_glyph(GContext *ctx, const FontMetrics *font, uint32_t c, int x, int y, GColor color) {
+  int baseline = y + font->top + font->cap_height;
+  int w = glyph_advance(font, c) - 1;
+  int dot = font->cap_height / 7 > 2 ? font->cap_height / 7 : 2;
+  if (w < 1 || c == ' ') {
+    return;
+  }
+  if (c == '.' || c == ',') {
+    fill_pixels(ctx, GRect(x, baseline - dot, dot, c == ',' ? dot + 1 : dot), color);
+  } else if (c == ':' || c == ';') {
+    fill_pixels(ctx, GRect(x, baseline - dot, dot, dot), color);
+    fill_pixels(ctx, GRect(x, baseline - font->x_height, dot, dot), color);
+  } else if (c == '-') {
+    fill_pixels(ctx, GRect(x, baseline - font->x_height / 2 - 1, w, 2), color);
+  } else if (c == '\'' || c == '"') {
+    fill_pixels(ctx, GRect(x, baseline - font->cap_height, dot, font->cap_height / 3), color);
+  } else if (c >= 'a' && c <= 'z') {
+    bool ascender = strchr("bdfhklt", (int)c) != NULL;
+    bool descender = strchr("gjpqy", (int)c) != NULL;
+    int top = baseline - (ascender ? font->cap_height : font->x_height);
+    fill_pixels(ctx, GRect(x, top, w, baseline - top + (descender ? font->descent : 0)), color);
+  } else if (c >= 0x80 && c != 0xFFFD) {
+    // Symbols such as the bullet and the warning sign: a centred square
+    int size = font->x_height / 2;
+    fill_pixels(ctx, GRect(x + (w - size) / 2, baseline - font->x_height / 2 - size / 2, size, size), color);
+  } else {
+    fill_pixels(ctx, GRect(x, baseline - font->cap_height, w, font->cap_height), color);
+  }
+}
+
+static void draw_text_line(GContext *ctx, const FontMetrics *font, const char *text, size_t length,
+                           bool ellipsis, GRect box, int y, GTextAlignment alignment) {
+  int width = text_width(font, text, length) + (ellipsis ? 3 * font->narrow : 0);
+  int x = box.origin.x;
+  if (alignment == GTextAlignmentCenter) {
+    x += (box.size.w - width) / 2;
+  } else if (alignment == GTextAlignmentRight) {
+    x += box.size.w - width;
+  }
+  for (size_t i = 0; i < length;) {
+    uint32_t c;
+    i += utf8_next(text + i, &c);
+    draw_glyph(ctx, font, c, x, y, ctx->text_color);
+    x += glyph_advance(font, c);
+  }
+  for (int i = 0; ellipsis && i < 3; i++) {
+    draw_glyph(ctx, font, '.', x, y, ctx->text_color);
+    x += font->narrow;
+  }
+}
+
+// Word-wrapped lines while whole lines fit the box. With trailing ellipsis
+// the last line that fits is cut short and ends in "..." if text remains.
+// Draws the lines when ctx is set; returns the size they take either way.
+static GSize layout_text(GContext *ctx, const char *text, GFont font, GRect box,
+                         GTextOverflowMode overflow_mode, GTextAlignment alignment) {
+  const FontMetrics *metrics = font->metrics;
+  int bottom = box.origin.y + box.size.h;
+  GSize size = GSize(0, 0);
+  for (int y = box.origin.y; *text && y + metrics->line_height <= bottom; y += metrics->line_height) {
+    TextLine line = text_next_line(metrics, text, box.size.w);
+    bool last = y + 2 * metrics->line_height > bottom;
+    bool ellipsis = last && overflow_mode == GTextOverflowModeTrailingEllipsis && text[line.consumed];
+    size_t shown = line.shown;
+    while (ellipsis && shown > 0 && text_width(metrics, text, shown) + 3 * metrics->narrow > box.size.w) {
+      do {
+        shown--;
+      } while (shown > 0 && ((uint8_t)text[shown] & 0xC0) == 0x80);
+    }
+    if (ctx) {
+      draw_text_line(ctx, metrics, text, shown, ellipsis, box, y, alignment);
+    }
+    int width = text_width(metrics, text, shown) + (ellipsis ? 3 * metrics->narrow : 0);
+    if (width > size.w) {
+      size.w = width;
+    }
+    size.h += metrics->line_height;
+    text += line.consumed;
+  }
+  return size;
+}
+
+void graphics_draw_text(GContext *ctx, const char *text, GFont font, GRect box,
+                        GTextOverflowMode overflow_mode, GTextAlignment alignment, void *text_attributes) {
+  g_stub_stats.draw_calls++;
+  g_stub_stats.text_draws++;
+  layout_text(ctx, text, font, box, overflow_mode, alignment);
+}
+
+// As the firmware, the laid out text's width and height, at most the box's
+GSize graphics_text_layout_get_content_size(const char *text, GFont font, GRect box,
+                                            GTextOverflowMode overflow_mode, GTextAlignment alignment) {
+  g_stub_stats.text_measures++;
+  return layout_text(NULL, text, font, box, overflow_mode, alignment);
+}
+
+// --- Layers --- //
+
+struct Layer {
+  GRect frame;
+  GRect bounds;
+  bool hidden;
+  LayerUpdateProc update_proc;
+  Layer *parent;
+  Layer *first_child;
+  Layer *next_sibling;
+  void *owner;
+  // Time spent in update_proc, for the render timing report
+  uint32_t renders;
+  uint64_t render_ns;
+};
+
+struct TextLayer {
+  Layer layer;
+  const char *text;
+  GFont font;
+  GColor text_color;
+  GColor background_color;
+  GTextAlignment alignment;
+  GTextOverflowMode overflow_mode;
+};
+
+struct BitmapLayer {
+  Layer layer;
+  const GBitmap *bitmap;
+};
+
+static void layer_init(Layer *layer, GRect frame) {
+  memset(layer, 0, sizeof(*layer));
+  layer->frame = frame;
+  layer->bounds = GRect(0, 0, frame.size.w, frame.size.h);
+}
+
+Layer *layer_create(GRect frame) {
+  Layer *layer = stub_malloc(sizeof(Layer));
+  layer_init(layer, frame);
+  return layer;
+}
+
+void layer_remove_from_parent(Layer *child) {
+  if (!child || !child->parent) {
+    return;
+  }
+  Layer **link = &child->parent->first_child;
+  while (*link && *link != child) {
+    link = &(*link)->next_sibling;
+  }
+  if (*link) {
+    *link = child->next_sibling;
+  }
+  child->parent = NULL;
+  child->next_sibling = NULL;
+}
+
+void layer_destroy(Layer *layer) {
+  if (!layer) {
+    return;
+  }
+  layer_remove_from_parent(layer);
+  stub_free(layer);
+}
+
+void layer_mark_dirty(Layer *layer) {
+  g_stub_stats.dirty_marks++;
+}
+
+void layer_set_update_proc(Layer *layer, LayerUpdateProc update_proc) {
+  layer->update_proc = update_proc;
+}
+
+void layer_set_frame(Layer *layer, GRect frame) {
+  g_stub_stats.frame_sets++;
+  layer->frame = frame;
+  layer->bounds.size = frame.size;
+}
+
+GRect layer_get_frame(const Layer *layer) {
+  return layer->frame;
+}
+
+GRect layer_get_bounds(const Layer *layer) {
+  return layer->bounds;
+}
+
+GPoint layer_convert_point_to_screen(const Layer *layer, GPoint point) {
+  for (; layer; layer = layer->parent) {
+    point.x += layer->frame.origin.x;
+    point.y += layer->frame.origin.y;
+  }
+  return point;
+}
+
+void layer_add_child(Layer *parent, Layer *child) {
+  layer_remove_from_parent(child);
+  child->parent = parent;
+  Layer **link = &parent->first_child;
+  while (*link) {
+    link = &(*link)->next_sibling;
+  }
+  *link = child;
+}
+
+void layer_set_hidden(Layer *layer, bool hidden) {
+  if (layer->hidden != hidden) {
+    g_stub_stats.dirty_marks++;
+  }
+  layer->hidden = hidden;
+}
+
+bool layer_get_hidden(const Layer *layer) {
+  return layer->hidden;
+}
+
+static void text_layer_update_proc(Layer *layer, GContext *ctx) {
+  TextLayer *text_layer = layer->owner;
+  if (text_layer->background_color.argb) {
+    graphics_context_set_fill_color(ctx, text_layer->background_color);
+    graphics_fill_rect(ctx, layer->bounds, 0, GCornerNone);
+  }
+  if (text_layer->text && text_layer->text[0]) {
+    graphics_context_set_text_color(ctx, text_layer->text_color);
+    graphics_draw_text(ctx, text_layer->text, text_layer->font, layer->bounds,
+                       text_layer->overflow_mode, text_layer->alignment, NULL);
+  }
+}
+
+TextLayer *text_layer_create(GRect frame) {
+  TextLayer *text_layer = stub_malloc(sizeof(TextLayer));
+  memset(text_layer, 0, sizeof(*text_layer));
+  layer_init(&text_layer->layer, frame);
+  text_layer->layer.owner = text_layer;
+  text_layer->layer.update_proc = text_layer_update_proc;
+  text_layer->text_color = GColorBlack;
+  text_layer->background_color = GColorWhite;
+  text_layer->font = fonts_get_system_font(FONT_KEY_GOTHIC_18_BOLD);
+  text_layer->overflow_mode = GTextOverflowModeWordWrap;
+  return text_layer;
+}
+
+void text_layer_destroy(TextLayer *text_layer) {
+  if (!text_layer) {
+    return;
+  }
+  layer_remove_from_parent(&text_layer->layer);
+  stub_free(text_layer);
+}
+
+Layer *text_layer_get_layer(TextLayer *text_layer) {
+  return &text_layer->layer;
+}
+
+void text_layer_set_text(TextLayer *text_layer, const char *text) {
+  // Like the firmware, every call re-lays out the text and dirties the layer
+  g_stub_stats.text_sets++;
+  g_stub_stats.dirty_marks++;
+  text_layer->text = text;
+}
+
+const char *text_layer_get_text(TextLayer *text_layer) {
+  return text_layer->text;
+}
+
+void text_layer_set_background_color(TextLayer *text_layer, GColor color) {
+  text_layer->background_color = color;
+}
+
+void text_layer_set_text_color(TextLayer *text_layer, GColor color) {
+  text_layer->text_color = color;
+}
+
+void text_layer_set_font(TextLayer *text_layer, GFont font) {
+  text_layer->font = font;
+}
+
+void text_layer_set_text_alignment(TextLayer *text_layer, GTextAlignment text_alignment) {
+  text_layer->alignment = text_alignment;
+}
+
+void text_layer_set_overflow_mode(TextLayer *text_layer, GTextOverflowMode line_mode) {
+  text_layer->overflow_mode = line_mode;
+}
+
+static void bitmap_layer_update_proc(Layer *layer, GContext *ctx) {
+  BitmapLayer *bitmap_layer = layer->owner;
+  if (bitmap_layer->bitmap) {
+    graphics_draw_bitmap_in_rect(ctx, bitmap_layer->bitmap, layer->bounds);
+  }
+}
+
+BitmapLayer *bitmap_layer_create(GRect frame) {
+  BitmapLayer *bitmap_layer = stub_malloc(sizeof(BitmapLayer));
+  memset(bitmap_layer, 0, sizeof(*bitmap_layer));
+  layer_init(&bitmap_layer->layer, frame);
+  bitmap_layer->layer.owner = bitmap_layer;
+  bitmap_layer->layer.update_proc = bitmap_layer_update_proc;
+  return bitmap_layer;
+}
+
+void bitmap_layer_destroy(BitmapLayer *bitmap_layer) {
+  if (!bitmap_layer) {
+    return;
+  }
+  layer_remove_from_parent(&bitmap_layer->layer);
+  stub_free(bitmap_layer);
+}
+
+Layer *bitmap_layer_get_layer(const BitmapLayer *bitmap_layer) {
+  return (Layer *)&bitmap_layer->layer;
+}
+
+void bitmap_layer_set_bitmap(BitmapLayer *bitmap_layer, const GBitmap *bitmap) {
+  bitmap_layer->bitmap = bitmap;
+}
+
+// --- Windows --- //
+
+struct Window {
+  Layer root;
+  WindowHandlers handlers;
+  GColor background_color;
+  bool loaded;
+};
+
+static Window *s_top_window;
+
+Window *window_create(void) {
+  Window *window = stub_malloc(sizeof(Window));
+  memset(window, 0, sizeof(*window));
+  layer_init(&window->root, GRect(0, 0, STUB_SCREEN_WIDTH, STUB_SCREEN_HEIGHT));
+  window->background_color = GColorWhite;
+  return window;
+}
+
+void window_destroy(Window *window) {
+  if (!window) {
+    return;
+  }
+  if (window->loaded && window->handlers.unload) {
+    window->handlers.unload(window);
+  }
+  if (s_top_window == window) {
+    s_top_window = NULL;
+  }
+  stub_free(window);
+}
+
+void window_set_window_handlers(Window *window, WindowHandlers handlers) {
+  window->handlers = handlers;
+}
+
+void window_set_background_color(Window *window, GColor background_color) {
+  window->background_color = background_color;
+}
+
+Layer *window_get_root_layer(const Window *window) {
+  return (Layer *)&window->root;
+}
+
+void window_stack_push(Window *window, bool animated) {
+  s_top_window = window;
+  if (!window->loaded && window->handlers.load) {
+    window->handlers.load(window);
+  }
+  window->loaded = true;
+  if (window->handlers.appear) {
+    window->handlers.appear(window);
+  }
+}
+
+Window *stub_top_window(void) {
+  return s_top_window;
+}
+
+static uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Draw the layer and its children, each clipped to its own frame and its
+// parent's. origin is the screen position of the parent's bounds origin.
+static void render_layer(Layer *layer, GContext *ctx, GPoint origin, GRect clip) {
+  if (layer->hidden) {
+    return;
+  }
+  origin.x += layer->frame.origin.x;
+  origin.y += layer->frame.origin.y;
+  clip = grect_intersect(clip, (GRect){ origin, layer->frame.size });
+  origin.x += layer->bounds.origin.x;
+  origin.y += layer->bounds.origin.y;
+  if (layer->update_proc) {
+    ctx->offset = origin;
+    ctx->clip = clip;
+    uint64_t start = now_ns();
+    layer->update_proc(layer, ctx);
+    layer->render_ns += now_ns() - start;
+    layer->renders++;
+  }
+  for (Layer *child = layer->first_child; child; child = child->next_sibling) {
+    render_layer(child, ctx, origin, clip);
+  }
+}
+
+// Redraw the whole window over its background. Like the firmware, a clear
+// background isn't filled, so whatever the last frame left stays underneath.
+void stub_render_window(Window *window) {
+  GContext *ctx = stub_graphics_context();
+  graphics_context_reset(ctx);
+  if (window->background_color.argb >> 6) {
+    fill_pixels(ctx, GRect(0, 0, STUB_SCREEN_WIDTH, STUB_SCREEN_HEIGHT), window->background_color);
+  }
+  render_layer(&window->root, ctx, GPoint(0, 0), ctx->clip);
+  graphics_context_reset(ctx);
+}
+
+const GBitmap *stub_framebuffer(void) {
+  return framebuffer();
+}
+
+uint32_t stub_layer_render_count(const Layer *layer) {
+  return layer->renders;
+}
+
+uint64_t stub_layer_render_ns(const Layer *layer) {
+  return layer->render_ns;
+}
+
+// --- Dictionary --- //
+
+uint32_t dict_calc_buffer_size(const uint8_t tuple_count, ...) {
+  uint32_t total = sizeof(Dictionary);
+  va_list args;
+  va_start(args, tuple_count);
+  for (uint8_t i = 0; i < tuple_count; i++) {
+    total += sizeof(Tuple) + va_arg(args, uint32_t);
+  }
+  va_end(args);
+  return total;
+}
+
+DictionaryResult dict_write_begin(DictionaryIterator *iter, uint8_t *const buffer, const uint16_t size) {
+  if (!iter || !buffer || size < sizeof(Dictionary)) {
+    return DICT_INVALID_ARGS;
+  }
+  iter->dictionary = (Dictionary *)buffer;
+  iter->dictionary->count = 0;
+  iter->cursor = iter->dictionary->head;
+  iter->end = buffer + size;
+  return DICT_OK;
+}
+
+static DictionaryResult dict_write_tuple(DictionaryIterator *iter, uint32_t key, TupleType type,
+                                         const void *data, uint16_t length) {
+  if ((const uint8_t *)iter->cursor + sizeof(Tuple) + length > (const uint8_t *)iter->end) {
+    return DICT_NOT_ENOUGH_STORAGE;
+  }
+  Tuple *tuple = iter->cursor;
+  tuple->key = key;
+  tuple->type = type;
+  tuple->length = length;
+  memcpy(tuple->value->data, data, length);
+  iter->dictionary->count++;
+  iter->cursor = (Tuple *)((uint8_t *)tuple + sizeof(Tuple) + length);
+  return DICT_OK;
+}
+
+DictionaryResult dict_write_data(DictionaryIterator *iter, const uint32_t key, const uint8_t *const data,
+                                 const uint16_t size) {
+  return dict_write_tuple(iter, key, TUPLE_BYTE_ARRAY, data, size);
+}
+
+DictionaryResult dict_write_cstring(DictionaryIterator *iter, const uint32_t key, const char *const cstring) {
+  return dict_write_tuple(iter, key, TUPLE_CSTRING, cstring, strlen(cstring) + 1);
+}
+
+DictionaryResult dict_write_int(DictionaryIterator *iter, const uint32_t key, const void *integer,
+                                const uint8_t width_bytes, const bool is_signed) {
+  return dict_write_tuple(iter, key, is_signed ? TUPLE_INT : TUPLE_UINT, integer, width_bytes);
+}
+
+DictionaryResult dict_write_int32(DictionaryIterator *iter, const uint32_t key, const int32_t value) {
+  return dict_write_int(iter, key, &value, sizeof(value), true);
+}
+
+DictionaryResult dict_write_uint8(DictionaryIterator *iter, const uint32_t key, const uint8_t value) {
+  return dict_write_int(iter, key, &value, sizeof(value), false);
+}
+
+uint32_t dict_write_end(DictionaryIterator *iter) {
+  iter->end = iter->cursor;
+  return (uint32_t)((uint8_t *)iter->cursor - (uint8_t *)iter->dictionary);
+}
+
+uint32_t dict_size(DictionaryIterator *iter) {
+  return (uint32_t)((const uint8_t *)iter->end - (const uint8_t *)iter->dictionary);
+}
+
+Tuple *dict_read_begin_from_buffer(DictionaryIterator *iter, const uint8_t *const buffer, const uint16_t size) {
+  iter->dictionary = (Dictionary *)buffer;
+  iter->end = buffer + size;
+  return dict_read_first(iter);
+}
+
+Tuple *dict_read_first(DictionaryIterator *iter) {
+  iter->cursor = iter->dictionary->head;
+  return iter->dictionary->count ? iter->cursor : NULL;
+}
+
+Tuple *dict_read_next(DictionaryIterator *iter) {
+  Tuple *next = (Tuple *)((uint8_t *)iter->cursor + sizeof(Tuple) + iter->cursor->length);
+  if ((const void *)next >= iter->end) {
+    return NULL;
+  }
+  iter->cursor = next;
+  return next;
+}
+
+Tuple *dict_find(const DictionaryIterator *iter, const uint32_t key) {
+  Tuple *tuple = iter->dictionary->head;
+  for (uint8_t i = 0; i < iter->dictionary->count; i++) {
+    if (tuple->key == key) {
+      return tuple;
+    }
+    tuple = (Tuple *)((uint8_t *)tuple + sizeof(Tuple) + tuple->length);
+  }
+  return NULL;
+}
+
+// --- AppMessage --- //
+
+static AppMessageInboxReceived s_inbox_received;
+static AppMessageInboxDropped s_inbox_dropped;
+static AppMessageOutboxSent s_outbox_sent;
+static AppMessageOutboxFailed s_outbox_failed;
+static uint32_t s_inbox_size;
+static uint32_t s_outbox_size;
+static bool s_app_message_open;
+
+// One outgoing message at a time, held until stub_complete_outbox() answers it
+static uint8_t s_outbox_buffer[256];
+static DictionaryIterator s_outbox_iter;
+static bool s_outbox_writing;
+static bool s_outbox_in_flight;
+
+AppMessageResult app_message_open(const uint32_t size_inbound, const uint32_t size_outbound) {
+  if (size_outbound > sizeof(s_outbox_buffer)) {
+    return APP_MSG_OUT_OF_MEMORY;
+  }
+  s_inbox_size = size_inbound;
+  s_outbox_size = size_outbound;
+  s_app_message_open = true;
+  return APP_MSG_OK;
+}
+
+AppMessageInboxReceived app_message_register_inbox_received(AppMessageInboxReceived received_callback) {
+  AppMessageInboxReceived previous = s_inbox_received;
+  s_inbox_received = received_callback;
+  return previous;
+}
+
+AppMessageInboxDropped app_message_register_inbox_dropped(AppMessageInboxDropped dropped_callback) {
+  AppMessageInboxDropped previous = s_inbox_dropped;
+  s_inbox_dropped = dropped_callback;
+  return previous;
+}
+
+AppMessageOutboxSent app_message_register_outbox_sent(AppMessageOutboxSent sent_callback) {
+  AppMessageOutboxSent previous = s_outbox_sent;
+  s_outbox_sent = sent_callback;
+  return previous;
+}
+
+AppMessageOutboxFailed app_message_register_outbox_failed(AppMessageOutboxFailed failed_callback) {
+  AppMessageOutboxFailed previous = s_outbox_failed;
+  s_outbox_failed = failed_callback;
+  return previous;
+}
+
+AppMessageResult app_message_outbox_begin(DictionaryIterator **iterator) {
+  if (!s_app_message_open) {
+    return APP_MSG_INVALID_STATE;
+  }
+  if (s_outbox_writing || s_outbox_in_flight) {
+    return APP_MSG_BUSY;
+  }
+  dict_write_begin(&s_outbox_iter, s_outbox_buffer, (uint16_t)s_outbox_size);
+  s_outbox_writing = true;
+  *iterator = &s_outbox_iter;
+  return APP_MSG_OK;
+}
+
+AppMessageResult app_message_outbox_send(void) {
+  if (!s_outbox_writing) {
+    return APP_MSG_INVALID_STATE;
+  }
+  dict_write_end(&s_outbox_iter);
+  s_outbox_writing = false;
+  s_outbox_in_flight = true;
+  g_stub_stats.outbox_sends++;
+  return APP_MSG_OK;
+}
+
+void stub_close_app_message(void) {
+  s_app_message_open = false;
+  s_outbox_writing = false;
+  s_outbox_in_flight = false;
+}
+
+DictionaryIterator *stub_outbox_pending(void) {
+  return s_outbox_in_flight ? &s_outbox_iter : NULL;
+}
+
+void stub_complete_outbox(bool delivered) {
+  if (!s_outbox_in_flight) {
+    return;
+  }
+  // Free for the next message before the callback, which may send it
+  s_outbox_in_flight = false;
+  if (delivered && s_outbox_sent) {
+    s_outbox_sent(&s_outbox_iter, NULL);
+  } else if (!delivered && s_outbox_failed) {
+    s_outbox_failed(&s_outbox_iter, APP_MSG_SEND_TIMEOUT, NULL);
+  }
+}
+
+void stub_deliver_inbox(DictionaryIterator *iter) {
+  if (dict_size(iter) > s_inbox_size) {
+    if (s_inbox_dropped) {
+      s_inbox_dropped(APP_MSG_BUFFER_OVERFLOW, NULL);
+    }
+    return;
+  }
+  if (s_inbox_received) {
+    s_inbox_received(iter, NULL);
+  }
+}
+
+uint32_t stub_inbox_size(void) {
+  return s_inbox_size;
+}
+
+uint32_t stub_outbox_size(void) {
+  return s_outbox_size;
+}
+
+// --- Services --- //
+
+static TickHandler s_tick_handler;
+
+void tick_timer_service_subscribe(TimeUnits tick_units, TickHandler handler) {
+  s_tick_handler = handler;
+}
+
+void tick_timer_service_unsubscribe(void) {
+  s_tick_handler = NULL;
+}
+
+void stub_fire_tick(struct tm *tick_time, TimeUnits units_changed) {
+  if (s_tick_handler) {
+    s_tick_handler(tick_time, units_changed);
+  }
+}
+
+bool clock_is_24h_style(void) {
+  return s_24h_style;
+}
+
+HealthValue health_service_sum_today(HealthMetric metric) {
+  g_stub_stats.health_queries++;
+  return metric == HealthMetricStepCount ? s_health_steps : -1;
+}
+
+static HealthEventHandler s_health_handler;
+static void *s_health_context;
+
+bool health_service_events_subscribe(HealthEventHandler handler, void *context) {
+  s_health_handler = handler;
+  s_health_context = context;
+  return true;
+}
+
+bool health_service_events_unsubscribe(void) {
+  s_health_handler = NULL;
+  s_health_context = NULL;
+  return true;
+}
+
+void stub_fire_health_event(HealthEventType event) {
+  if (s_health_handler) {
+    s_health_handler(event, s_health_context);
+  }
+}
+
+bool stub_health_subscribed(void) {
+  return s_health_handler != NULL;
+}
+
+static BatteryStateHandler s_battery_handler;
+
+BatteryChargeState battery_state_service_peek(void) {
+  return s_battery;
+}
+
+void battery_state_service_subscribe(BatteryStateHandler handler) {
+  s_battery_handler = handler;
+}
+
+void battery_state_service_unsubscribe(void) {
+  s_battery_handler = NULL;
+}
+
+static AppFocusHandlers s_focus_handlers;
+
+void app_focus_service_subscribe_handlers(AppFocusHandlers handlers) {
+  s_focus_handlers = handlers;
+}
+
+void app_focus_service_subscribe(AppFocusHandler handler) {
+  s_focus_handlers = (AppFocusHandlers){ .will_focus = handler };
+}
+
+void app_focus_service_unsubscribe(void) {
+  s_focus_handlers = (AppFocusHandlers){ 0 };
+}
+
+// Timers live in a fixed table and fire only from stub_advance_timers()
+#define STUB_TIMER_SLOTS 8
+
+struct AppTimer {
+  bool used;
+  uint32_t remaining_ms;
+  AppTimerCallback callback;
+  void *data;
+};
+
+static AppTimer s_timers[STUB_TIMER_SLOTS];
+
+AppTimer *app_timer_register(uint32_t timeout_ms, AppTimerCallback callback, void *callback_data) {
+  for (int i = 0; i < STUB_TIMER_SLOTS; i++) {
+    if (!s_timers[i].used) {
+      s_timers[i] = (AppTimer){ true, timeout_ms, callback, callback_data };
+      return &s_timers[i];
+    }
+  }
+  return NULL;
+}
+
+bool app_timer_reschedule(AppTimer *timer_handle, uint32_t new_timeout_ms) {
+  if (!timer_handle || !timer_handle->used) {
+    return false;
+  }
+  timer_handle->remaining_ms = new_timeout_ms;
+  return true;
+}
+
+void app_timer_cancel(AppTimer *timer_handle) {
+  if (timer_handle) {
+    timer_handle->used = false;
+  }
+}
+
+void stub_advance_timers(uint32_t ms) {
+  for (int i = 0; i < STUB_TIMER_SLOTS; i++) {
+    AppTimer *timer = &s_timers[i];
+    if (!timer->used) {
+      continue;
+    }
+    if (timer->remaining_ms > ms) {
+      timer->remaining_ms -= ms;
+      continue;
+    }
+    // One-shot: free the slot before the callback so it can register again
+    timer->used = false;
+    timer->callback(timer->data);
+  }
+}
+
+void vibes_short_pulse(void) {
+  g_stub_stats.vibes++;
+}
+
+void vibes_double_pulse(void) {
+  g_stub_stats.vibes++;
+}
+
+// In-memory persistent storage: a handful of keys is all the watchface uses
+#define STUB_PERSIST_SLOTS 16
+
+typedef struct {
+  bool used;
+  uint32_t key;
+  size_t size;
+  uint8_t data[PERSIST_DATA_MAX_LENGTH];
+} PersistSlot;
+
+static PersistSlot s_persist[STUB_PERSIST_SLOTS];
+
+static PersistSlot *persist_find(uint32_t key) {
+  for (int i = 0; i < STUB_PERSIST_SLOTS; i++) {
+    if (s_persist[i].used && s_persist[i].key == key) {
+      return &s_persist[i];
+    }
+  }
+  return NULL;
+}
+
+bool persist_exists(const uint32_t key) {
+  return persist_find(key) != NULL;
+}
+
+int persist_read_data(const uint32_t key, void *buffer, const size_t buffer_size) {
+  PersistSlot *slot = persist_find(key);
+  if (!slot) {
+    return E_DOES_NOT_EXIST;
+  }
+  size_t size = slot->size < buffer_size ? slot->size : buffer_size;
+  memcpy(buffer, slot->data, size);
+  return (int)size;
+}
+
+status_t persist_write_data(const uint32_t key, const void *data, const size_t size) {
+  if (size > PERSIST_DATA_MAX_LENGTH) {
+    return E_RANGE;
+  }
+  PersistSlot *slot = persist_find(key);
+  for (int i = 0; !slot && i < STUB_PERSIST_SLOTS; i++) {
+    if (!s_persist[i].used) {
+      slot = &s_persist[i];
+    }
+  }
+  if (!slot) {
+    return E_RANGE;
+  }
+  slot->used = true;
+  slot->key = key;
+  slot->size = size;
+  memcpy(slot->data, data, size);
+  g_stub_stats.persist_writes++;
+  return (status_t)size;
+}
+
+status_t persist_delete(const uint32_t key) {
+  PersistSlot *slot = persist_find(key);
+  if (!slot) {
+    return E_DOES_NOT_EXIST;
+  }
+  slot->used = false;
+  return S_SUCCESS;
+}
+
+void app_event_loop(void) {
+}
+
+time_t stub_time(time_t *tloc) {
+  if (tloc) {
+    *tloc = s_now;
+  }
+  return s_now;
+}
+
+// --- Stub control --- //
+
+void stub_reset_stats(void) {
+  uint32_t bytes_live = g_stub_stats.bytes_live;
+  memset(&g_stub_stats, 0, sizeof(g_stub_stats));
+  g_stub_stats.bytes_live = bytes_live;
+}
+
+void stub_set_log_echo(bool echo) {
+  s_log_echo = echo;
+}
+
+void stub_set_time(time_t now) {
+  s_now = now;
+}
+
+void stub_set_24h_style(bool is_24h) {
+  s_24h_style = is_24h;
+}
+
+void stub_set_health_steps(HealthValue steps) {
+  s_health_steps = steps;
+}
+
+void stub_set_battery(BatteryChargeState charge) {
+  s_battery = charge;
+  if (s_battery_handler) {
+    s_battery_handler(charge);
+  }
+}
+
+void stub_fire_focus(bool in_focus) {
+  if (s_focus_handlers.will_focus) {
+    s_focus_handlers.will_focus(in_focus);
+  }
+  if (s_focus_handlers.did_focus) {
+    s_focus_handlers.did_focus(in_focus);
+  }
+}
+
+void stub_persist_clear(void) {
+  memset(s_persist, 0, sizeof(s_persist));
+}
@@ -0,0 +1,395 @@
+// Host render check of the watchface layout.
+//
+// Builds the real layer tree with main_window_load(), drives it through a
+// few scenes (no weather yet, a weather update, the countdown toggled off and
+// back on, steps, a storm warning) and renders each into the stub's 144x168
+// framebuffer. Every frame is compared pixel by pixel with the golden image
+// in the given directory (<scene>.ppm on basalt, <scene>.pbm on diorite);
+// a mismatch leaves the frame and a diff image (differing pixels in red) in
+// the output directory and fails the run. UPDATE_GOLDEN=1 rewrites the
+// goldens instead.
+//
+// Text is drawn as greeked blocks with approximate font metrics (see
+// pebble_stub.c), so the images check where things sit, not the glyphs.
+// Each scene is then rendered again to report the time spent in every
+// layer's update proc, per frame, on the build machine, followed by the
+// time for a minute tick and the frame it leads to.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wreturn-type" // the watch's main() relies on C99's implicit return
+#define main just_weather_main
+#include "../../src/c/just_weather.c"
+#undef main
+#pragma GCC diagnostic pop
+
+#include "companion.h"
+
+#define RENDER_DEFAULT_ITERATIONS 200
+#define RENDER_START_TIME 1761820800 // 2025-10-30 10:40 UTC
+#define SCREEN_W 144
+#define SCREEN_H 168
+
+#if defined(PBL_COLOR)
+#define GOLDEN_EXT "ppm"
+#define GOLDEN_IS_BITMAP false
+#else
+#define GOLDEN_EXT "pbm"
+#define GOLDEN_IS_BITMAP true
+#endif
+
+typedef uint8_t Image[SCREEN_H][SCREEN_W][3];
+
+static uint8_t s_msg_buffer[1024];
+static DictionaryIterator s_msg_iter;
+
+static const char *s_golden_dir;
+static const char *s_out_dir;
+static bool s_update_golden;
+static long s_iterations;
+static int s_mismatches;
+
+// --- Scenes --- //
+
+static void show_time(void) {
+  time_t now = time(NULL);
+  struct tm tm;
+  gmtime_r(&now, &tm);
+  stub_fire_tick(&tm, MINUTE_UNIT);
+}
+
+// Each save on the settings page is a new version
+static uint16_t s_settings_version = 0;
+
+static void deliver_settings(uint8_t settings) {
+  companion_settings_message(&s_msg_iter, s_msg_buffer, sizeof(s_msg_buffer), 0, settings, ++s_settings_version);
+  stub_deliver_inbox(&s_msg_iter);
+}
+
+// A fetch that only changed the pressure
+static void deliver_pressure(int16_t pressure_dhpa) {
+  uint16_t present = WEATHER_FIELD_PRESSURE;
+  const uint8_t record[] = { WEATHER_RECORD_VERSION, WEATHER_RECORD_FLAG_FETCHED, present & 0xFF, present >> 8,
+                             pressure_dhpa & 0xFF, (pressure_dhpa >> 8) & 0xFF };
+  companion_record_message(&s_msg_iter, s_msg_buffer, sizeof(s_msg_buffer), record, sizeof(record));
+  stub_deliver_inbox(&s_msg_iter);
+}
+
+#define DEFAULT_SETTINGS (WEATHER_SETTING_UPDATE_COUNTDOWN | WEATHER_SETTING_STEP_UNIT_MILES)
+
+static void scene_loading(void) {
+  show_time();
+}
+
+// Seven minutes into a 15-minute fetch interval: seven dots filled
+static void scene_weather(void) {
+  companion_weather_message(&s_msg_iter, s_msg_buffer, sizeof(s_msg_buffer));
+  stub_deliver_inbox(&s_msg_iter);
+  stub_set_time(time(NULL) + 7 * 60);
+  show_time();
+}
+
+static void scene_countdown_off(void) {
+  deliver_settings(WEATHER_SETTING_STEP_UNIT_MILES);
+}
+
+static void scene_countdown_on(void) {
+  deliver_settings(DEFAULT_SETTINGS);
+}
+
+static void scene_steps(void) {
+  stub_set_health_steps(8431);
+  deliver_settings(DEFAULT_SETTINGS | WEATHER_SETTING_SHOW_STEPS);
+}
+
+// Falling 1.2 mb in an hour. The weather scene's reading is too recent to
+// keep apart from the first one here, so the history starts over.
+static void scene_storm(void) {
+  pressure_history_clear(&s_pressure_history);
+  deliver_settings(DEFAULT_SETTINGS | WEATHER_SETTING_STORM_WARNING);
+  deliver_pressure(10130);
+  stub_set_time(time(NULL) + 60 * 60);
+  deliver_pressure(10118);
+  show_time();
+}
+
+typedef struct Scene {
+  const char *name;
+  const char *golden; // Scenes that must look the same share one
+  void (*setup)(void);
+} Scene;
+
+static const Scene s_scenes[] = {
+  { "loading", "loading", scene_loading },
+  { "weather", "weather", scene_weather },
+  { "countdown_off", "countdown_off", scene_countdown_off },
+  // Turning the countdown back on must restore the original layout exactly
+  { "countdown_on", "weather", scene_countdown_on },
+  { "steps", "steps", scene_steps },
+  { "storm", "storm", scene_storm },
+};
+
+#define SCENE_COUNT (sizeof(s_scenes) / sizeof(s_scenes[0]))
+
+// --- Images --- //
+
+// The framebuffer as 8-bit RGB, whatever its format
+static void framebuffer_to_image(Image image) {
+  const GBitmap *screen = stub_framebuffer();
+  const uint8_t *data = gbitmap_get_data(screen);
+  uint16_t stride = gbitmap_get_bytes_per_row(screen);
+  for (int y = 0; y < SCREEN_H; y++) {
+    for (int x = 0; x < SCREEN_W; x++) {
+      uint8_t *px = image[y][x];
+      if (gbitmap_get_format(screen) == GBitmapFormat8Bit) {
+        uint8_t argb = data[y * stride + x];
+        px[0] = ((argb >> 4) & 3) * 85;
+        px[1] = ((argb >> 2) & 3) * 85;
+        px[2] = (argb & 3) * 85;
+      } else {
+        px[0] = px[1] = px[2] = (data[y * stride + x / 8] >> (x % 8)) & 1 ? 255 : 0;
+      }
+    }
+  }
+}
+
+// P6 (RGB) or P4 (1 bit, set = black) as netpbm defines them
+static bool write_image(const char *path, Image image, bool bitmap) {
+  FILE *f = fopen(path, "wb");
+  if (!f) {
+    perror(path);
+    return false;
+  }
+  if (bitmap) {
+    fprintf(f, "P4\n%d %d\n", SCREEN_W, SCREEN_H);
+    for (int y = 0; y < SCREEN_H; y++) {
+      uint8_t row[SCREEN_W / 8] = { 0 };
+      for (int x = 0; x < SCREEN_W; x++) {
+        if (image[y][x][0] < 128) {
+          row[x / 8] |= (uint8_t)(0x80 >> (x % 8));
+        }
+      }
+      fwrite(row, sizeof(row), 1, f);
+    }
+  } else {
+    fprintf(f, "P6\n%d %d\n255\n", SCREEN_W, SCREEN_H);
+    fwrite(image, sizeof(Image), 1, f);
+  }
+  return fclose(f) == 0;
+}
+
+static bool read_image(const char *path, Image image) {
+  FILE *f = fopen(path, "rb");
+  if (!f) {
+    return false;
+  }
+  char magic[3] = { 0 };
+  int w = 0, h = 0, max = 1;
+  bool ok = fscanf(f, "%2s %d %d", magic, &w, &h) == 3 && w == SCREEN_W && h == SCREEN_H;
+  bool bitmap = strcmp(magic, "P4") == 0;
+  if (ok && !bitmap) {
+    ok = strcmp(magic, "P6") == 0 && fscanf(f, "%d", &max) == 1 && max == 255;
+  }
+  ok = ok && fgetc(f) != EOF; // The single whitespace before the pixels
+  if (ok && bitmap) {
+    for (int y = 0; ok && y < SCREEN_H; y++) {
+      uint8_t row[SCREEN_W / 8];
+      ok = fread(row, sizeof(row), 1, f) == 1;
+      for (int x = 0; ok && x < SCREEN_W; x++) {
+        uint8_t value = row[x / 8] & (0x80 >> (x % 8)) ? 0 : 255;
+        image[y][x][0] = image[y][x][1] = image[y][x][2] = value;
+      }
+    }
+  } else if (ok) {
+    ok = fread(image, sizeof(Image), 1, f) == 1;
+  }
+  fclose(f);
+  return ok;
+}
+
+// Differing pixels in red over a faded copy of the frame
+static int diff_images(Image actual, Image golden, Image diff) {
+  int differing = 0;
+  for (int y = 0; y < SCREEN_H; y++) {
+    for (int x = 0; x < SCREEN_W; x++) {
+      if (memcmp(actual[y][x], golden[y][x], 3) != 0) {
+        differing++;
+        diff[y][x][0] = 255;
+        diff[y][x][1] = diff[y][x][2] = 0;
+      } else {
+        for (int c = 0; c < 3; c++) {
+          diff[y][x][c] = 192 + actual[y][x][c] / 4;
+        }
+      }
+    }
+  }
+  return differing;
+}
+
+static void check_frame(const Scene *scene) {
+  static Image actual, golden, diff;
+  char path[512];
+  framebuffer_to_image(actual);
+
+  snprintf(path, sizeof(path), "%s/%s.%s", s_golden_dir, scene->golden, GOLDEN_EXT);
+  if (s_update_golden) {
+    if (strcmp(scene->name, scene->golden) == 0 && write_image(path, actual, GOLDEN_IS_BITMAP)) {
+      printf("%-14s golden written to %s\n", scene->name, path);
+    }
+    return;
+  }
+  if (!read_image(path, golden)) {
+    fprintf(stderr, "%s: missing or unreadable golden %s (run with UPDATE_GOLDEN=1)\n", scene->name, path);
+    s_mismatches++;
+    return;
+  }
+  int differing = diff_images(actual, golden, diff);
+  if (differing == 0) {
+    printf("%-14s matches %s\n", scene->name, path);
+    return;
+  }
+  s_mismatches++;
+  fprintf(stderr, "%s: %d pixel(s) differ from %s\n", scene->name, differing, path);
+  snprintf(path, sizeof(path), "%s/%s.%s", s_out_dir, scene->name, GOLDEN_EXT);
+  write_image(path, actual, GOLDEN_IS_BITMAP);
+  fprintf(stderr, "  actual: %s\n", path);
+  snprintf(path, sizeof(path), "%s/%s.diff.ppm", s_out_dir, scene->name);
+  write_image(path, diff, false);
+  fprintf(stderr, "  diff:   %s\n", path);
+}
+
+// --- Timing --- //
+
+typedef struct TimedLayer {
+  const char *name;
+  Layer *(*get)(void);
+} TimedLayer;
+
+static Layer *progress_layer(void) { return s_update_progress_layer; }
+static Layer *shoe_icon_layer(void) { return s_shoe_icon_layer ? bitmap_layer_get_layer(s_shoe_icon_layer) : NULL; }
+
+#if defined(SINGLE_DATA_LAYER)
+static Layer *data_layer(void) { return s_data_layer; }
+
+static const TimedLayer s_timed_layers[] = {
+  { "data", data_layer },
+  { "progress", progress_layer },
+  { "shoe_icon", shoe_icon_layer },
+};
+#else
+static Layer *time_layer(void) { return text_layer_get_layer(s_row_layers[ROW_TIME]); }
+static Layer *location_layer(void) { return text_layer_get_layer(s_row_layers[ROW_LOCATION]); }
+static Layer *temp_cond_layer(void) { return text_layer_get_layer(s_row_layers[ROW_CONDITIONS]); }
+static Layer *pressure_layer(void) { return text_layer_get_layer(s_row_layers[ROW_PRESSURE]); }
+static Layer *wind_precip_layer(void) { return text_layer_get_layer(s_row_layers[ROW_WIND_PRECIP]); }
+
+static const TimedLayer s_timed_layers[] = {
+  { "time", time_layer },
+  { "location", location_layer },
+  { "progress", progress_layer },
+  { "temp_cond", temp_cond_layer },
+  { "pressure", pressure_layer },
+  { "wind_precip", wind_precip_layer },
+  { "shoe_icon", shoe_icon_layer },
+};
+#endif
+
+#define TIMED_LAYER_COUNT (sizeof(s_timed_layers) / sizeof(s_timed_layers[0]))
+
+// ns per frame for each layer and scene; negative when the layer isn't drawn
+static double s_layer_ns[TIMED_LAYER_COUNT][SCENE_COUNT];
+static double s_frame_ns[SCENE_COUNT];
+static double s_tick_frame_ns;
+
+static uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void time_frames(size_t scene) {
+  uint32_t renders[TIMED_LAYER_COUNT];
+  uint64_t ns[TIMED_LAYER_COUNT];
+  for (size_t i = 0; i < TIMED_LAYER_COUNT; i++) {
+    Layer *layer = s_timed_layers[i].get();
+    renders[i] = layer ? stub_layer_render_count(layer) : 0;
+    ns[i] = layer ? stub_layer_render_ns(layer) : 0;
+  }
+
+  uint64_t start = now_ns();
+  for (long n = 0; n < s_iterations; n++) {
+    stub_render_window(stub_top_window());
+  }
+  s_frame_ns[scene] = (double)(now_ns() - start) / s_iterations;
+
+  for (size_t i = 0; i < TIMED_LAYER_COUNT; i++) {
+    Layer *layer = s_timed_layers[i].get();
+    uint32_t drawn = layer ? stub_layer_render_count(layer) - renders[i] : 0;
+    s_layer_ns[i][scene] = drawn ? (double)(stub_layer_render_ns(layer) - ns[i]) / drawn : -1;
+  }
+}
+
+// The usual frame: a minute passes and the clock changes
+static void time_tick_frames(void) {
+  uint64_t start = now_ns();
+  for (long n = 0; n < s_iterations; n++) {
+    stub_set_time(time(NULL) + 60);
+    show_time();
+    stub_render_window(stub_top_window());
+  }
+  s_tick_frame_ns = (double)(now_ns() - start) / s_iterations;
+}
+
+static void print_timing(void) {
+  printf("\n%-14s", "ns/frame");
+  for (size_t s = 0; s < SCENE_COUNT; s++) {
+    printf(" %13s", s_scenes[s].name);
+  }
+  for (size_t i = 0; i < TIMED_LAYER_COUNT; i++) {
+    printf("\n%-14s", s_timed_layers[i].name);
+    for (size_t s = 0; s < SCENE_COUNT; s++) {
+      if (s_layer_ns[i][s] < 0) {
+        printf(" %13s", "-");
+      } else {
+        printf(" %13.1f", s_layer_ns[i][s]);
+      }
+    }
+  }
+  printf("\n%-14s", "whole frame");
+  for (size_t s = 0; s < SCENE_COUNT; s++) {
+    printf(" %13.1f", s_frame_ns[s]);
+  }
+  printf("\n%-14s %13.1f (tick handler and frame)\n", "minute tick", s_tick_frame_ns);
+}
+
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    fprintf(stderr, "usage: %s <golden dir> <output dir> [iterations]\n", argv[0]);
+    return 2;
+  }
+  s_golden_dir = argv[1];
+  s_out_dir = argv[2];
+  s_iterations = argc > 3 ? strtol(argv[3], NULL, 10) : RENDER_DEFAULT_ITERATIONS;
+  if (s_iterations <= 0) {
+    s_iterations = RENDER_DEFAULT_ITERATIONS;
+  }
+  const char *update = getenv("UPDATE_GOLDEN");
+  s_update_golden = update && update[0] && strcmp(update, "0") != 0;
+
+  stub_set_time(RENDER_START_TIME);
+  init();
+
+  for (size_t s = 0; s < SCENE_COUNT; s++) {
+    s_scenes[s].setup();
+    stub_render_window(stub_top_window());
+    check_frame(&s_scenes[s]);
+    time_frames(s);
+  }
+  time_tick_frames();
+  print_timing();
+
+  deinit();
+  if (s_mismatches) {
+    fprintf(stderr, "%d scene(s) differ from the golden images\n", s_mismatches);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,83 @@
+// Exhaustive host tests for src/c/fixed_units.c against a double-precision
+// reference: each integer conversion must equal lround() of the exact
+// real-valued result over its whole input range. Reference factors come from
+// the definitions (international mile and inch, 33.8639 hPa per inHg), scaled
+// to integers so each reference is a single correctly rounded division and
+// exact halves (e.g. 237.5) stay exact.
+#include <math.h>
+
+#include "fixed_units.h"
+
+static int s_failures = 0;
+
+// Report the first few mismatches of a sweep rather than thousands
+#define CHECK_SWEEP(name, from, to, actual_expr, reference_expr) do { \
+    int shown_ = 0; \
+    for (int32_t x = (from); x <= (to); x++) { \
+      long actual_ = (actual_expr); \
+      long expected_ = lround(reference_expr); \
+      if (actual_ != expected_) { \
+        s_failures++; \
+        if (shown_++ < 5) { \
+          fprintf(stderr, "%s(%ld): expected %ld, got %ld\n", (name), (long)x, expected_, actual_); \
+        } \
+      } \
+    } \
+  } while (0)
+
+static void test_div_round(void) {
+  CHECK_SWEEP("fixed_div_round/10", -100000, 100000, fixed_div_round(x, 10), x / 10.0);
+  CHECK_SWEEP("fixed_div_round/7", -100000, 100000, fixed_div_round(x, 7), x / 7.0);
+}
+
+static void test_step_distance(void) {
+  CHECK_SWEEP("steps->tenths_mile", 0, FIXED_MAX_STEPS, fixed_cm_to_tenths_mile(fixed_steps_to_cm(x)),
+              x * 7600.0 / 1609344);
+  CHECK_SWEEP("steps->tenths_km", 0, FIXED_MAX_STEPS, fixed_cm_to_tenths_km(fixed_steps_to_cm(x)),
+              x * 76.0 / 10000);
+
+  // Out of range step counts are clamped rather than overflowing
+  if (fixed_steps_to_cm(-1) != 0 || fixed_steps_to_cm(FIXED_MAX_STEPS + 1) != fixed_steps_to_cm(FIXED_MAX_STEPS)) {
+    fprintf(stderr, "fixed_steps_to_cm: out of range counts not clamped\n");
+    s_failures++;
+  }
+
+  // test_mileage.py's worked example: 2162 steps is 1.0 mi / 1.6 km once rounded
+  if (fixed_cm_to_tenths_mile(fixed_steps_to_cm(2162)) != 10 || fixed_cm_to_tenths_km(fixed_steps_to_cm(2162)) != 16) {
+    fprintf(stderr, "2162 steps: wrong distance\n");
+    s_failures++;
+  }
+}
+
+static void test_temperature(void) {
+  // -100.0 C to +100.0 C covers every reading Open-Meteo sends
+  CHECK_SWEEP("dc->celsius", -1000, 1000, fixed_dc_to_celsius(x), x / 10.0);
+  CHECK_SWEEP("dc->fahrenheit", -1000, 1000, fixed_dc_to_fahrenheit(x), (x * 18.0 + 3200) / 100);
+}
+
+static void test_pressure(void) {
+  // 0 to 1200.0 hPa
+  CHECK_SWEEP("dhpa->hpa", 0, 12000, fixed_dhpa_to_hpa(x), x / 10.0);
+}
+
+static void test_wind_precip(void) {
+  // The whole u16 range of the record fields
+  CHECK_SWEEP("dkmh->kph", 0, 0xFFFF, fixed_dkmh_to_kph(x), x / 10.0);
+  CHECK_SWEEP("dkmh->mph", 0, 0xFFFF, fixed_dkmh_to_mph(x), x * 100000.0 / 1609344);
+  CHECK_SWEEP("dmm->hundredths_inch", 0, 0xFFFF, fixed_dmm_to_hundredths_inch(x), x * 100.0 / 254);
+}
+
+int main(void) {
+  test_div_round();
+  test_step_distance();
+  test_temperature();
+  test_pressure();
+  test_wind_precip();
+
+  if (s_failures) {
+    fprintf(stderr, "%d failure(s)\n", s_failures);
+    return 1;
+  }
+  printf("test_fixed_units: all passed\n");
+  return 0;
+}
@@ -0,0 +1,116 @@
+// Host tests for src/c/fmt.c: every formatter must produce exactly what the
+// snprintf() format it replaced did, and report changes only when the text
+// in the buffer really changed.
+#include "fmt.h"
+
+static int s_failures = 0;
+
+#define EXPECT_STR(actual, expected) do { \
+    const char *a_ = (actual); \
+    if (strcmp(a_, (expected)) != 0) { \
+      fprintf(stderr, "%s:%d: expected \"%s\", got \"%s\"\n", __FILE__, __LINE__, (expected), a_); \
+      s_failures++; \
+    } \
+  } while (0)
+
+#define EXPECT_TRUE(cond) do { \
+    if (!(cond)) { \
+      fprintf(stderr, "%s:%d: expected %s\n", __FILE__, __LINE__, #cond); \
+      s_failures++; \
+    } \
+  } while (0)
+
+// Report the first few mismatches of a sweep rather than thousands
+#define CHECK_SWEEP(name, from, to, fmt_calls, ...) do { \
+    int shown_ = 0; \
+    for (int32_t x = (from); x <= (to); x++) { \
+      char actual_[32] = "", expected_[32]; \
+      Fmt fmt; \
+      fmt_begin(&fmt, actual_, sizeof(actual_)); \
+      fmt_calls; \
+      fmt_end(&fmt); \
+      snprintf(expected_, sizeof(expected_), __VA_ARGS__); \
+      if (strcmp(actual_, expected_) != 0) { \
+        s_failures++; \
+        if (shown_++ < 5) { \
+          fprintf(stderr, "%s(%ld): expected \"%s\", got \"%s\"\n", (name), (long)x, expected_, actual_); \
+        } \
+      } \
+    } \
+  } while (0)
+
+static void test_int(void) {
+  CHECK_SWEEP("int", -100000, 100000, fmt_int(&fmt, x), "%d", (int)x);
+  CHECK_SWEEP("int_width", -1000, 1000, fmt_int_width(&fmt, x, 2), "%02d", (int)x);
+
+  char text[16];
+  Fmt fmt;
+  fmt_begin(&fmt, text, sizeof(text));
+  fmt_int(&fmt, INT32_MIN);
+  fmt_char(&fmt, ' ');
+  fmt_int(&fmt, INT32_MAX);
+  fmt_end(&fmt);
+  EXPECT_STR(text, "-2147483648 214"); // Truncated to fit, like snprintf
+}
+
+static void test_fixed(void) {
+  // The formats the display used: "%d.%d mm", "%d.%02d in" and " %c%d.%d" trends
+  CHECK_SWEEP("fixed/1", 0, 0xFFFF, fmt_fixed(&fmt, x, 1), "%d.%d", (int)x / 10, (int)x % 10);
+  CHECK_SWEEP("fixed/2", 0, 0xFFFF, fmt_fixed(&fmt, x, 2), "%d.%02d", (int)x / 100, (int)x % 100);
+  CHECK_SWEEP("fixed_signed/1", -5000, 5000, fmt_fixed_signed(&fmt, x, 1), "%c%d.%d", x >= 0 ? '+' : '-',
+              abs((int)x) / 10, abs((int)x) % 10);
+  CHECK_SWEEP("fixed/1 negative", -5000, 0, fmt_fixed(&fmt, x, 1), "%s%d.%d", x < 0 ? "-" : "",
+              abs((int)x) / 10, abs((int)x) % 10);
+  CHECK_SWEEP("fixed/0", -1000, 1000, fmt_fixed(&fmt, x, 0), "%d", (int)x);
+}
+
+static void test_changes(void) {
+  char text[8] = "";
+  Fmt fmt;
+
+  fmt_begin(&fmt, text, sizeof(text));
+  fmt_str(&fmt, "10:42");
+  EXPECT_TRUE(fmt_end(&fmt));
+  EXPECT_STR(text, "10:42");
+
+  fmt_begin(&fmt, text, sizeof(text));
+  fmt_str(&fmt, "10:42");
+  EXPECT_TRUE(!fmt_end(&fmt));
+
+  // Shorter, longer, and the same length with one byte different
+  fmt_begin(&fmt, text, sizeof(text));
+  fmt_str(&fmt, "10:4");
+  EXPECT_TRUE(fmt_end(&fmt));
+  EXPECT_STR(text, "10:4");
+
+  fmt_begin(&fmt, text, sizeof(text));
+  fmt_str(&fmt, "10:42");
+  EXPECT_TRUE(fmt_end(&fmt));
+
+  fmt_begin(&fmt, text, sizeof(text));
+  fmt_strn(&fmt, "10:43 and more", 5);
+  EXPECT_TRUE(fmt_end(&fmt));
+  EXPECT_STR(text, "10:43");
+
+  // Text cut at the buffer's size only changes if the kept part does
+  fmt_begin(&fmt, text, sizeof(text));
+  fmt_str(&fmt, "10:43 am");
+  EXPECT_TRUE(fmt_end(&fmt));
+  EXPECT_STR(text, "10:43 a");
+  fmt_begin(&fmt, text, sizeof(text));
+  fmt_str(&fmt, "10:43 am!");
+  EXPECT_TRUE(!fmt_end(&fmt));
+}
+
+int main(void) {
+  test_int();
+  test_fixed();
+  test_changes();
+
+  if (s_failures) {
+    fprintf(stderr, "%d failure(s)\n", s_failures);
+    return 1;
+  }
+  printf("test_fmt: all passed\n");
+  return 0;
+}
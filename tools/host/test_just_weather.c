@@ -0,0 +1,710 @@
+// Host tests for src/c/just_weather.c, run against the SDK stand-in.
+// Drives the real handlers, so the tests cover the code that ships.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wreturn-type" // the watch's main() relies on C99's implicit return
+#define main just_weather_main
+#include "../../src/c/just_weather.c"
+#undef main
+#pragma GCC diagnostic pop
+
+#include "companion.h"
+
+static int s_failures = 0;
+
+#define EXPECT_STR(actual, expected) do { \
+    const char *a_ = (actual); \
+    if (!a_ || strcmp(a_, (expected)) != 0) { \
+      fprintf(stderr, "%s:%d: expected \"%s\", got \"%s\"\n", __FILE__, __LINE__, (expected), a_ ? a_ : "(null)"); \
+      s_failures++; \
+    } \
+  } while (0)
+
+#define EXPECT_TRUE(cond) do { \
+    if (!(cond)) { \
+      fprintf(stderr, "%s:%d: expected %s\n", __FILE__, __LINE__, #cond); \
+      s_failures++; \
+    } \
+  } while (0)
+
+#define DEFAULT_SETTINGS (WEATHER_SETTING_UPDATE_COUNTDOWN | WEATHER_SETTING_STEP_UNIT_MILES)
+
+static uint8_t s_buffer[1024];
+static DictionaryIterator s_iter;
+
+// What a row of the face shows, however it is drawn
+static const char *row_text(DataRow row) {
+  #if defined(SINGLE_DATA_LAYER)
+  return s_rows[row].text;
+  #else
+  return text_layer_get_text(s_row_layers[row]);
+  #endif
+}
+
+// Each save on the settings page is a new version; COMPANION_MAX_RECORD has 1
+static uint16_t s_settings_version = 1;
+
+static void deliver_settings(uint8_t units, uint8_t settings) {
+  companion_settings_message(&s_iter, s_buffer, sizeof(s_buffer), units, settings, ++s_settings_version);
+  stub_deliver_inbox(&s_iter);
+}
+
+static void test_weather_message(void) {
+  companion_weather_message(&s_iter, s_buffer, sizeof(s_buffer));
+  stub_deliver_inbox(&s_iter);
+
+  EXPECT_STR(row_text(ROW_LOCATION), "King's Lynn");
+  EXPECT_STR(row_text(ROW_CONDITIONS), "Partly Cloudy");
+  EXPECT_STR(row_text(ROW_PRESSURE), "18C • 1013 mb -0.8");
+  EXPECT_STR(row_text(ROW_WIND_PRECIP), "9 mph • 2.5 mm");
+  EXPECT_TRUE(s_last_weather_update == time(NULL));
+}
+
+static void test_units_converted_on_watch(void) {
+  deliver_settings(WEATHER_UNITS_FAHRENHEIT | WEATHER_UNITS_WIND_KPH | WEATHER_UNITS_PRECIP_INCHES,
+                   DEFAULT_SETTINGS);
+  EXPECT_STR(row_text(ROW_PRESSURE), "64F • 1013 mb -0.8");
+  EXPECT_STR(row_text(ROW_WIND_PRECIP), "15 kph • 0.10 in");
+  // Readings from the earlier message are kept
+  EXPECT_STR(row_text(ROW_CONDITIONS), "Partly Cloudy");
+
+  deliver_settings(0, DEFAULT_SETTINGS);
+  EXPECT_STR(row_text(ROW_PRESSURE), "18C • 1013 mb -0.8");
+}
+
+static void test_status_record(void) {
+  uint16_t present = WEATHER_FIELD_STATUS;
+  const uint8_t record[] = { WEATHER_RECORD_VERSION, 0, present & 0xFF, present >> 8,
+                             WEATHER_STATUS_HTTP_FAIL, 0xF8, 0x01 };
+  companion_record_message(&s_iter, s_buffer, sizeof(s_buffer), record, sizeof(record));
+  stub_deliver_inbox(&s_iter);
+  EXPECT_STR(row_text(ROW_CONDITIONS), "HTTP Fail 504");
+  EXPECT_STR(row_text(ROW_PRESSURE), "18C • 1013 mb -0.8");
+
+  // Truncated records are rejected without touching the display
+  companion_record_message(&s_iter, s_buffer, sizeof(s_buffer), COMPANION_WEATHER_RECORD, 10);
+  stub_deliver_inbox(&s_iter);
+  EXPECT_STR(row_text(ROW_CONDITIONS), "HTTP Fail 504");
+}
+
+static void test_delta_record(void) {
+  // Only the temperature changed: every other line comes from merged state
+  uint16_t present = WEATHER_FIELD_TEMPERATURE;
+  const uint8_t delta[] = { WEATHER_RECORD_VERSION, 0, present & 0xFF, present >> 8, 0xD2, 0x00 };
+  companion_record_message(&s_iter, s_buffer, sizeof(s_buffer), delta, sizeof(delta));
+  stub_deliver_inbox(&s_iter);
+  EXPECT_STR(row_text(ROW_PRESSURE), "21C • 1013 mb -0.8");
+  EXPECT_STR(row_text(ROW_LOCATION), "King's Lynn");
+  EXPECT_STR(row_text(ROW_WIND_PRECIP), "9 mph • 2.5 mm");
+
+  // A fetch that changed nothing still restarts the countdown
+  stub_set_time(1761820800 + 900);
+  const uint8_t unchanged[] = { WEATHER_RECORD_VERSION, WEATHER_RECORD_FLAG_FETCHED, 0, 0 };
+  companion_record_message(&s_iter, s_buffer, sizeof(s_buffer), unchanged, sizeof(unchanged));
+  stub_deliver_inbox(&s_iter);
+  EXPECT_TRUE(s_last_weather_update == time(NULL));
+
+  // A full resync drops the status and the stale temperature
+  companion_weather_message(&s_iter, s_buffer, sizeof(s_buffer));
+  stub_deliver_inbox(&s_iter);
+  EXPECT_STR(row_text(ROW_CONDITIONS), "Partly Cloudy");
+  EXPECT_STR(row_text(ROW_PRESSURE), "18C • 1013 mb -0.8");
+}
+
+static void test_largest_record_fits_inbox(void) {
+  EXPECT_TRUE(sizeof(COMPANION_MAX_RECORD) == WEATHER_RECORD_MAX_SIZE);
+  EXPECT_TRUE(stub_inbox_size() == dict_calc_buffer_size(1, FORECAST_TIMELINE_MAX_SIZE));
+  EXPECT_TRUE(FORECAST_TIMELINE_MAX_SIZE >= WEATHER_RECORD_MAX_SIZE);
+
+  companion_record_message(&s_iter, s_buffer, sizeof(s_buffer), COMPANION_MAX_RECORD, sizeof(COMPANION_MAX_RECORD));
+  stub_deliver_inbox(&s_iter);
+  EXPECT_STR(row_text(ROW_LOCATION), "Llanfairpwllgwyngyll-gogerychwy");
+
+  // One byte more than the watch keeps is rejected whole, not overrun
+  uint16_t present = WEATHER_FIELD_PRESSURE | WEATHER_FIELD_LOCATION;
+  uint8_t oversized[4 + 2 + 1 + WEATHER_RECORD_LOCATION_MAX + 1] = {
+    WEATHER_RECORD_VERSION, 0, present & 0xFF, present >> 8, 0x10, 0x27, WEATHER_RECORD_LOCATION_MAX + 1
+  };
+  memset(&oversized[7], 'x', WEATHER_RECORD_LOCATION_MAX + 1);
+  WeatherRecord before = s_weather;
+  companion_record_message(&s_iter, s_buffer, sizeof(s_buffer), oversized, sizeof(oversized));
+  stub_deliver_inbox(&s_iter);
+  EXPECT_STR(row_text(ROW_LOCATION), "Llanfairpwllgwyngyll-gogerychwy");
+  EXPECT_TRUE(memcmp(&s_weather, &before, sizeof(before)) == 0);
+
+  // Put back the usual state for the tests that follow
+  companion_weather_message(&s_iter, s_buffer, sizeof(s_buffer));
+  stub_deliver_inbox(&s_iter);
+  deliver_settings(0, DEFAULT_SETTINGS);
+}
+
+static void test_step_display(void) {
+  stub_set_health_steps(4500);
+
+  deliver_settings(0, DEFAULT_SETTINGS | WEATHER_SETTING_SHOW_STEPS);
+  EXPECT_STR(row_text(ROW_WIND_PRECIP), " 4500        2.1 mi");
+  EXPECT_TRUE(!layer_get_hidden(bitmap_layer_get_layer(s_shoe_icon_layer)));
+
+  deliver_settings(0, WEATHER_SETTING_UPDATE_COUNTDOWN | WEATHER_SETTING_SHOW_STEPS);
+  EXPECT_STR(row_text(ROW_WIND_PRECIP), " 4500        3.4 km");
+
+  deliver_settings(0, DEFAULT_SETTINGS);
+  EXPECT_TRUE(layer_get_hidden(bitmap_layer_get_layer(s_shoe_icon_layer)));
+  EXPECT_STR(row_text(ROW_WIND_PRECIP), "9 mph • 2.5 mm");
+
+  // With steps already off there is nothing to log
+  stub_reset_stats();
+  update_step_display();
+  EXPECT_TRUE(g_stub_stats.logs == 0);
+}
+
+static void test_redraw_only_on_change(void) {
+  struct tm tick = { .tm_hour = 10, .tm_min = 41 };
+
+  // A repeated record redraws nothing
+  companion_weather_message(&s_iter, s_buffer, sizeof(s_buffer));
+  stub_deliver_inbox(&s_iter);
+  stub_reset_stats();
+  companion_weather_message(&s_iter, s_buffer, sizeof(s_buffer));
+  stub_deliver_inbox(&s_iter);
+  EXPECT_TRUE(g_stub_stats.dirty_marks == 0);
+
+  stub_set_health_steps(4500);
+  deliver_settings(0, DEFAULT_SETTINGS | WEATHER_SETTING_SHOW_STEPS);
+  stub_fire_tick(&tick, MINUTE_UNIT);
+
+  // Same minute, same steps, same dot: nothing to redraw
+  stub_reset_stats();
+  stub_fire_tick(&tick, MINUTE_UNIT);
+  EXPECT_TRUE(g_stub_stats.dirty_marks == 0);
+  EXPECT_TRUE(g_stub_stats.frame_sets == 0);
+
+  // Only the changed line is redrawn, and the tick leaves Health alone
+  stub_set_health_steps(4510);
+  tick.tm_min = 42;
+  stub_reset_stats();
+  stub_fire_tick(&tick, MINUTE_UNIT);
+  EXPECT_TRUE(g_stub_stats.dirty_marks == 1);
+  EXPECT_TRUE(g_stub_stats.health_queries == 0);
+
+  // The hourly count covers what was redrawn since the last hour
+  tick.tm_hour = 11;
+  tick.tm_min = 0;
+  stub_fire_tick(&tick, MINUTE_UNIT | HOUR_UNIT);
+  EXPECT_TRUE(s_redraws_last_hour > 0);
+
+  deliver_settings(0, DEFAULT_SETTINGS);
+}
+
+static void test_clock_format(void) {
+  struct tm tick = { .tm_hour = 0, .tm_min = 5 };
+  stub_fire_tick(&tick, MINUTE_UNIT);
+  EXPECT_STR(row_text(ROW_TIME), "00:05");
+
+  // strftime's "%I": 12 at midnight and noon, leading zero kept
+  stub_set_24h_style(false);
+  stub_fire_tick(&tick, MINUTE_UNIT);
+  EXPECT_STR(row_text(ROW_TIME), "12:05");
+  tick.tm_hour = 13;
+  tick.tm_min = 30;
+  stub_fire_tick(&tick, MINUTE_UNIT);
+  EXPECT_STR(row_text(ROW_TIME), "01:30");
+  stub_set_24h_style(true);
+}
+
+static void test_step_events(void) {
+  stub_set_health_steps(4500);
+  deliver_settings(0, DEFAULT_SETTINGS | WEATHER_SETTING_SHOW_STEPS);
+  EXPECT_TRUE(stub_health_subscribed());
+  EXPECT_STR(row_text(ROW_WIND_PRECIP), " 4500        2.1 mi");
+
+  // A burst of movement updates is one query once the coalescing timer fires
+  stub_set_health_steps(4520);
+  stub_reset_stats();
+  stub_fire_health_event(HealthEventMovementUpdate);
+  stub_fire_health_event(HealthEventMovementUpdate);
+  stub_fire_health_event(HealthEventMovementUpdate);
+  EXPECT_TRUE(g_stub_stats.health_queries == 0);
+  stub_advance_timers(STEP_COALESCE_MS);
+  EXPECT_TRUE(g_stub_stats.health_queries == 1);
+  EXPECT_STR(row_text(ROW_WIND_PRECIP), " 4520        2.1 mi");
+
+  // Below the minimum delta the line is left alone
+  stub_set_health_steps(4520 + STEP_REDRAW_MIN_DELTA - 1);
+  stub_reset_stats();
+  stub_fire_health_event(HealthEventMovementUpdate);
+  stub_advance_timers(STEP_COALESCE_MS);
+  EXPECT_TRUE(g_stub_stats.dirty_marks == 0);
+
+  // ...unless Health says something significant changed, e.g. a new day
+  stub_set_health_steps(0);
+  stub_fire_health_event(HealthEventSignificantUpdate);
+  EXPECT_STR(row_text(ROW_WIND_PRECIP), " 0        0.0 mi");
+
+  deliver_settings(0, DEFAULT_SETTINGS);
+  EXPECT_TRUE(!stub_health_subscribed());
+}
+
+static bool screen_pixel_dark(GPoint point) {
+  const GBitmap *screen = stub_framebuffer();
+  const uint8_t *row = gbitmap_get_data(screen) + point.y * gbitmap_get_bytes_per_row(screen);
+  if (gbitmap_get_format(screen) == GBitmapFormat8Bit) {
+    return row[point.x] == GColorBlack.argb;
+  }
+  return !((row[point.x / 8] >> (point.x % 8)) & 1);
+}
+
+// The screen shows the first filled_dots dots filled and the rest as outlines.
+// A filled dot reaches two pixels above the line, an outline only one.
+static bool progress_dots_shown(int filled_dots) {
+  GRect bounds = layer_get_bounds(s_update_progress_layer);
+  int line_y = bounds.size.h / 2;
+  for (int i = 0; i < PROGRESS_DOTS; i++) {
+    int dot_x = progress_dots_start_x(bounds) + i * PROGRESS_DOT_SPACING;
+    GPoint top = layer_convert_point_to_screen(s_update_progress_layer, GPoint(dot_x, line_y - 2));
+    GPoint ring = layer_convert_point_to_screen(s_update_progress_layer, GPoint(dot_x, line_y - 1));
+    if (screen_pixel_dark(top) != (i < filled_dots) || !screen_pixel_dark(ring)) {
+      fprintf(stderr, "progress dot %d of %d filled is wrong\n", i, filled_dots);
+      return false;
+    }
+  }
+  return true;
+}
+
+static void test_progress_strip(void) {
+  // The first frame renders both strips once
+  stub_reset_stats();
+  stub_render_window(stub_top_window());
+  EXPECT_TRUE(g_stub_stats.frame_captures == 2);
+  EXPECT_TRUE(s_progress_strip_filled != NULL && s_progress_strip_empty != NULL);
+
+  // Later frames blit them, split after the last filled dot
+  s_last_weather_update = time(NULL) - 7 * 60;
+  s_next_fetch_time = s_last_weather_update + 15 * 60;
+  stub_reset_stats();
+  progress_layer_draw(s_update_progress_layer, stub_graphics_context());
+  EXPECT_TRUE(g_stub_stats.frame_captures == 0);
+  EXPECT_TRUE(g_stub_stats.draw_calls == 2);
+  GRect filled = gbitmap_get_bounds(s_progress_strip_filled);
+  EXPECT_TRUE(filled.size.w == progress_dots_start_x(layer_get_bounds(s_update_progress_layer)) + 7 * 8 - 4);
+
+  s_last_weather_update = time(NULL);
+  stub_reset_stats();
+  progress_layer_draw(s_update_progress_layer, stub_graphics_context());
+  EXPECT_TRUE(g_stub_stats.draw_calls == 1);
+
+  // What the blits put on screen matches the dots for the elapsed time,
+  // including the last one held empty when the fetch is late
+  static const struct { int elapsed_min; int filled; } cases[] = {
+    { 0, 0 }, { 1, 1 }, { 7, 7 }, { 14, 14 }, { 20, 14 }, { 3, 3 },
+  };
+  time_t now = time(NULL);
+  for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+    s_last_weather_update = now - cases[i].elapsed_min * 60;
+    s_next_fetch_time = s_last_weather_update + 15 * 60;
+    stub_render_window(stub_top_window());
+    EXPECT_TRUE(progress_dots_shown(cases[i].filled));
+  }
+  s_last_weather_update = now;
+  s_next_fetch_time = 0;
+}
+
+static void test_countdown_follows_schedule(void) {
+  // An hour until the next fetch: a dot every 4 minutes
+  time_t now = time(NULL);
+  uint16_t present = WEATHER_FIELD_NEXT_FETCH;
+  const uint8_t record[] = { WEATHER_RECORD_VERSION, WEATHER_RECORD_FLAG_FETCHED, present & 0xFF, present >> 8,
+                             0x10, 0x0E };
+  companion_record_message(&s_iter, s_buffer, sizeof(s_buffer), record, sizeof(record));
+  stub_deliver_inbox(&s_iter);
+  EXPECT_TRUE(s_next_fetch_time == now + 3600);
+  EXPECT_TRUE(s_shown_filled_dots == 0);
+
+  stub_set_time(now + 28 * 60);
+  EXPECT_TRUE(progress_filled_dots() == 7);
+  // An overdue fetch leaves the line one dot short of full rather than wrapping
+  stub_set_time(now + 2 * 3600);
+  EXPECT_TRUE(progress_filled_dots() == PROGRESS_DOTS - 1);
+
+  // Without a deadline the countdown runs over 15 minutes
+  stub_set_time(now);
+  const uint8_t fetched[] = { WEATHER_RECORD_VERSION, WEATHER_RECORD_FLAG_FETCHED, 0, 0 };
+  companion_record_message(&s_iter, s_buffer, sizeof(s_buffer), fetched, sizeof(fetched));
+  stub_deliver_inbox(&s_iter);
+  stub_set_time(now + 7 * 60);
+  EXPECT_TRUE(progress_filled_dots() == 7);
+  stub_set_time(now);
+}
+
+static void test_forecast_steps_without_phone(void) {
+  const time_t start = 1761820800;
+  stub_set_time(start);
+  companion_weather_message(&s_iter, s_buffer, sizeof(s_buffer));
+  stub_deliver_inbox(&s_iter);
+  companion_forecast_message(&s_iter, s_buffer, sizeof(s_buffer));
+  stub_deliver_inbox(&s_iter);
+  EXPECT_TRUE(s_forecast.count == 3);
+  EXPECT_STR(row_text(ROW_CONDITIONS), "Partly Cloudy");
+
+  stub_set_time(start + 15 * 60);
+  step_forecast();
+  EXPECT_STR(row_text(ROW_CONDITIONS), "Slight Rain");
+  EXPECT_STR(row_text(ROW_PRESSURE), "15C • 1013 mb -0.8");
+
+  // Steps missed while asleep are skipped to the one in effect now
+  stub_set_time(start + 70 * 60);
+  step_forecast();
+  EXPECT_STR(row_text(ROW_CONDITIONS), "Overcast");
+  EXPECT_STR(row_text(ROW_PRESSURE), "13C • 1013 mb -0.8");
+  EXPECT_STR(row_text(ROW_WIND_PRECIP), "9 mph • 0.4 mm");
+  EXPECT_TRUE(s_forecast.count == 1);
+
+  // A fetch is newer than every step already passed. Its delta leaves out
+  // what has not changed since the last fetch, which shows again.
+  uint16_t present = WEATHER_FIELD_PRESSURE;
+  const uint8_t delta[] = { WEATHER_RECORD_VERSION, WEATHER_RECORD_FLAG_FETCHED, present & 0xFF, present >> 8,
+                            0x9e, 0x27 };
+  companion_record_message(&s_iter, s_buffer, sizeof(s_buffer), delta, sizeof(delta));
+  stub_deliver_inbox(&s_iter);
+  step_forecast();
+  EXPECT_STR(row_text(ROW_CONDITIONS), "Partly Cloudy");
+  EXPECT_STR(row_text(ROW_PRESSURE), "18C • 1014 mb -0.8");
+  EXPECT_STR(row_text(ROW_WIND_PRECIP), "9 mph • 2.5 mm");
+  companion_weather_message(&s_iter, s_buffer, sizeof(s_buffer));
+  stub_deliver_inbox(&s_iter);
+
+  // Bad timelines leave the current one alone
+  const uint8_t short_timeline[] = { FORECAST_TIMELINE_VERSION, 0, 0, 0, 0, 2, 0, 1 };
+  EXPECT_TRUE(!forecast_timeline_decode(short_timeline, sizeof(short_timeline), &s_forecast));
+  EXPECT_TRUE(s_forecast.count == 1);
+}
+
+// A fetch that only changed the pressure
+static void deliver_pressure(int16_t pressure_dhpa) {
+  uint16_t present = WEATHER_FIELD_PRESSURE;
+  const uint8_t record[] = { WEATHER_RECORD_VERSION, WEATHER_RECORD_FLAG_FETCHED, present & 0xFF, present >> 8,
+                             pressure_dhpa & 0xFF, (pressure_dhpa >> 8) & 0xFF };
+  companion_record_message(&s_iter, s_buffer, sizeof(s_buffer), record, sizeof(record));
+  stub_deliver_inbox(&s_iter);
+}
+
+static void test_storm_warning_from_history(void) {
+  // A day on, so the earlier tests' readings are out of the 3-hour window
+  const time_t start = 1761820800 + 24 * 60 * 60;
+  deliver_settings(0, DEFAULT_SETTINGS | WEATHER_SETTING_STORM_WARNING);
+  stub_reset_stats();
+
+  stub_set_time(start);
+  deliver_pressure(10130);
+  EXPECT_STR(row_text(ROW_CONDITIONS), "Partly Cloudy");
+
+  // Falling 1.2 mb in an hour warns before there are 3 hours of history
+  stub_set_time(start + 60 * 60);
+  deliver_pressure(10118);
+  EXPECT_STR(row_text(ROW_CONDITIONS), "⚠️ STORM WARNING");
+  EXPECT_TRUE(g_stub_stats.vibes == 1);
+
+  // The watch's own 3-hour trend replaces the companion's once it has 2 hours
+  stub_set_time(start + 2 * 60 * 60);
+  deliver_pressure(10106);
+  EXPECT_STR(row_text(ROW_PRESSURE), "18C • 1011 mb -3.6 ⚠️");
+
+  // Still falling, but only 2.2 mb in 3 hours: hysteresis holds the warning
+  stub_set_time(start + 4 * 60 * 60);
+  deliver_pressure(10096);
+  EXPECT_STR(row_text(ROW_CONDITIONS), "⚠️ STORM WARNING");
+  EXPECT_TRUE(g_stub_stats.vibes == 1);
+
+  stub_set_time(start + 5 * 60 * 60);
+  deliver_pressure(10100);
+  EXPECT_STR(row_text(ROW_CONDITIONS), "Partly Cloudy");
+  EXPECT_STR(row_text(ROW_PRESSURE), "18C • 1010 mb -0.6");
+
+  // A reading within the minimum spacing replaces the newest sample but
+  // keeps its time, so the trend is not stretched to now
+  stub_set_time(start + 5 * 60 * 60 + 5 * 60);
+  deliver_pressure(10100);
+  uint8_t newest = (s_pressure_history.head + s_pressure_history.count - 1) % PRESSURE_HISTORY_SAMPLES;
+  EXPECT_TRUE(s_pressure_history.samples[newest].time == start + 5 * 60 * 60);
+  EXPECT_STR(row_text(ROW_PRESSURE), "18C • 1010 mb -0.6");
+
+  // A full resync between fetches brings the companion's trend, not a reading
+  uint8_t resync[sizeof(COMPANION_WEATHER_RECORD)];
+  memcpy(resync, COMPANION_WEATHER_RECORD, sizeof(resync));
+  resync[1] = WEATHER_RECORD_FLAG_FULL;
+  resync[7] = 10100 & 0xFF;
+  resync[8] = 10100 >> 8;
+  companion_record_message(&s_iter, s_buffer, sizeof(s_buffer), resync, sizeof(resync));
+  stub_deliver_inbox(&s_iter);
+  EXPECT_STR(row_text(ROW_PRESSURE), "18C • 1010 mb -0.6");
+
+  // The companion sends no trend of its own: a full resync without one
+  // still shows the watch's
+  uint16_t present = WEATHER_FIELD_PRESSURE | WEATHER_FIELD_TEMPERATURE;
+  const uint8_t no_trend[] = { WEATHER_RECORD_VERSION, WEATHER_RECORD_FLAG_FULL, present & 0xFF, present >> 8,
+                               10100 & 0xFF, 10100 >> 8, 0xb0, 0x00 };
+  companion_record_message(&s_iter, s_buffer, sizeof(s_buffer), no_trend, sizeof(no_trend));
+  stub_deliver_inbox(&s_iter);
+  EXPECT_STR(row_text(ROW_PRESSURE), "18C • 1010 mb -0.6");
+
+  // The history survives a restart
+  PressureHistory saved = s_pressure_history;
+  pressure_history_clear(&s_pressure_history);
+  restore_pressure_history();
+  EXPECT_TRUE(s_pressure_history.count == saved.count);
+
+  // Put back the usual state for the tests that follow
+  pressure_history_clear(&s_pressure_history);
+  persist_delete(PERSIST_KEY_PRESSURE);
+  deliver_settings(0, DEFAULT_SETTINGS);
+  companion_weather_message(&s_iter, s_buffer, sizeof(s_buffer));
+  stub_deliver_inbox(&s_iter);
+}
+
+static void test_countdown_toggle(void) {
+  GRect pressure = get_row_frame(ROW_PRESSURE);
+  GRect wind = get_row_frame(ROW_WIND_PRECIP);
+  deliver_settings(0, WEATHER_SETTING_STEP_UNIT_MILES);
+  EXPECT_TRUE(s_update_progress_layer == NULL);
+
+  // Back where main_window_load put them
+  deliver_settings(0, DEFAULT_SETTINGS);
+  EXPECT_TRUE(s_update_progress_layer != NULL);
+  GRect pressure_after = get_row_frame(ROW_PRESSURE);
+  GRect wind_after = get_row_frame(ROW_WIND_PRECIP);
+  EXPECT_TRUE(grect_equal(&pressure, &pressure_after));
+  EXPECT_TRUE(grect_equal(&wind, &wind_after));
+}
+
+// A resync, or a resend after a lost ACK, repeats a settings version the
+// watch already applied
+static void test_settings_version_applied_once(void) {
+  stub_reset_stats();
+  deliver_settings(0, DEFAULT_SETTINGS);
+  uint32_t applied_logs = g_stub_stats.logs;
+
+  stub_reset_stats();
+  companion_settings_message(&s_iter, s_buffer, sizeof(s_buffer), 0, DEFAULT_SETTINGS, s_settings_version);
+  stub_deliver_inbox(&s_iter);
+  EXPECT_TRUE(g_stub_stats.logs < applied_logs);
+  EXPECT_TRUE(s_weather.settings_version == s_settings_version);
+  EXPECT_TRUE(s_update_progress_layer != NULL);
+}
+
+static uint8_t pending_power_mode(void) {
+  DictionaryIterator *sent = stub_outbox_pending();
+  Tuple *mode = sent ? dict_find(sent, MESSAGE_KEY_POWER_MODE) : NULL;
+  return mode ? mode->value->uint8 : 0xFF;
+}
+
+// A low battery quiets Health and the countdown and tells the companion;
+// the charger ends it, and the setting forces it on battery
+static void test_low_power_mode(void) {
+  stub_complete_outbox(true); // The mode sent at startup
+  EXPECT_TRUE(s_power_mode_acked && !s_low_power);
+  companion_weather_message(&s_iter, s_buffer, sizeof(s_buffer));
+  stub_deliver_inbox(&s_iter);
+  stub_set_health_steps(4500);
+  deliver_settings(0, DEFAULT_SETTINGS | WEATHER_SETTING_SHOW_STEPS);
+  EXPECT_TRUE(stub_health_subscribed());
+
+  stub_set_battery((BatteryChargeState){ .charge_percent = 30 });
+  EXPECT_TRUE(!s_low_power);
+  stub_set_battery((BatteryChargeState){ .charge_percent = 20 });
+  EXPECT_TRUE(s_low_power);
+  EXPECT_TRUE(!stub_health_subscribed());
+  EXPECT_TRUE(pending_power_mode() == 1);
+  stub_complete_outbox(true);
+  EXPECT_TRUE(s_power_mode_acked);
+
+  // Only the time is redrawn on the minute
+  time_t now = time(NULL);
+  int filled_dots = s_shown_filled_dots;
+  stub_set_time(now + 10 * 60);
+  struct tm tick = { .tm_hour = 11, .tm_min = 40 };
+  stub_reset_stats();
+  stub_fire_tick(&tick, MINUTE_UNIT);
+  EXPECT_TRUE(g_stub_stats.dirty_marks == 1);
+  EXPECT_TRUE(g_stub_stats.health_queries == 0);
+  EXPECT_TRUE(s_shown_filled_dots == filled_dots);
+
+  // A reading a step higher is not enough to leave
+  stub_set_battery((BatteryChargeState){ .charge_percent = 30 });
+  EXPECT_TRUE(s_low_power);
+  stub_set_battery((BatteryChargeState){ .charge_percent = 30, .is_plugged = true });
+  EXPECT_TRUE(!s_low_power);
+  EXPECT_TRUE(stub_health_subscribed());
+  EXPECT_TRUE(s_shown_filled_dots == progress_filled_dots() && s_shown_filled_dots != filled_dots);
+  EXPECT_TRUE(pending_power_mode() == 0);
+
+  // Not delivered: sent again once the phone is heard from
+  stub_complete_outbox(false);
+  EXPECT_TRUE(stub_outbox_pending() == NULL);
+  deliver_settings(0, DEFAULT_SETTINGS);
+  EXPECT_TRUE(pending_power_mode() == 0);
+  stub_complete_outbox(true);
+  EXPECT_TRUE(s_power_mode_acked);
+
+  stub_set_battery((BatteryChargeState){ .charge_percent = 80 });
+  deliver_settings(0, DEFAULT_SETTINGS | WEATHER_SETTING_POWER_SAVE);
+  EXPECT_TRUE(s_low_power);
+  // Changed back before the first message was answered: the second follows it
+  deliver_settings(0, DEFAULT_SETTINGS);
+  EXPECT_TRUE(!s_low_power && pending_power_mode() == 1);
+  stub_complete_outbox(true);
+  EXPECT_TRUE(!s_power_mode_acked && pending_power_mode() == 0);
+  stub_complete_outbox(true);
+  EXPECT_TRUE(s_power_mode_acked);
+
+  stub_set_battery((BatteryChargeState){ .charge_percent = 100 });
+  stub_set_time(now);
+}
+
+// A launch into low power tells the companion straight away. The saved
+// settings are applied before the window loads, so the mode is first sent
+// from there and AppMessage must already be open.
+static void test_power_mode_at_launch(void) {
+  stub_set_battery((BatteryChargeState){ .charge_percent = 15 });
+  stub_complete_outbox(true);
+  EXPECT_TRUE(s_low_power && s_power_mode_acked);
+
+  deinit();
+  stub_close_app_message();
+  s_low_power = false;
+  s_power_mode_acked = false;
+  s_power_mode_in_flight = false;
+  stub_reset_stats();
+  init();
+  EXPECT_TRUE(s_low_power && pending_power_mode() == 1);
+  EXPECT_TRUE(g_stub_stats.outbox_sends == 1);
+  EXPECT_TRUE(g_stub_stats.warnings == 0);
+  stub_complete_outbox(true);
+
+  stub_set_battery((BatteryChargeState){ .charge_percent = 100 });
+  stub_complete_outbox(true);
+  EXPECT_TRUE(!s_low_power && s_power_mode_acked);
+}
+
+#if defined(SINGLE_DATA_LAYER)
+// Only the rows that changed are measured and drawn, and the frame comes out
+// the same as redrawing every row
+static void test_data_layer_partial_redraw(void) {
+  struct tm tick = { .tm_hour = 9, .tm_min = 59 };
+  stub_fire_tick(&tick, MINUTE_UNIT);
+  stub_render_window(stub_top_window());
+  stub_reset_stats();
+  stub_render_window(stub_top_window());
+  EXPECT_TRUE(g_stub_stats.text_draws == 0);
+
+  tick.tm_hour = 10;
+  tick.tm_min = 0;
+  stub_fire_tick(&tick, MINUTE_UNIT);
+  stub_reset_stats();
+  stub_render_window(stub_top_window());
+  EXPECT_TRUE(g_stub_stats.text_measures == 1);
+  EXPECT_TRUE(g_stub_stats.text_draws == 1);
+
+  // A shorter location leaves nothing of the longer one behind
+  set_row_text_copy(ROW_LOCATION, s_location_buffer, sizeof(s_location_buffer), "Ely");
+  stub_render_window(stub_top_window());
+  const GBitmap *screen = stub_framebuffer();
+  size_t size = gbitmap_get_bytes_per_row(screen) * gbitmap_get_bounds(screen).size.h;
+  uint8_t *partial = malloc(size);
+  memcpy(partial, gbitmap_get_data(screen), size);
+  main_window_appear(s_main_window);
+  stub_render_window(stub_top_window());
+  EXPECT_TRUE(memcmp(partial, gbitmap_get_data(screen), size) == 0);
+  free(partial);
+
+  set_row_text_copy(ROW_LOCATION, s_location_buffer, sizeof(s_location_buffer), "King's Lynn");
+}
+
+// A notification drew over the face: only the changed rows would be
+// repainted, so regaining focus repaints them all
+static void test_focus_repaints_rows(void) {
+  stub_render_window(stub_top_window());
+  const GBitmap *screen = stub_framebuffer();
+  uint8_t *data = gbitmap_get_data(screen);
+  size_t size = gbitmap_get_bytes_per_row(screen) * gbitmap_get_bounds(screen).size.h;
+  uint8_t *clean = malloc(size);
+  memcpy(clean, data, size);
+
+  memset(data, 0, size);
+  stub_render_window(stub_top_window());
+  EXPECT_TRUE(memcmp(clean, data, size) != 0);
+
+  stub_fire_focus(false);
+  stub_fire_focus(true);
+  stub_render_window(stub_top_window());
+  EXPECT_TRUE(memcmp(clean, data, size) == 0);
+  free(clean);
+}
+#endif
+
+static void test_restart_restores_weather(void) {
+  time_t fetched = s_last_weather_update;
+  deinit();
+
+  // A fresh launch starts from zeroed statics; only persistent storage survives
+  memset(&s_weather, 0, sizeof(s_weather));
+  memset(s_location_buffer, 0, sizeof(s_location_buffer));
+  s_last_weather_update = 0;
+  s_update_countdown_enabled = true;
+  forecast_timeline_clear(&s_forecast);
+
+  stub_set_time(fetched + 2 * 60 * 60 + 60);
+  init();
+  EXPECT_TRUE(s_forecast.count > 0);
+  EXPECT_STR(row_text(ROW_LOCATION), "King's Lynn");
+  EXPECT_STR(row_text(ROW_PRESSURE), "18C • 1013 mb -0.8");
+  EXPECT_STR(row_text(ROW_CONDITIONS), "Partly Cloudy (2h)");
+  EXPECT_STR(row_text(ROW_WIND_PRECIP), "9 mph • 2.5 mm");
+  EXPECT_TRUE(s_last_weather_update == fetched);
+
+  // The next fetch clears the age
+  companion_weather_message(&s_iter, s_buffer, sizeof(s_buffer));
+  stub_deliver_inbox(&s_iter);
+  EXPECT_STR(row_text(ROW_CONDITIONS), "Partly Cloudy");
+
+  // Nothing saved: the usual placeholders
+  deinit();
+  stub_persist_clear();
+  memset(&s_weather, 0, sizeof(s_weather));
+  init();
+  EXPECT_STR(row_text(ROW_PRESSURE), "Loading...");
+}
+
+int main(void) {
+  stub_set_time(1761820800);
+  init();
+
+  test_weather_message();
+  test_units_converted_on_watch();
+  test_status_record();
+  test_delta_record();
+  test_largest_record_fits_inbox();
+  test_step_display();
+  test_redraw_only_on_change();
+  test_clock_format();
+  test_step_events();
+  test_progress_strip();
+  test_countdown_follows_schedule();
+  test_forecast_steps_without_phone();
+  test_storm_warning_from_history();
+  test_countdown_toggle();
+  test_settings_version_applied_once();
+  test_low_power_mode();
+  test_power_mode_at_launch();
+#if defined(SINGLE_DATA_LAYER)
+  test_data_layer_partial_redraw();
+  test_focus_repaints_rows();
+#endif
+  test_restart_restores_weather();
+
+  deinit();
+  if (s_failures) {
+    fprintf(stderr, "%d failure(s)\n", s_failures);
+    return 1;
+  }
+  printf("test_just_weather: all passed\n");
+  return 0;
+}
@@ -0,0 +1,259 @@
+// The proxy's routes, built per process by server.js:
+//  GET /weather?lat=<lat>&lon=<lon>
+//  GET /reverse-geocode?lat=<lat>&lon=<lon>
+//  GET /conditions?lat=<lat>&lon=<lon>   -> { weather, place } from one call, cached
+//  GET /compact?lat=<lat>&lon=<lon>[&format=record][&temperature_unit=fahrenheit]
+//      [&wind_unit=kph][&precipitation_unit=inches]
+//      -> only the readings the watch shows, as fixed-point JSON or, with
+//         format=record, the watch's weather record bytes. Cached like /conditions.
+//  GET /metrics   -> Prometheus text: route and upstream latency, cache hit
+//                   ratio, in-flight requests; summed over all workers
+//
+// Upstream requests reuse keep-alive sockets and go through a circuit
+// breaker per upstream: after repeated failures that upstream is not asked
+// for a while, and cached answers are served stale (see conditions.js).
+
+const express = require('express');
+const fetch = require('node-fetch');
+const { createConditions, weatherUrl, placeUrl, OPEN_METEO_BASE, GEOCODE_BASE } = require('./conditions');
+const { parseUnits, readings, compactJson, packRecord } = require('./compact');
+const { Registry, mergeSnapshots, render } = require('./metrics');
+const { keepAliveAgents, upstreamName, CircuitBreaker, CircuitOpenError, CLOSED } = require('./upstream');
+
+const UPSTREAM_TIMEOUT_MS = parseInt(process.env.UPSTREAM_TIMEOUT_MS || '5000', 10);
+
+// The ratio is derived after summing the workers' lookup counts
+function withHitRatio(families) {
+  const lookups = families.find((f) => f.name === 'proxy_cache_lookups_total');
+  if (!lookups) return families;
+  const byCache = {};
+  for (const { labels, state } of lookups.series) {
+    const c = byCache[labels.cache] || (byCache[labels.cache] = { answered: 0, total: 0 });
+    if (labels.result === 'hit' || labels.result === 'stale') c.answered += state.value;
+    c.total += state.value;
+  }
+  return families.concat([{
+    type: 'gauge',
+    name: 'proxy_cache_hit_ratio',
+    help: 'Share of lookups answered from the cache, fresh or stale',
+    series: Object.keys(byCache).map((cache) => ({
+      labels: { cache },
+      state: { value: byCache[cache].total > 0 ? byCache[cache].answered / byCache[cache].total : 0 }
+    }))
+  }]);
+}
+
+// options.createCache(name): cache for each resource, as createConditions().
+// options.gatherMetrics(registry): Promise of the snapshots to report, by
+// default just this process's. Returns { app, metrics, drain, close }; for shutdown,
+// drain() asks clients not to reuse their connections, close() releases the
+// upstream sockets once the last request is answered.
+function createApp(options = {}) {
+  const app = express();
+  const gatherMetrics = options.gatherMetrics || (async (registry) => [registry.snapshot()]);
+  let closing = false;
+
+  app.use(function(req, res, next) {
+    res.header('Access-Control-Allow-Origin', '*');
+    res.header('Access-Control-Allow-Methods', 'GET');
+    res.header('Access-Control-Allow-Headers', 'Content-Type');
+    next();
+  });
+
+  // --- Metrics --- //
+
+  const metrics = new Registry();
+  const httpDuration = metrics.histogram('proxy_http_request_duration_seconds',
+    'Time to answer a request, by route and status code');
+  const httpInFlight = metrics.gauge('proxy_http_requests_in_flight', 'Requests being answered');
+  const upstreamDuration = metrics.histogram('proxy_upstream_request_duration_seconds',
+    'Time for an upstream request, by upstream and outcome');
+  const upstreamInFlight = metrics.gauge('proxy_upstream_requests_in_flight',
+    'Upstream requests awaiting an answer, by upstream');
+  const cacheLookups = metrics.counter('proxy_cache_lookups_total',
+    'Cache lookups by cache and result: hit, stale (answered while refreshing), miss (loaded upstream) or coalesced (joined a load)');
+  const cacheEntries = metrics.gauge('proxy_cache_entries', 'Entries held, by cache');
+  // Summed over workers, each of which keeps its own breakers
+  const circuitOpen = metrics.gauge('proxy_upstream_circuit_open',
+    'Processes whose circuit breaker for the upstream is open or half-open');
+  const upstreamRejected = metrics.counter('proxy_upstream_rejected_total',
+    'Upstream requests not sent because the circuit was open');
+
+  app.use(function(req, res, next) {
+    // Draining for shutdown: finish this request, then drop the connection
+    if (closing) res.set('Connection', 'close');
+    if (req.path === '/metrics') return next();
+    httpInFlight.inc();
+    const done = httpDuration.startTimer();
+    // 'close' also fires when the client gives up before the answer
+    res.once('close', () => {
+      httpInFlight.dec();
+      done({ route: req.route ? req.route.path : 'unmatched', code: res.statusCode });
+    });
+    next();
+  });
+
+  // --- Upstream --- //
+
+  const agent = keepAliveAgents();
+  const breakers = {};
+
+  function breakerFor(name) {
+    if (!breakers[name]) breakers[name] = new CircuitBreaker(name);
+    return breakers[name];
+  }
+
+  async function timedUpstream(labels, request) {
+    upstreamInFlight.inc(labels);
+    const done = upstreamDuration.startTimer(labels);
+    try {
+      const value = await request();
+      done({ outcome: 'ok' });
+      return value;
+    } catch (e) {
+      done({ outcome: 'error' });
+      throw e;
+    } finally {
+      upstreamInFlight.dec(labels);
+    }
+  }
+
+  // One upstream request, resolving to { ok, status, text }. Network errors,
+  // timeouts and 5xx answers reject and count against the upstream's breaker.
+  async function upstreamRequest(url) {
+    const labels = { upstream: upstreamName(url) };
+    try {
+      return await breakerFor(labels.upstream).run(() => timedUpstream(labels, async () => {
+        const res = await fetch(url, { agent, timeout: UPSTREAM_TIMEOUT_MS });
+        if (res.status >= 500) throw new Error(`upstream HTTP ${res.status}`);
+        return { ok: res.ok, status: res.status, text: await res.text() };
+      }));
+    } catch (e) {
+      if (e instanceof CircuitOpenError) upstreamRejected.inc(labels);
+      throw e;
+    }
+  }
+
+  async function fetchJson(url) {
+    const { text } = await upstreamRequest(url);
+    try { return JSON.parse(text); } catch (e) { return { _raw: text }; }
+  }
+
+  app.get('/weather', async (req, res) => {
+    const lat = req.query.lat;
+    const lon = req.query.lon;
+    if (!lat || !lon) return res.status(400).json({ error: 'lat and lon required' });
+    const url = weatherUrl(OPEN_METEO_BASE, lat, lon);
+    try {
+      const j = await fetchJson(url);
+      res.json(j);
+    } catch (e) {
+      console.error('weather proxy error', e);
+      res.status(502).json({ error: 'proxy fetch failed', detail: String(e) });
+    }
+  });
+
+  app.get('/reverse-geocode', async (req, res) => {
+    const lat = req.query.lat;
+    const lon = req.query.lon;
+    if (!lat || !lon) return res.status(400).json({ error: 'lat and lon required' });
+    const url = placeUrl(GEOCODE_BASE, lat, lon);
+    try {
+      const j = await fetchJson(url);
+      res.json(j);
+    } catch (e) {
+      console.error('reverse proxy error', e);
+      res.status(502).json({ error: 'proxy fetch failed', detail: String(e) });
+    }
+  });
+
+  // Only successful upstream answers may be cached
+  async function fetchOkJson(url) {
+    const res = await upstreamRequest(url);
+    if (!res.ok) throw new Error(`upstream HTTP ${res.status}`);
+    return JSON.parse(res.text);
+  }
+
+  const conditions = createConditions({ fetchJson: fetchOkJson, createCache: options.createCache });
+
+  metrics.collect(() => {
+    for (const [name, cache] of Object.entries(conditions.caches)) {
+      cacheLookups.set({ cache: name, result: 'hit' }, cache.hits);
+      cacheLookups.set({ cache: name, result: 'miss' }, cache.misses);
+      cacheLookups.set({ cache: name, result: 'stale' }, cache.staleHits);
+      cacheLookups.set({ cache: name, result: 'coalesced' }, cache.coalesced);
+      if (cache.size !== undefined) cacheEntries.set({ cache: name }, cache.size);
+    }
+    for (const [name, breaker] of Object.entries(breakers)) {
+      circuitOpen.set({ upstream: name }, breaker.state === CLOSED ? 0 : 1);
+    }
+  });
+
+  app.get('/conditions', async (req, res) => {
+    const lat = parseFloat(req.query.lat);
+    const lon = parseFloat(req.query.lon);
+    if (!isFinite(lat) || !isFinite(lon)) return res.status(400).json({ error: 'lat and lon required' });
+    try {
+      const result = await conditions(lat, lon);
+      res.set('X-Cache', `weather=${result.cache.weather}, place=${result.cache.place}`);
+      res.json({ weather: result.weather, place: result.place });
+    } catch (e) {
+      console.error('conditions proxy error', e);
+      res.status(502).json({ error: 'proxy fetch failed', detail: String(e) });
+    }
+  });
+
+  function placeName(place) {
+    return place && place.results && place.results[0] ? place.results[0].name : null;
+  }
+
+  app.get('/compact', async (req, res) => {
+    const lat = parseFloat(req.query.lat);
+    const lon = parseFloat(req.query.lon);
+    if (!isFinite(lat) || !isFinite(lon)) return res.status(400).json({ error: 'lat and lon required' });
+    try {
+      const result = await conditions.current(lat, lon);
+      const metric = readings(result.weather);
+      const units = parseUnits(req.query);
+      const name = placeName(result.place);
+      let body;
+      if (req.query.format === 'record') {
+        res.type('application/octet-stream');
+        body = packRecord(metric, units, name);
+      } else {
+        res.type('application/json');
+        body = Buffer.from(JSON.stringify(compactJson(metric, units, name)));
+      }
+      res.set('X-Cache', `weather=${result.cache.weather}, place=${result.cache.place}`);
+      res.send(body);
+    } catch (e) {
+      console.error('compact proxy error', e);
+      res.status(502).json({ error: 'proxy fetch failed', detail: String(e) });
+    }
+  });
+
+  app.get('/metrics', async (req, res) => {
+    try {
+      const families = withHitRatio(mergeSnapshots(await gatherMetrics(metrics)));
+      res.type('text/plain; version=0.0.4').send(render(families));
+    } catch (e) {
+      console.error('metrics error', e);
+      res.status(500).json({ error: 'metrics unavailable', detail: String(e) });
+    }
+  });
+
+  app.get('/', (req, res) => res.send('Pebble proxy running'));
+
+  return {
+    app,
+    metrics,
+    drain() {
+      closing = true;
+    },
+    close() {
+      agent.destroy();
+    }
+  };
+}
+
+module.exports = { createApp };
@@ -0,0 +1,119 @@
+// Closed-loop load generator: a fixed number of connections each send the
+// next request as soon as the last is answered, for a fixed time. Reports
+// throughput and latency percentiles.
+//
+//   node bench/load.js --url 'http://127.0.0.1:3000/conditions?lat={lat}&lon={lon}' \
+//     --concurrency 64 --duration 20 --spread 0.5
+//
+// {lat} and {lon} are replaced per request with a random position within
+// --spread degrees of --lat/--lon, so the proxy caches see a realistic mix
+// of hits and misses. --spread 0 makes every request the same.
+
+const http = require('http');
+const https = require('https');
+
+// Nearest-rank percentile of an ascending array
+function percentile(sorted, p) {
+  if (sorted.length === 0) return NaN;
+  const rank = Math.ceil((p / 100) * sorted.length);
+  return sorted[Math.min(sorted.length, Math.max(1, rank)) - 1];
+}
+
+function requestUrl(template, options) {
+  const lat = options.lat + (Math.random() * 2 - 1) * options.spread;
+  const lon = options.lon + (Math.random() * 2 - 1) * options.spread;
+  return template.replace('{lat}', lat.toFixed(4)).replace('{lon}', lon.toFixed(4));
+}
+
+// Resolves to { status, ms }; status 0 for a network error
+function timedGet(url, agent) {
+  const client = url.startsWith('https:') ? https : http;
+  const start = process.hrtime.bigint();
+  const elapsed = () => Number(process.hrtime.bigint() - start) / 1e6;
+  return new Promise((resolve) => {
+    const req = client.get(url, { agent }, (res) => {
+      res.resume(); // Drain the body; only its arrival time matters
+      res.on('end', () => resolve({ status: res.statusCode, ms: elapsed() }));
+    });
+    req.on('error', () => resolve({ status: 0, ms: elapsed() }));
+  });
+}
+
+// options: url, concurrency, durationMs, requests (optional cap), lat, lon,
+// spread. Resolves to a report object; see format().
+async function runLoad(options) {
+  const agent = new (options.url.startsWith('https:') ? https : http).Agent({
+    keepAlive: true, maxSockets: options.concurrency
+  });
+  const latencies = [];
+  const statuses = {};
+  let sent = 0;
+  const started = Date.now();
+  const deadline = started + options.durationMs;
+  const more = () => Date.now() < deadline && (!options.requests || sent < options.requests);
+
+  async function connection() {
+    while (more()) {
+      sent++;
+      const { status, ms } = await timedGet(requestUrl(options.url, options), agent);
+      statuses[status] = (statuses[status] || 0) + 1;
+      latencies.push(ms);
+    }
+  }
+  await Promise.all(Array.from({ length: options.concurrency }, connection));
+  agent.destroy();
+
+  const seconds = (Date.now() - started) / 1000;
+  latencies.sort((a, b) => a - b);
+  const ok = Object.keys(statuses).filter((s) => s >= 200 && s < 300).reduce((n, s) => n + statuses[s], 0);
+  return {
+    requests: latencies.length,
+    errors: latencies.length - ok,
+    seconds,
+    rps: latencies.length / seconds,
+    statuses,
+    p50: percentile(latencies, 50),
+    p95: percentile(latencies, 95),
+    p99: percentile(latencies, 99),
+    max: latencies[latencies.length - 1]
+  };
+}
+
+function format(report) {
+  return [
+    `requests  ${report.requests} in ${report.seconds.toFixed(1)} s, ${report.errors} errors`,
+    `rate      ${report.rps.toFixed(1)} req/s`,
+    `latency   p50 ${report.p50.toFixed(1)} ms  p95 ${report.p95.toFixed(1)} ms  ` +
+      `p99 ${report.p99.toFixed(1)} ms  max ${report.max.toFixed(1)} ms`,
+    `statuses  ${JSON.stringify(report.statuses)}`
+  ].join('\n');
+}
+
+function parseArgs(argv) {
+  const options = {
+    url: 'http://127.0.0.1:3000/conditions?lat={lat}&lon={lon}',
+    concurrency: 32,
+    durationMs: 10000,
+    requests: 0,
+    lat: 51.5074,
+    lon: -0.1278,
+    spread: 0.5
+  };
+  for (let i = 0; i < argv.length; i += 2) {
+    const name = argv[i].replace(/^--/, '');
+    const value = argv[i + 1];
+    if (name === 'url') options.url = value;
+    else if (name === 'duration') options.durationMs = parseFloat(value) * 1000;
+    else if (name in options) options[name] = parseFloat(value);
+    else throw new Error(`unknown option --${name}`);
+  }
+  return options;
+}
+
+module.exports = { runLoad, percentile, format };
+
+if (require.main === module) {
+  const options = parseArgs(process.argv.slice(2));
+  console.log(`${options.url}: ${options.concurrency} connections for ${options.durationMs / 1000} s`);
+  runLoad(options).then((report) => console.log(format(report)));
+}
@@ -0,0 +1,88 @@
+// Stand-in for Open-Meteo (forecast and reverse geocoding) and Nominatim,
+// with configurable latency and failure rate, for load tests that should
+// measure the proxy rather than the internet.
+//
+//   node bench/mock-upstream.js
+//   MOCK_PORT=8090 MOCK_LATENCY_MS=80 MOCK_JITTER_MS=40 MOCK_FAILURE_RATE=0.02 node bench/mock-upstream.js
+//
+// Then start the proxy with OPEN_METEO_BASE and GEOCODE_BASE set to
+// http://127.0.0.1:8090.
+
+const http = require('http');
+
+const HOUR = 3600;
+
+// A forecast the size of a real one: a week of hourly arrays for the
+// variables the proxies ask for, plus the current readings
+function forecastBody() {
+  const start = Math.floor(Date.now() / 1000 / HOUR) * HOUR;
+  const hours = 168;
+  const series = (fn) => Array.from({ length: hours }, (_, i) => Math.round(fn(i) * 10) / 10);
+  return JSON.stringify({
+    latitude: 52.75, longitude: 0.4, utc_offset_seconds: 0, timezone: 'GMT',
+    current: {
+      time: start, interval: 900, temperature_2m: 12.5, relative_humidity_2m: 81,
+      wind_speed_10m: 17.3, surface_pressure: 1008.3
+    },
+    current_weather: { time: start, temperature: 12.5, windspeed: 17.3, winddirection: 240, weathercode: 61 },
+    minutely_15: { time: [start], weather_code: [61] },
+    hourly: {
+      time: Array.from({ length: hours }, (_, i) => start + i * HOUR),
+      surface_pressure: series((i) => 1008 + 6 * Math.sin(i / 20)),
+      relativehumidity_2m: series((i) => 75 + 10 * Math.sin(i / 7)),
+      windspeed_10m: series((i) => 15 + 8 * Math.sin(i / 5)),
+      precipitation: series((i) => Math.max(0, Math.sin(i / 3)))
+    },
+    daily: { time: [start], precipitation_sum: [3.9] }
+  });
+}
+
+const BODIES = {
+  '/v1/forecast': forecastBody(),
+  '/v1/reverse': JSON.stringify({ results: [{ name: "King's Lynn", country: 'United Kingdom' }] }),
+  '/reverse': JSON.stringify({ display_name: "King's Lynn, Norfolk, England", address: { town: "King's Lynn" } })
+};
+
+// options: port (0 = any), latencyMs, jitterMs (uniform +/-), failureRate (0-1,
+// answered 503). Resolves to { server, base, hits } where hits counts
+// requests per path.
+function startMockUpstream(options = {}) {
+  const latencyMs = options.latencyMs || 0;
+  const jitterMs = options.jitterMs || 0;
+  const failureRate = options.failureRate || 0;
+  const hits = {};
+  const server = http.createServer((req, res) => {
+    const path = req.url.split('?')[0];
+    hits[path] = (hits[path] || 0) + 1;
+    const delay = Math.max(0, latencyMs + (Math.random() * 2 - 1) * jitterMs);
+    setTimeout(() => {
+      const body = BODIES[path];
+      if (!body) {
+        res.writeHead(404, { 'Content-Type': 'application/json' });
+        res.end('{"error":"not found"}');
+      } else if (Math.random() < failureRate) {
+        res.writeHead(503, { 'Content-Type': 'application/json' });
+        res.end('{"error":"mock failure"}');
+      } else {
+        res.writeHead(200, { 'Content-Type': 'application/json' });
+        res.end(body);
+      }
+    }, delay);
+  });
+  return new Promise((resolve) => {
+    server.listen(options.port || 0, '127.0.0.1', () => {
+      resolve({ server, hits, base: `http://127.0.0.1:${server.address().port}` });
+    });
+  });
+}
+
+module.exports = { startMockUpstream };
+
+if (require.main === module) {
+  startMockUpstream({
+    port: parseInt(process.env.MOCK_PORT || '8090', 10),
+    latencyMs: parseFloat(process.env.MOCK_LATENCY_MS || '50'),
+    jitterMs: parseFloat(process.env.MOCK_JITTER_MS || '20'),
+    failureRate: parseFloat(process.env.MOCK_FAILURE_RATE || '0')
+  }).then(({ base }) => console.log('Mock upstream listening on', base));
+}
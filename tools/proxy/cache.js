@@ -0,0 +1,105 @@
+// In-memory cache for upstream responses: a bounded LRU whose entries each
+// carry their own expiry, plus single-flight loading so concurrent misses on
+// one key share a single upstream request. Expired entries can be kept for
+// a while longer and served stale while a background load refreshes them.
+
+class TtlCache {
+  // now: clock in ms, injectable for tests
+  constructor(maxEntries, now = Date.now) {
+    this.maxEntries = maxEntries;
+    this.now = now;
+    this.entries = new Map(); // key -> { value, expires, staleUntil }, least recently used first
+    this.inflight = new Map(); // key -> Promise of the value being loaded
+    // load() outcomes: answered from the cache, answered stale, started a
+    // load, or joined one
+    this.hits = 0;
+    this.staleHits = 0;
+    this.misses = 0;
+    this.coalesced = 0;
+  }
+
+  // The entry for key if still fresh or servable stale, most recently used
+  entry(key) {
+    const entry = this.entries.get(key);
+    if (!entry) return undefined;
+    if (entry.staleUntil <= this.now()) {
+      this.entries.delete(key);
+      return undefined;
+    }
+    // Re-insert to mark as most recently used
+    this.entries.delete(key);
+    this.entries.set(key, entry);
+    return entry;
+  }
+
+  // The fresh value for key, or undefined
+  get(key) {
+    const entry = this.entry(key);
+    return entry && entry.expires > this.now() ? entry.value : undefined;
+  }
+
+  // staleMs: how long after expiring the value may still be served stale
+  set(key, value, ttlMs, staleMs = 0) {
+    const expires = this.now() + ttlMs;
+    this.entries.delete(key);
+    this.entries.set(key, { value, expires, staleUntil: expires + staleMs });
+    while (this.entries.size > this.maxEntries) {
+      this.entries.delete(this.entries.keys().next().value);
+    }
+  }
+
+  // Start loader() for key unless a load is already running, and return the
+  // promise of its value. Failures are not cached.
+  refresh(key, ttlMs, staleMs, loader) {
+    let pending = this.inflight.get(key);
+    if (!pending) {
+      pending = (async () => {
+        try {
+          const value = await loader();
+          this.set(key, value, ttlMs, staleMs);
+          return value;
+        } finally {
+          this.inflight.delete(key);
+        }
+      })();
+      this.inflight.set(key, pending);
+    }
+    return pending;
+  }
+
+  // Resolve to { value, hit, stale }. A fresh entry is a hit. An expired one
+  // within staleMs is returned at once, marked stale, while loader() refreshes
+  // it in the background. Otherwise loader() fetches the value, which is
+  // cached for ttlMs; callers arriving while it runs wait for the same
+  // promise.
+  async load(key, ttlMs, loader, staleMs = 0) {
+    const entry = this.entry(key);
+    if (entry && entry.expires > this.now()) {
+      this.hits++;
+      return { value: entry.value, hit: true, stale: false };
+    }
+    if (entry) {
+      this.staleHits++;
+      this.refresh(key, ttlMs, staleMs, loader).catch(() => {}); // Stays stale on failure
+      return { value: entry.value, hit: true, stale: true };
+    }
+
+    if (this.inflight.has(key)) {
+      this.coalesced++;
+    } else {
+      this.misses++;
+    }
+    return { value: await this.refresh(key, ttlMs, staleMs, loader), hit: false, stale: false };
+  }
+
+  get size() {
+    return this.entries.size;
+  }
+}
+
+// Cache key for a position rounded to a grid of the given size in degrees
+function cellKey(lat, lon, degrees) {
+  return Math.round(lat / degrees) + ',' + Math.round(lon / degrees);
+}
+
+module.exports = { TtlCache, cellKey };
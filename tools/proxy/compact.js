@@ -0,0 +1,165 @@
+// Compact responses for GET /compact: just the readings the watch shows,
+// already rounded to fixed-point integers, as small JSON or as the watch's
+// own weather record bytes. Saves the phone downloading and parsing the
+// full Open-Meteo document on every fetch. Neither is compressed: the JSON
+// is about 100 bytes and gzip's header and trailer cancel out what it saves.
+
+// Only what the watch displays: current readings, the condition for the
+// next 15 minutes and today's rainfall
+function currentUrl(base, lat, lon) {
+  return `${base}/v1/forecast?latitude=${encodeURIComponent(lat)}&longitude=${encodeURIComponent(lon)}` +
+    '&current=temperature_2m,relative_humidity_2m,wind_speed_10m,surface_pressure' +
+    '&minutely_15=weather_code&forecast_minutely_15=1' +
+    '&daily=precipitation_sum&forecast_days=1' +
+    '&timeformat=unixtime&timezone=auto';
+}
+
+// Unit choices, named as in the companion's settings
+function parseUnits(query) {
+  return {
+    temperature: query.temperature_unit === 'fahrenheit' ? 'fahrenheit' : 'celsius',
+    wind: query.wind_unit === 'kph' ? 'kph' : 'mph',
+    precipitation: query.precipitation_unit === 'inches' ? 'inches' : 'mm'
+  };
+}
+
+function first(array) {
+  return Array.isArray(array) && array.length > 0 ? array[0] : undefined;
+}
+
+function isNumber(value) {
+  return typeof value === 'number' && isFinite(value);
+}
+
+// Metric readings from a currentUrl() response. Missing values are left out.
+function readings(forecast) {
+  const current = (forecast && forecast.current) || {};
+  const result = {
+    time: current.time,
+    temperature: current.temperature_2m,
+    humidity: current.relative_humidity_2m,
+    wind: current.wind_speed_10m,
+    pressure: current.surface_pressure,
+    weatherCode: first(forecast && forecast.minutely_15 && forecast.minutely_15.weather_code),
+    precipitation: first(forecast && forecast.daily && forecast.daily.precipitation_sum)
+  };
+  for (const name of Object.keys(result)) {
+    if (!isNumber(result[name])) delete result[name];
+  }
+  return result;
+}
+
+// Compact JSON body. Integers only, in the requested units:
+//   ts      observation time, UTC seconds
+//   wmo     WMO weather code
+//   temp    tenths of a degree C or F
+//   rh      percent
+//   wind    tenths of km/h or mph
+//   precip  tenths of mm, or hundredths of an inch
+//   hpa     tenths of hPa
+//   place   place name, if known
+function compactJson(metric, units, place) {
+  const body = {};
+  if ('time' in metric) body.ts = Math.round(metric.time);
+  if ('weatherCode' in metric) body.wmo = Math.round(metric.weatherCode);
+  if ('temperature' in metric) {
+    const t = units.temperature === 'fahrenheit' ? metric.temperature * 9 / 5 + 32 : metric.temperature;
+    body.temp = Math.round(t * 10);
+  }
+  if ('humidity' in metric) body.rh = Math.round(metric.humidity);
+  if ('wind' in metric) {
+    const w = units.wind === 'kph' ? metric.wind : metric.wind / 1.609344;
+    body.wind = Math.round(w * 10);
+  }
+  if ('precipitation' in metric) {
+    body.precip = units.precipitation === 'inches'
+      ? Math.round(metric.precipitation / 25.4 * 100)
+      : Math.round(metric.precipitation * 10);
+  }
+  if ('pressure' in metric) body.hpa = Math.round(metric.pressure * 10);
+  if (place) body.place = place;
+  return body;
+}
+
+// --- Weather record --- //
+
+// Must match src/c/weather_record.h (and src/pkjs/weather_record.js, which
+// the tests compare against): version, flags, u16 present mask, then each
+// present field in bit order, little-endian, metric fixed point. The watch
+// converts units itself from the UNITS byte.
+const RECORD_VERSION = 1;
+const LOCATION_MAX = 31;
+const FIELD = {
+  PRESSURE: 1 << 1,
+  TEMPERATURE: 1 << 3,
+  HUMIDITY: 1 << 4,
+  WIND: 1 << 5,
+  PRECIP: 1 << 6,
+  CONDITION: 1 << 7,
+  UNITS: 1 << 8,
+  LOCATION: 1 << 10
+};
+const UNITS_FAHRENHEIT = 1 << 0;
+const UNITS_WIND_KPH = 1 << 1;
+const UNITS_PRECIP_INCHES = 1 << 2;
+
+function clamp(value, min, max) {
+  return Math.max(min, Math.min(max, value));
+}
+
+function pushU8(bytes, value) {
+  bytes.push(clamp(Math.round(value), 0, 0xFF));
+}
+
+function pushU16(bytes, value) {
+  const v = clamp(Math.round(value), 0, 0xFFFF);
+  bytes.push(v & 0xFF, (v >> 8) & 0xFF);
+}
+
+function pushS16(bytes, value) {
+  const v = clamp(Math.round(value), -0x8000, 0x7FFF) & 0xFFFF;
+  bytes.push(v & 0xFF, (v >> 8) & 0xFF);
+}
+
+// UTF-8, truncated to LOCATION_MAX bytes without splitting a character
+function locationBytes(name) {
+  const bytes = Buffer.from(String(name), 'utf8');
+  let cut = Math.min(bytes.length, LOCATION_MAX);
+  while (cut > 0 && cut < bytes.length && (bytes[cut] & 0xC0) === 0x80) cut--;
+  return Array.from(bytes.subarray(0, cut));
+}
+
+function unitsByte(units) {
+  let byte = 0;
+  if (units.temperature === 'fahrenheit') byte |= UNITS_FAHRENHEIT;
+  if (units.wind === 'kph') byte |= UNITS_WIND_KPH;
+  if (units.precipitation === 'inches') byte |= UNITS_PRECIP_INCHES;
+  return byte;
+}
+
+// Record bytes for the readings, units and place. Header flags are left 0:
+// the companion adds its settings and flags before forwarding to the watch.
+function packRecord(metric, units, place) {
+  let present = 0;
+  const body = [];
+  const field = (bit, write, value) => {
+    present |= bit;
+    write(body, value);
+  };
+  if ('pressure' in metric) field(FIELD.PRESSURE, pushS16, metric.pressure * 10);
+  if ('temperature' in metric) field(FIELD.TEMPERATURE, pushS16, metric.temperature * 10);
+  if ('humidity' in metric) field(FIELD.HUMIDITY, pushU8, metric.humidity);
+  if ('wind' in metric) field(FIELD.WIND, pushU16, metric.wind * 10);
+  if ('precipitation' in metric) field(FIELD.PRECIP, pushU16, metric.precipitation * 10);
+  if ('weatherCode' in metric) field(FIELD.CONDITION, pushU8, metric.weatherCode);
+  field(FIELD.UNITS, pushU8, unitsByte(units));
+  if (place) {
+    const name = locationBytes(place);
+    field(FIELD.LOCATION, (bytes) => bytes.push(name.length, ...name));
+  }
+  return Buffer.from([RECORD_VERSION, 0, present & 0xFF, (present >> 8) & 0xFF, ...body]);
+}
+
+module.exports = {
+  currentUrl, parseUnits, readings, compactJson, packRecord
+};
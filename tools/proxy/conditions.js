@@ -0,0 +1,88 @@
+// GET /conditions: the forecast and the place name for a position in one
+// response. Both upstream calls run in parallel and are cached separately,
+// keyed by position on a grid that suits each - watches in the same town
+// share entries, so most requests are answered without leaving the box.
+
+const { TtlCache, cellKey } = require('./cache');
+const { currentUrl } = require('./compact');
+
+const OPEN_METEO_BASE = process.env.OPEN_METEO_BASE || 'https://api.open-meteo.com';
+const GEOCODE_BASE = process.env.GEOCODE_BASE || 'https://geocoding-api.open-meteo.com';
+
+// Per-resource cache settings. Open-Meteo updates current conditions every
+// 15 minutes on a grid of a few km; place names hardly ever change. After
+// ttlMs an entry is still answered for staleMs while it is refreshed in the
+// background, so a slow or failing upstream does not hold up the watch.
+const RESOURCES = {
+  weather: { gridDegrees: 0.05, ttlMs: 5 * 60 * 1000, staleMs: 60 * 60 * 1000 },
+  current: { gridDegrees: 0.05, ttlMs: 5 * 60 * 1000, staleMs: 60 * 60 * 1000 },
+  place: { gridDegrees: 0.01, ttlMs: 24 * 60 * 60 * 1000, staleMs: 7 * 24 * 60 * 60 * 1000 }
+};
+const MAX_ENTRIES = 5000;
+
+function weatherUrl(base, lat, lon) {
+  return `${base}/v1/forecast?latitude=${encodeURIComponent(lat)}&longitude=${encodeURIComponent(lon)}&hourly=surface_pressure,relativehumidity_2m,windspeed_10m,precipitation&current_weather=true&timezone=auto`;
+}
+
+function placeUrl(base, lat, lon) {
+  return `${base}/v1/reverse?latitude=${encodeURIComponent(lat)}&longitude=${encodeURIComponent(lon)}&count=1&language=en`;
+}
+
+// options.fetchJson(url) -> Promise of the parsed body. options.createCache(name)
+// supplies each resource's cache, e.g. a RemoteCache in a cluster worker;
+// by default each is a local TtlCache. The other options override the
+// defaults above, mainly so tests can point at a stand-in upstream and
+// control the clock.
+function createConditions(options) {
+  const fetchJson = options.fetchJson;
+  const openMeteoBase = options.openMeteoBase || OPEN_METEO_BASE;
+  const geocodeBase = options.geocodeBase || GEOCODE_BASE;
+  const resources = Object.assign({}, RESOURCES, options.resources);
+  const createCache = options.createCache ||
+    (() => new TtlCache(options.maxEntries || MAX_ENTRIES, options.now));
+  const caches = {};
+  for (const name of Object.keys(resources)) caches[name] = createCache(name);
+
+  // Requests go to upstream for the centre of the cell, so every position
+  // in a cell gets the same answer whichever watch asked first
+  function loadResource(name, lat, lon, urlFor) {
+    const grid = resources[name].gridDegrees;
+    const key = cellKey(lat, lon, grid);
+    const cellLat = Math.round(lat / grid) * grid;
+    const cellLon = Math.round(lon / grid) * grid;
+    return caches[name].load(key, resources[name].ttlMs,
+      () => fetchJson(urlFor(cellLat.toFixed(4), cellLon.toFixed(4))), resources[name].staleMs);
+  }
+
+  const cacheResult = (loaded) => (loaded.stale ? 'stale' : loaded.hit ? 'hit' : 'miss');
+
+  // Resolves to { weather, place, cache: { weather, place } } where the
+  // cache fields are 'hit', 'stale' or 'miss'. A failed place lookup still returns
+  // the weather, with place null; a failed weather fetch rejects.
+  async function withPlace(name, lat, lon, urlFor) {
+    const [weather, place] = await Promise.all([
+      loadResource(name, lat, lon, urlFor),
+      loadResource('place', lat, lon, (a, b) => placeUrl(geocodeBase, a, b))
+        .catch((e) => ({ value: null, hit: false, error: e }))
+    ]);
+    return {
+      weather: weather.value,
+      place: place.value,
+      cache: { weather: cacheResult(weather), place: cacheResult(place) }
+    };
+  }
+
+  // The full forecast document
+  function conditions(lat, lon) {
+    return withPlace('weather', lat, lon, (a, b) => weatherUrl(openMeteoBase, a, b));
+  }
+
+  // Only the current readings, for compact responses
+  conditions.current = (lat, lon) =>
+    withPlace('current', lat, lon, (a, b) => currentUrl(openMeteoBase, a, b));
+
+  conditions.caches = caches;
+  return conditions;
+}
+
+module.exports = { createConditions, weatherUrl, placeUrl, OPEN_METEO_BASE, GEOCODE_BASE, MAX_ENTRIES };
@@ -0,0 +1,61 @@
+// Request/reply over the cluster IPC channel between the primary and its
+// workers. An endpoint is anything with send(message) and a 'message' event:
+// process in a worker, a cluster Worker in the primary. Several services
+// share one endpoint, told apart by channel name; requests carry an id and
+// replies carry replyTo.
+
+const DEFAULT_TIMEOUT_MS = 15000;
+
+// Unique across every client in the process, since clients may share a
+// channel and an endpoint
+let nextId = 1;
+
+class IpcClient {
+  constructor(channel, endpoint = process) {
+    this.channel = channel;
+    this.endpoint = endpoint;
+    this.pending = new Map(); // id -> { resolve, reject, timer }
+    endpoint.on('message', (message) => {
+      if (!message || message.channel !== channel || !message.replyTo) return;
+      const pending = this.pending.get(message.replyTo);
+      if (!pending) return;
+      this.pending.delete(message.replyTo);
+      clearTimeout(pending.timer);
+      pending.resolve(message);
+    });
+  }
+
+  // Resolves to the reply message; rejects if none arrives in timeoutMs
+  request(body, timeoutMs = DEFAULT_TIMEOUT_MS) {
+    const id = nextId++;
+    return new Promise((resolve, reject) => {
+      const timer = setTimeout(() => {
+        this.pending.delete(id);
+        reject(new Error(`${this.channel} request timed out`));
+      }, timeoutMs);
+      timer.unref();
+      this.pending.set(id, { resolve, reject, timer });
+      try {
+        this.endpoint.send(Object.assign({ channel: this.channel, id }, body));
+      } catch (e) {
+        this.pending.delete(id);
+        clearTimeout(timer);
+        reject(e);
+      }
+    });
+  }
+}
+
+// handler(message, reply) for each request on channel. reply(body) may be
+// called later, e.g. once a shared load completes.
+function serve(endpoint, channel, handler) {
+  endpoint.on('message', (message) => {
+    if (!message || message.channel !== channel || !message.id) return;
+    handler(message, (body) => {
+      if (endpoint.isConnected && !endpoint.isConnected()) return; // Worker already gone
+      endpoint.send(Object.assign({ channel, replyTo: message.id }, body));
+    });
+  });
+}
+
+module.exports = { IpcClient, serve };
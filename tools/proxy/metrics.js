@@ -0,0 +1,191 @@
+// Minimal Prometheus metrics: counters, gauges and histograms with labels,
+// rendered in the text exposition format for GET /metrics. No client
+// library, so the proxy keeps its two dependencies.
+//
+// A registry's state can be taken as a plain snapshot, which is how worker
+// processes hand their metrics to the primary: snapshots from several
+// processes are summed series by series, then rendered once.
+
+// Seconds; covers a cache hit (well under 5 ms) to a stalled upstream
+const DEFAULT_BUCKETS = [0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10];
+
+function escapeLabel(value) {
+  return String(value).replace(/\\/g, '\\\\').replace(/\n/g, '\\n').replace(/"/g, '\\"');
+}
+
+function formatLabels(labels) {
+  const names = Object.keys(labels);
+  if (names.length === 0) return '';
+  return '{' + names.map((n) => `${n}="${escapeLabel(labels[n])}"`).join(',') + '}';
+}
+
+// One metric family: a value (or histogram state) per label set
+class Metric {
+  constructor(type, name, help) {
+    this.type = type;
+    this.name = name;
+    this.help = help;
+    this.series = new Map(); // formatted labels -> { labels, state }
+  }
+
+  state(labels, init) {
+    const key = formatLabels(labels || {});
+    let entry = this.series.get(key);
+    if (!entry) {
+      entry = { labels: labels || {}, state: init() };
+      this.series.set(key, entry);
+    }
+    return entry.state;
+  }
+
+  // Plain, serialisable copy: { type, name, help, buckets, series: [{ labels, state }] }
+  snapshot() {
+    return {
+      type: this.type,
+      name: this.name,
+      help: this.help,
+      buckets: this.buckets,
+      series: Array.from(this.series.values(), (e) => ({ labels: e.labels, state: JSON.parse(JSON.stringify(e.state)) }))
+    };
+  }
+}
+
+class Counter extends Metric {
+  constructor(name, help) {
+    super('counter', name, help);
+  }
+
+  inc(labels, by = 1) {
+    this.state(labels, () => ({ value: 0 })).value += by;
+  }
+
+  // For totals counted elsewhere and copied in by a collector
+  set(labels, value) {
+    this.state(labels, () => ({ value: 0 })).value = value;
+  }
+
+  get(labels) {
+    return this.state(labels, () => ({ value: 0 })).value;
+  }
+}
+
+class Gauge extends Counter {
+  constructor(name, help) {
+    super(name, help);
+    this.type = 'gauge';
+  }
+
+  dec(labels, by = 1) {
+    this.inc(labels, -by);
+  }
+}
+
+class Histogram extends Metric {
+  constructor(name, help, buckets = DEFAULT_BUCKETS) {
+    super('histogram', name, help);
+    this.buckets = buckets;
+  }
+
+  observe(labels, value) {
+    const s = this.state(labels, () => ({ counts: new Array(this.buckets.length).fill(0), sum: 0, count: 0 }));
+    for (let i = 0; i < this.buckets.length; i++) {
+      if (value <= this.buckets[i]) s.counts[i]++;
+    }
+    s.sum += value;
+    s.count++;
+  }
+
+  // Start a timer; calling the result records the elapsed seconds
+  startTimer(labels) {
+    const start = process.hrtime.bigint();
+    return (extraLabels) => {
+      const seconds = Number(process.hrtime.bigint() - start) / 1e9;
+      this.observe(Object.assign({}, labels, extraLabels), seconds);
+      return seconds;
+    };
+  }
+}
+
+// --- Snapshots --- //
+
+function renderFamily(family) {
+  const lines = [`# HELP ${family.name} ${family.help}`, `# TYPE ${family.name} ${family.type}`];
+  for (const { labels, state } of family.series) {
+    if (family.type !== 'histogram') {
+      lines.push(`${family.name}${formatLabels(labels)} ${state.value}`);
+      continue;
+    }
+    family.buckets.forEach((le, i) => {
+      lines.push(`${family.name}_bucket${formatLabels(Object.assign({}, labels, { le }))} ${state.counts[i]}`);
+    });
+    lines.push(`${family.name}_bucket${formatLabels(Object.assign({}, labels, { le: '+Inf' }))} ${state.count}`);
+    lines.push(`${family.name}_sum${formatLabels(labels)} ${state.sum}`);
+    lines.push(`${family.name}_count${formatLabels(labels)} ${state.count}`);
+  }
+  return lines.join('\n');
+}
+
+function render(families) {
+  return families.map(renderFamily).join('\n') + '\n';
+}
+
+// Sum snapshots (arrays of families) from several processes. Families and
+// series keep the order in which they are first seen.
+function mergeSnapshots(snapshots) {
+  const families = new Map();
+  for (const snapshot of snapshots) {
+    for (const family of snapshot) {
+      let merged = families.get(family.name);
+      if (!merged) {
+        merged = Object.assign({}, family, { series: new Map() });
+        families.set(family.name, merged);
+      }
+      for (const { labels, state } of family.series) {
+        const key = formatLabels(labels);
+        const into = merged.series.get(key);
+        if (!into) {
+          merged.series.set(key, { labels, state: JSON.parse(JSON.stringify(state)) });
+        } else if (family.type === 'histogram') {
+          state.counts.forEach((n, i) => { into.state.counts[i] += n; });
+          into.state.sum += state.sum;
+          into.state.count += state.count;
+        } else {
+          into.state.value += state.value;
+        }
+      }
+    }
+  }
+  return Array.from(families.values(), (f) => Object.assign({}, f, { series: Array.from(f.series.values()) }));
+}
+
+class Registry {
+  constructor() {
+    this.metrics = [];
+    this.collectors = [];
+  }
+
+  add(metric) {
+    this.metrics.push(metric);
+    return metric;
+  }
+
+  counter(name, help) { return this.add(new Counter(name, help)); }
+  gauge(name, help) { return this.add(new Gauge(name, help)); }
+  histogram(name, help, buckets) { return this.add(new Histogram(name, help, buckets)); }
+
+  // fn() runs before each snapshot, to refresh values read from elsewhere
+  collect(fn) {
+    this.collectors.push(fn);
+  }
+
+  snapshot() {
+    for (const fn of this.collectors) fn();
+    return this.metrics.map((m) => m.snapshot());
+  }
+
+  render() {
+    return render(this.snapshot());
+  }
+}
+
+module.exports = { Registry, Counter, Gauge, Histogram, DEFAULT_BUCKETS, mergeSnapshots, render };
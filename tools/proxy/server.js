@@ -0,0 +1,128 @@
+// Pebble proxy for Open-Meteo and reverse geocoding, for Render, Glitch or
+// any small Node host. The routes are in app.js.
+//
+// Environment:
+//  PORT                 listen port (3000)
+//  WEB_CONCURRENCY      worker processes, by default one per core. 1 runs a
+//                       single process without the cluster, e.g. on Glitch.
+//  SHUTDOWN_TIMEOUT_MS  how long SIGTERM waits for requests in flight (10000)
+//  OPEN_METEO_BASE and GEOCODE_BASE override the upstream hosts, e.g. to point
+//  at a local stand-in. UPSTREAM_TIMEOUT_MS bounds each upstream request.
+//
+// With several workers the primary only supervises: it forks the workers
+// and restarts any that die, holds the cache they share (shared-cache.js),
+// and sums their metrics for /metrics. The workers share the listening
+// socket, so any of them may answer any request and still hit the cache.
+
+const cluster = require('cluster');
+const os = require('os');
+const { createApp } = require('./app');
+const { MAX_ENTRIES } = require('./conditions');
+const { Registry } = require('./metrics');
+const { SharedCacheHost, RemoteCache } = require('./shared-cache');
+const { IpcClient, serve } = require('./ipc');
+
+const PORT = process.env.PORT || 3000;
+const WORKERS = parseInt(process.env.WEB_CONCURRENCY || '0', 10) ||
+  (os.availableParallelism ? os.availableParallelism() : os.cpus().length);
+const SHUTDOWN_TIMEOUT_MS = parseInt(process.env.SHUTDOWN_TIMEOUT_MS || '10000', 10);
+const RESTART_DELAY_MS = 1000;
+
+// --- Worker (or the only process) --- //
+
+// Listen, and on SIGTERM/SIGINT stop accepting connections, let requests in
+// flight finish, then exit
+function startServer(options) {
+  const proxy = createApp(options);
+  const server = proxy.app.listen(PORT, () => console.log(`Proxy ${process.pid} listening on port`, PORT));
+  let stopping = false;
+
+  function shutdown() {
+    if (stopping) return;
+    stopping = true;
+    proxy.drain();
+    server.close(() => {
+      proxy.close();
+      process.exit(0);
+    });
+    server.closeIdleConnections();
+    setTimeout(() => {
+      console.error('shutdown timed out with requests in flight');
+      process.exit(1);
+    }, SHUTDOWN_TIMEOUT_MS).unref();
+  }
+
+  process.on('SIGTERM', shutdown);
+  process.on('SIGINT', shutdown);
+  return { proxy, shutdown };
+}
+
+function startWorker() {
+  const gather = new IpcClient('metrics-gather');
+  const { proxy, shutdown } = startServer({
+    createCache: (name) => new RemoteCache(name),
+    gatherMetrics: async () => (await gather.request({}, 5000)).snapshots
+  });
+  serve(process, 'metrics-snapshot', (message, reply) => reply({ snapshot: proxy.metrics.snapshot() }));
+  process.on('disconnect', shutdown); // Primary gone
+}
+
+// --- Primary --- //
+
+function startPrimary() {
+  const host = new SharedCacheHost(MAX_ENTRIES);
+  const metrics = new Registry();
+  const cacheEntries = metrics.gauge('proxy_cache_entries', 'Entries held, by cache');
+  metrics.collect(() => {
+    for (const [name, cache] of Object.entries(host.caches)) cacheEntries.set({ cache: name }, cache.size);
+  });
+
+  const workers = new Map(); // Worker -> IpcClient for its metrics snapshot
+  let stopping = false;
+
+  // Every worker's snapshot plus the primary's own
+  async function gatherSnapshots() {
+    const snapshots = await Promise.all(Array.from(workers.values(), (client) =>
+      client.request({}, 2000).then((reply) => reply.snapshot, () => [])));
+    return snapshots.concat([metrics.snapshot()]);
+  }
+
+  function fork() {
+    if (stopping) return;
+    const worker = cluster.fork();
+    workers.set(worker, new IpcClient('metrics-snapshot', worker));
+    host.attach(worker);
+    serve(worker, 'metrics-gather', async (message, reply) => reply({ snapshots: await gatherSnapshots() }));
+  }
+
+  cluster.on('exit', (worker, code, signal) => {
+    workers.delete(worker);
+    host.detach(worker);
+    if (stopping) {
+      if (workers.size === 0) process.exit(0);
+      return;
+    }
+    console.error(`worker ${worker.process.pid} exited (${signal || code}), restarting`);
+    setTimeout(fork, RESTART_DELAY_MS);
+  });
+
+  function shutdown() {
+    if (stopping) return;
+    stopping = true;
+    for (const worker of workers.keys()) worker.process.kill('SIGTERM');
+    setTimeout(() => process.exit(1), SHUTDOWN_TIMEOUT_MS + 1000).unref();
+  }
+
+  process.on('SIGTERM', shutdown);
+  process.on('SIGINT', shutdown);
+  console.log(`Proxy primary ${process.pid} starting ${WORKERS} workers`);
+  for (let i = 0; i < WORKERS; i++) fork();
+}
+
+if (WORKERS <= 1) {
+  startServer({});
+} else if (cluster.isPrimary) {
+  startPrimary();
+} else {
+  startWorker();
+}
@@ -0,0 +1,143 @@
+// One cache tier for every worker process. The entries live in the primary,
+// which does no upstream I/O of its own: a worker asks it for a key and is
+// either given the value, given a stale value (and perhaps the job of
+// refreshing it), or given the job of loading it. Other workers asking for
+// a key that is being loaded wait for that load, so a cell is fetched once
+// however many workers want it.
+//
+// RemoteCache (in workers) has the same load() contract as TtlCache, so
+// createConditions() takes either.
+
+const { TtlCache } = require('./cache');
+const { IpcClient, serve } = require('./ipc');
+
+const CHANNEL = 'cache';
+
+// --- Primary --- //
+
+class SharedCacheHost {
+  constructor(maxEntries, now = Date.now) {
+    this.maxEntries = maxEntries;
+    this.now = now;
+    this.caches = {}; // name -> TtlCache
+    this.loads = new Map(); // name + key -> { holder, waiters: [reply] }
+  }
+
+  cache(name) {
+    if (!this.caches[name]) this.caches[name] = new TtlCache(this.maxEntries, this.now);
+    return this.caches[name];
+  }
+
+  // Serve requests from a worker
+  attach(endpoint) {
+    serve(endpoint, CHANNEL, (message, reply) => this.handle(endpoint, message, reply));
+  }
+
+  // A worker exited: loads it was running will not finish
+  detach(endpoint) {
+    for (const [loadKey, load] of this.loads) {
+      if (load.holder !== endpoint) continue;
+      this.loads.delete(loadKey);
+      for (const waiter of load.waiters) waiter({ error: 'loading worker exited' });
+    }
+  }
+
+  handle(endpoint, message, reply) {
+    const cache = this.cache(message.cache);
+    const loadKey = `${message.cache}\0${message.key}`;
+    const load = this.loads.get(loadKey);
+
+    if (message.op === 'get') {
+      const entry = cache.entry(message.key);
+      if (entry && entry.expires > this.now()) {
+        reply({ fresh: true, value: entry.value });
+      } else if (entry) {
+        // Hand out the refresh unless another worker already has it
+        if (!load) this.loads.set(loadKey, { holder: endpoint, waiters: [] });
+        reply({ stale: true, value: entry.value, refresh: !load });
+      } else if (load) {
+        load.waiters.push(reply);
+      } else {
+        this.loads.set(loadKey, { holder: endpoint, waiters: [] });
+        reply({ load: true });
+      }
+    } else if (message.op === 'fill' || message.op === 'fail') {
+      if (message.op === 'fill') cache.set(message.key, message.value, message.ttlMs, message.staleMs);
+      if (load && load.holder === endpoint) {
+        this.loads.delete(loadKey);
+        const result = message.op === 'fill' ? { value: message.value } : { error: message.error };
+        for (const waiter of load.waiters) waiter(result);
+      }
+      reply({});
+    }
+  }
+}
+
+// --- Worker --- //
+
+class RemoteCache {
+  constructor(name, endpoint = process) {
+    this.name = name;
+    this.client = new IpcClient(CHANNEL, endpoint);
+    this.loading = new Map(); // key -> Promise of a load this worker runs
+    // Same outcome counters as TtlCache, as seen by this worker
+    this.hits = 0;
+    this.staleHits = 0;
+    this.misses = 0;
+    this.coalesced = 0;
+  }
+
+  request(body) {
+    return this.client.request(Object.assign({ cache: this.name }, body));
+  }
+
+  // Run loader() and report the outcome to the primary
+  async fill(key, ttlMs, staleMs, loader) {
+    let value;
+    try {
+      value = await loader();
+    } catch (e) {
+      this.request({ op: 'fail', key, error: String(e) }).catch(() => {});
+      throw e;
+    }
+    this.request({ op: 'fill', key, value, ttlMs, staleMs }).catch(() => {});
+    return value;
+  }
+
+  // Resolve to { value, hit, stale }, as TtlCache.load()
+  async load(key, ttlMs, loader, staleMs = 0) {
+    // Callers in this worker share its own load without asking the primary
+    const mine = this.loading.get(key);
+    if (mine) {
+      this.coalesced++;
+      return { value: await mine, hit: false, stale: false };
+    }
+
+    const reply = await this.request({ op: 'get', key });
+    if (reply.fresh) {
+      this.hits++;
+      return { value: reply.value, hit: true, stale: false };
+    }
+    if (reply.stale) {
+      this.staleHits++;
+      if (reply.refresh) this.fill(key, ttlMs, staleMs, loader).catch(() => {}); // Stays stale on failure
+      return { value: reply.value, hit: true, stale: true };
+    }
+    if (reply.load) {
+      this.misses++;
+      const pending = this.fill(key, ttlMs, staleMs, loader);
+      this.loading.set(key, pending);
+      try {
+        return { value: await pending, hit: false, stale: false };
+      } finally {
+        this.loading.delete(key);
+      }
+    }
+    // Answered by another worker's load
+    this.coalesced++;
+    if (reply.error) throw new Error(reply.error);
+    return { value: reply.value, hit: false, stale: false };
+  }
+}
+
+module.exports = { SharedCacheHost, RemoteCache };
@@ -0,0 +1,66 @@
+// node --test: compact payloads, checked against the companion's own record
+// packer so the two cannot drift apart.
+
+const test = require('node:test');
+const assert = require('node:assert');
+
+const { parseUnits, readings, compactJson, packRecord } = require('../compact');
+const WeatherRecord = require('../../../src/pkjs/weather_record');
+
+// Trimmed Open-Meteo answer to currentUrl()
+const FORECAST = {
+  current: {
+    time: 1760600700,
+    interval: 900,
+    temperature_2m: 12.46,
+    relative_humidity_2m: 81,
+    wind_speed_10m: 17.3,
+    surface_pressure: 1008.26
+  },
+  minutely_15: { time: [1760600700], weather_code: [61] },
+  daily: { time: [1760569200], precipitation_sum: [3.87] }
+};
+
+test('extracts the displayed readings', () => {
+  assert.deepStrictEqual(readings(FORECAST), {
+    time: 1760600700,
+    temperature: 12.46,
+    humidity: 81,
+    wind: 17.3,
+    pressure: 1008.26,
+    weatherCode: 61,
+    precipitation: 3.87
+  });
+  assert.deepStrictEqual(readings({ current: { temperature_2m: null } }), {});
+});
+
+test('compact JSON is fixed point in the requested units', () => {
+  const metric = readings(FORECAST);
+  assert.deepStrictEqual(compactJson(metric, parseUnits({}), "King's Lynn"), {
+    ts: 1760600700, wmo: 61, temp: 125, rh: 81, wind: 107, precip: 39, hpa: 10083, place: "King's Lynn"
+  });
+  const imperial = parseUnits({ temperature_unit: 'fahrenheit', wind_unit: 'kph', precipitation_unit: 'inches' });
+  const body = compactJson(metric, imperial, null);
+  assert.strictEqual(body.temp, 544);   // 54.4 F
+  assert.strictEqual(body.wind, 173);   // 17.3 km/h
+  assert.strictEqual(body.precip, 15);  // 0.15 in
+  assert.ok(!('place' in body));
+});
+
+test('record bytes match the companion packer', () => {
+  const metric = readings(FORECAST);
+  const cases = [
+    { units: {}, place: 'Reykjavík' },
+    { units: { temperature_unit: 'fahrenheit', precipitation_unit: 'inches' }, place: null },
+    { units: { wind_unit: 'kph' }, place: 'Llanfairpwllgwyngyllgogerychwyrndrobwllllantysiliogogogoch' }
+  ];
+  for (const c of cases) {
+    const settings = Object.assign({ temperature_unit: 'celsius', wind_unit: 'mph', precipitation_unit: 'mm' }, c.units);
+    const data = Object.assign({}, metric, { settings });
+    if (c.place) data.location = c.place;
+    const encoded = WeatherRecord.encode(data);
+    delete encoded.settings; // Added by the companion
+    const expected = WeatherRecord.packEncoded(encoded, 0);
+    assert.deepStrictEqual(Array.from(packRecord(metric, parseUnits(c.units), c.place)), expected);
+  }
+});
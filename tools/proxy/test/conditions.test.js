@@ -0,0 +1,112 @@
+// node --test: /conditions caching against a local stand-in upstream.
+// Uses only Node built-ins, so it runs without npm install.
+
+const test = require('node:test');
+const assert = require('node:assert');
+const http = require('node:http');
+
+const { TtlCache } = require('../cache');
+const { createConditions } = require('../conditions');
+
+// Stand-in for Open-Meteo and its geocoder: answers after delayMs and counts
+// requests per path
+function startUpstream(delayMs) {
+  const hits = { '/v1/forecast': 0, '/v1/reverse': 0 };
+  const server = http.createServer((req, res) => {
+    const path = req.url.split('?')[0];
+    hits[path] = (hits[path] || 0) + 1;
+    setTimeout(() => {
+      res.setHeader('Content-Type', 'application/json');
+      if (path === '/v1/forecast') {
+        res.end(JSON.stringify({ current_weather: { temperature: 12.5 } }));
+      } else if (path === '/v1/reverse') {
+        res.end(JSON.stringify({ results: [{ name: "King's Lynn" }] }));
+      } else {
+        res.statusCode = 404;
+        res.end('{}');
+      }
+    }, delayMs);
+  });
+  return new Promise((resolve) => {
+    server.listen(0, '127.0.0.1', () => {
+      resolve({ server, hits, base: `http://127.0.0.1:${server.address().port}` });
+    });
+  });
+}
+
+async function fetchOkJson(url) {
+  const res = await fetch(url);
+  if (!res.ok) throw new Error(`upstream HTTP ${res.status}`);
+  return res.json();
+}
+
+test('fetches weather and place in parallel, then serves both from cache', async () => {
+  const upstream = await startUpstream(200);
+  try {
+    const conditions = createConditions({
+      fetchJson: fetchOkJson, openMeteoBase: upstream.base, geocodeBase: upstream.base
+    });
+
+    const started = Date.now();
+    const first = await conditions(52.7517, 0.3958);
+    assert.ok(Date.now() - started < 350, 'upstream calls should overlap');
+    assert.deepStrictEqual(first.cache, { weather: 'miss', place: 'miss' });
+    assert.strictEqual(first.weather.current_weather.temperature, 12.5);
+    assert.strictEqual(first.place.results[0].name, "King's Lynn");
+
+    // A few hundred metres away is the same cell
+    const second = await conditions(52.7530, 0.3970);
+    assert.deepStrictEqual(second.cache, { weather: 'hit', place: 'hit' });
+    assert.deepStrictEqual(upstream.hits, { '/v1/forecast': 1, '/v1/reverse': 1 });
+  } finally {
+    upstream.server.close();
+  }
+});
+
+test('concurrent misses share one upstream request', async () => {
+  const upstream = await startUpstream(50);
+  try {
+    const conditions = createConditions({
+      fetchJson: fetchOkJson, openMeteoBase: upstream.base, geocodeBase: upstream.base
+    });
+    const results = await Promise.all(Array.from({ length: 20 }, () => conditions(51.5074, -0.1278)));
+    assert.strictEqual(results.length, 20);
+    assert.deepStrictEqual(upstream.hits, { '/v1/forecast': 1, '/v1/reverse': 1 });
+  } finally {
+    upstream.server.close();
+  }
+});
+
+test('a failed place lookup still returns the weather', async () => {
+  const upstream = await startUpstream(0);
+  try {
+    const conditions = createConditions({
+      fetchJson: fetchOkJson, openMeteoBase: upstream.base, geocodeBase: `${upstream.base}/missing`
+    });
+    const result = await conditions(48.8566, 2.3522);
+    assert.strictEqual(result.place, null);
+    assert.strictEqual(result.weather.current_weather.temperature, 12.5);
+    assert.strictEqual(conditions.caches.place.size, 0, 'failures are not cached');
+  } finally {
+    upstream.server.close();
+  }
+});
+
+test('entries expire after their TTL and the LRU stays bounded', async () => {
+  let now = 0;
+  const cache = new TtlCache(2, () => now);
+  let loads = 0;
+  const loader = async () => ++loads;
+
+  assert.deepStrictEqual(await cache.load('a', 1000, loader), { value: 1, hit: false, stale: false });
+  assert.deepStrictEqual(await cache.load('a', 1000, loader), { value: 1, hit: true, stale: false });
+  now = 1000;
+  assert.deepStrictEqual(await cache.load('a', 1000, loader), { value: 2, hit: false, stale: false });
+
+  await cache.load('b', 1000, loader);
+  cache.get('a'); // a is now more recently used than b
+  await cache.load('c', 1000, loader);
+  assert.strictEqual(cache.size, 2);
+  assert.strictEqual(cache.get('b'), undefined);
+  assert.strictEqual(cache.get('a'), 2);
+});
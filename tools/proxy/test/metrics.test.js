@@ -0,0 +1,106 @@
+// node --test: Prometheus rendering, cache counters and the load tools.
+
+const test = require('node:test');
+const assert = require('node:assert');
+
+const { Registry, mergeSnapshots, render } = require('../metrics');
+const { TtlCache } = require('../cache');
+const { startMockUpstream } = require('../bench/mock-upstream');
+const { runLoad, percentile } = require('../bench/load');
+
+test('renders counters, gauges and cumulative histogram buckets', () => {
+  const registry = new Registry();
+  const requests = registry.counter('requests_total', 'Requests');
+  const inFlight = registry.gauge('in_flight', 'In flight');
+  const latency = registry.histogram('latency_seconds', 'Latency', [0.1, 1]);
+  requests.inc({ route: '/weather' });
+  requests.inc({ route: '/weather' });
+  inFlight.inc();
+  inFlight.dec();
+  latency.observe({ route: '/a"b' }, 0.05);
+  latency.observe({ route: '/a"b' }, 0.5);
+  latency.observe({ route: '/a"b' }, 5);
+
+  assert.strictEqual(registry.render(), [
+    '# HELP requests_total Requests',
+    '# TYPE requests_total counter',
+    'requests_total{route="/weather"} 2',
+    '# HELP in_flight In flight',
+    '# TYPE in_flight gauge',
+    'in_flight 0',
+    '# HELP latency_seconds Latency',
+    '# TYPE latency_seconds histogram',
+    'latency_seconds_bucket{route="/a\\"b",le="0.1"} 1',
+    'latency_seconds_bucket{route="/a\\"b",le="1"} 2',
+    'latency_seconds_bucket{route="/a\\"b",le="+Inf"} 3',
+    'latency_seconds_sum{route="/a\\"b"} 5.55',
+    'latency_seconds_count{route="/a\\"b"} 3',
+    ''
+  ].join('\n'));
+});
+
+test('the cache counts hits, misses and coalesced loads', async () => {
+  const cache = new TtlCache(10);
+  let release;
+  const gate = new Promise((resolve) => { release = resolve; });
+  const loads = [cache.load('k', 1000, () => gate), cache.load('k', 1000, () => gate)];
+  release(1);
+  await Promise.all(loads);
+  await cache.load('k', 1000, () => gate);
+  assert.deepStrictEqual([cache.hits, cache.misses, cache.coalesced], [1, 1, 1]);
+});
+
+test('percentiles use the nearest rank', () => {
+  const sorted = Array.from({ length: 100 }, (_, i) => i + 1);
+  assert.strictEqual(percentile(sorted, 50), 50);
+  assert.strictEqual(percentile(sorted, 99), 99);
+  assert.strictEqual(percentile([7], 95), 7);
+});
+
+test('the load generator reports throughput, latency and failures', async () => {
+  const upstream = await startMockUpstream({ latencyMs: 5, failureRate: 0.5 });
+  try {
+    const report = await runLoad({
+      url: `${upstream.base}/v1/forecast?latitude={lat}&longitude={lon}`,
+      concurrency: 8, durationMs: 5000, requests: 200, lat: 51.5, lon: -0.1, spread: 0.1
+    });
+    assert.strictEqual(report.requests, 200);
+    assert.strictEqual(upstream.hits['/v1/forecast'], 200);
+    assert.strictEqual(report.errors, report.statuses[503] || 0);
+    assert.ok(report.errors > 50 && report.errors < 150, `errors ${report.errors}`);
+    assert.ok(report.p50 >= 4 && report.p50 <= report.p95 && report.p95 <= report.p99);
+    assert.ok(report.rps > 0);
+  } finally {
+    upstream.server.close();
+  }
+});
+
+test('snapshots from several processes sum series by series', () => {
+  const snapshot = (route, seconds, entries) => {
+    const registry = new Registry();
+    registry.counter('lookups_total', 'Lookups').inc({ result: 'hit' });
+    registry.histogram('latency_seconds', 'Latency', [0.1]).observe({ route }, seconds);
+    if (entries !== undefined) registry.gauge('entries', 'Entries').set({}, entries);
+    return JSON.parse(JSON.stringify(registry.snapshot())); // As sent over IPC
+  };
+  const merged = mergeSnapshots([snapshot('/a', 0.05), snapshot('/a', 0.5), snapshot('/b', 0.05, 7)]);
+  assert.strictEqual(render(merged), [
+    '# HELP lookups_total Lookups',
+    '# TYPE lookups_total counter',
+    'lookups_total{result="hit"} 3',
+    '# HELP latency_seconds Latency',
+    '# TYPE latency_seconds histogram',
+    'latency_seconds_bucket{route="/a",le="0.1"} 1',
+    'latency_seconds_bucket{route="/a",le="+Inf"} 2',
+    'latency_seconds_sum{route="/a"} 0.55',
+    'latency_seconds_count{route="/a"} 2',
+    'latency_seconds_bucket{route="/b",le="0.1"} 1',
+    'latency_seconds_bucket{route="/b",le="+Inf"} 1',
+    'latency_seconds_sum{route="/b"} 0.05',
+    'latency_seconds_count{route="/b"} 1',
+    '# HELP entries Entries',
+    '# TYPE entries gauge',
+    'entries 7',
+    ''
+  ].join('\n'));
+});
@@ -0,0 +1,87 @@
+// node --test: the companion's place-name cache (src/pkjs/place_cache.js),
+// over an in-memory stand-in for localStorage and a made-up clock.
+
+const test = require('node:test');
+const assert = require('node:assert');
+
+const PlaceCache = require('../../../src/pkjs/place_cache');
+
+const DAY = 24 * 60 * 60 * 1000;
+const NOW = 1760601600000;
+const LAT = 52.7517;
+const LON = 0.3958;
+
+// getItem/setItem over a plain object, counting writes
+function memoryStorage(items) {
+  const storage = {
+    items: items || {},
+    writes: 0,
+    getItem(key) {
+      return key in this.items ? this.items[key] : null;
+    },
+    setItem(key, value) {
+      this.items[key] = String(value);
+      this.writes++;
+    }
+  };
+  return storage;
+}
+
+test('geohash matches the reference encoding', () => {
+  assert.strictEqual(PlaceCache.geohash(57.64911, 10.40744, 11), 'u4pruydqqvj');
+});
+
+test('reuses a name anywhere in the same geohash cell', () => {
+  const cache = new PlaceCache(memoryStorage());
+  assert.strictEqual(cache.lookup(LAT, LON, NOW), null);
+  cache.store(LAT, LON, "King's Lynn", NOW);
+
+  assert.strictEqual(PlaceCache.geohash(LAT + 0.0005, LON, 7), PlaceCache.geohash(LAT, LON, 7));
+  assert.strictEqual(cache.lookup(LAT + 0.0005, LON, NOW + 60 * 1000), "King's Lynn");
+});
+
+test('reuses a nearby name across a cell edge, but not a distant one', () => {
+  const cache = new PlaceCache(memoryStorage());
+  cache.store(LAT, LON, "King's Lynn", NOW);
+
+  // About 220 m north, in the next cell
+  assert.notStrictEqual(PlaceCache.geohash(LAT + 0.002, LON, 7), PlaceCache.geohash(LAT, LON, 7));
+  assert.strictEqual(cache.lookup(LAT + 0.002, LON, NOW), "King's Lynn");
+
+  // About 1.1 km north
+  assert.strictEqual(cache.lookup(LAT + 0.01, LON, NOW), null);
+});
+
+test('expires names after a week', () => {
+  const cache = new PlaceCache(memoryStorage());
+  cache.store(LAT, LON, "King's Lynn", NOW);
+  assert.strictEqual(cache.lookup(LAT, LON, NOW + 7 * DAY - 1), "King's Lynn");
+  assert.strictEqual(cache.lookup(LAT, LON, NOW + 7 * DAY), null);
+  assert.strictEqual(cache.lookup(LAT + 0.002, LON, NOW + 7 * DAY), null);
+
+  // Storing anything drops the expired entries
+  cache.store(LAT + 1, LON, 'Somewhere else', NOW + 7 * DAY);
+  assert.strictEqual(Object.keys(cache.entries).length, 1);
+});
+
+test('survives a restart through storage', () => {
+  const storage = memoryStorage();
+  new PlaceCache(storage).store(LAT, LON, "King's Lynn", NOW);
+  assert.strictEqual(storage.writes, 1);
+  assert.strictEqual(new PlaceCache(storage).lookup(LAT, LON, NOW), "King's Lynn");
+
+  // Unreadable storage starts empty rather than throwing
+  const broken = new PlaceCache(memoryStorage({ just_weather_places: '{not json' }));
+  assert.strictEqual(broken.lookup(LAT, LON, NOW), null);
+});
+
+test('keeps the 32 most recent places', () => {
+  const cache = new PlaceCache(memoryStorage());
+  for (let i = 0; i < 40; i++) {
+    cache.store(LAT + i * 0.1, LON, 'Place ' + i, NOW + i);
+  }
+  assert.strictEqual(Object.keys(cache.entries).length, 32);
+  assert.strictEqual(cache.lookup(LAT, LON, NOW + 40), null);
+  assert.strictEqual(cache.lookup(LAT + 8 * 0.1, LON, NOW + 40), 'Place 8');
+  assert.strictEqual(cache.lookup(LAT + 39 * 0.1, LON, NOW + 40), 'Place 39');
+});
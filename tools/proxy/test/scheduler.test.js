@@ -0,0 +1,81 @@
+// node --test: the companion's fetch scheduler (src/pkjs/scheduler.js). It
+// takes the time as an argument, so the tests drive it with a made-up clock.
+
+const test = require('node:test');
+const assert = require('node:assert');
+
+const Scheduler = require('../../../src/pkjs/scheduler');
+
+const MINUTE = 60 * 1000;
+const SLOT_OPEN = 1760601600000; // An Open-Meteo 15-minute slot boundary
+
+test('fetches straight away with no history', () => {
+  assert.strictEqual(new Scheduler().nextFetchTime(SLOT_OPEN + 7 * MINUTE), SLOT_OPEN + 7 * MINUTE);
+});
+
+test('lands just after the next slot opens, never twice in one slot', () => {
+  const scheduler = new Scheduler();
+  scheduler.recordSuccess(1013.2, SLOT_OPEN + 5 * MINUTE);
+  assert.strictEqual(scheduler.nextFetchTime(SLOT_OPEN + 5 * MINUTE), SLOT_OPEN + 16 * MINUTE);
+
+  // Fetched the moment the slot was published: still the following slot
+  scheduler.recordSuccess(1013.1, SLOT_OPEN + 16 * MINUTE);
+  assert.strictEqual(scheduler.nextFetchTime(SLOT_OPEN + 16 * MINUTE), SLOT_OPEN + 31 * MINUTE);
+
+  // Woken late, e.g. after the phone slept: fetch now
+  assert.strictEqual(scheduler.nextFetchTime(SLOT_OPEN + 50 * MINUTE), SLOT_OPEN + 50 * MINUTE);
+});
+
+test('skips slots while the pressure is settled', () => {
+  const scheduler = new Scheduler();
+  scheduler.recordSuccess(1010.0, SLOT_OPEN + 1 * MINUTE);
+  scheduler.recordSuccess(1010.2, SLOT_OPEN + 16 * MINUTE);
+  scheduler.recordSuccess(1010.1, SLOT_OPEN + 31 * MINUTE);
+  assert.strictEqual(scheduler.intervalMs(), 60 * MINUTE);
+  assert.strictEqual(scheduler.nextFetchTime(SLOT_OPEN + 31 * MINUTE), SLOT_OPEN + 91 * MINUTE);
+
+  // A front coming through: every slot again
+  scheduler.recordSuccess(1006.8, SLOT_OPEN + 46 * MINUTE);
+  assert.strictEqual(scheduler.intervalMs(), 15 * MINUTE);
+  assert.strictEqual(scheduler.nextFetchTime(SLOT_OPEN + 46 * MINUTE), SLOT_OPEN + 61 * MINUTE);
+});
+
+test('backs off after failures, up to 30 minutes', () => {
+  const scheduler = new Scheduler();
+  scheduler.recordSuccess(1013.2, SLOT_OPEN + 1 * MINUTE);
+  let now = SLOT_OPEN + 16 * MINUTE;
+  const delays = [];
+  for (let i = 0; i < 7; i++) {
+    scheduler.recordFailure(now);
+    const next = scheduler.nextFetchTime(now);
+    delays.push((next - now) / MINUTE);
+    now = next;
+  }
+  assert.deepStrictEqual(delays, [1, 2, 4, 8, 16, 30, 30]);
+
+  // A success goes back to the slots
+  scheduler.recordSuccess(1013.0, now);
+  assert.strictEqual(scheduler.failures, 0);
+  assert.ok((scheduler.nextFetchTime(now) - Scheduler.SLOT_DELAY_MS) % Scheduler.SLOT_MS === 0);
+});
+
+test('fetches at most hourly in low-power mode', () => {
+  const scheduler = new Scheduler();
+  scheduler.recordSuccess(1013.2, SLOT_OPEN + 1 * MINUTE);
+  assert.strictEqual(scheduler.setLowPower(true), true);
+  assert.strictEqual(scheduler.setLowPower(true), false);
+  assert.strictEqual(scheduler.nextFetchTime(SLOT_OPEN + 1 * MINUTE), SLOT_OPEN + 61 * MINUTE);
+
+  assert.strictEqual(scheduler.setLowPower(false), true);
+  assert.strictEqual(scheduler.nextFetchTime(SLOT_OPEN + 1 * MINUTE), SLOT_OPEN + 16 * MINUTE);
+});
+
+test('keeps the history across restarts, but not the power mode', () => {
+  const scheduler = new Scheduler();
+  scheduler.recordSuccess(1013.2, SLOT_OPEN + 1 * MINUTE);
+  scheduler.setLowPower(true);
+  const restored = new Scheduler(JSON.parse(JSON.stringify(scheduler)));
+  assert.deepStrictEqual(restored.history, scheduler.history);
+  assert.strictEqual(restored.lastSuccess, scheduler.lastSuccess);
+  assert.strictEqual(restored.lowPower, false);
+});
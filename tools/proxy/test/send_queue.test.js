@@ -0,0 +1,163 @@
+// node --test: the companion's AppMessage queue (src/pkjs/send_queue.js),
+// with a stand-in for Pebble.sendAppMessage and a hand-driven clock.
+
+const test = require('node:test');
+const assert = require('node:assert');
+
+const SendQueue = require('../../../src/pkjs/send_queue');
+
+// Timers that only fire from advance(), with now() following them
+function fakeClock() {
+  const clock = {
+    time: 0,
+    timers: [],
+    now: () => clock.time,
+    setTimeout(fn, ms) {
+      const timer = { at: clock.time + ms, fn };
+      clock.timers.push(timer);
+      return timer;
+    },
+    clearTimeout(timer) {
+      clock.timers = clock.timers.filter((t) => t !== timer);
+    },
+    advance(ms) {
+      const end = clock.time + ms;
+      for (;;) {
+        const due = clock.timers.filter((t) => t.at <= end).sort((a, b) => a.at - b.at)[0];
+        if (!due) break;
+        clock.timers = clock.timers.filter((t) => t !== due);
+        clock.time = due.at;
+        due.fn();
+      }
+      clock.time = end;
+    }
+  };
+  return clock;
+}
+
+// Records each send; the test answers the last one with ack() or nack()
+function fakeWatch() {
+  const watch = {
+    sent: [],
+    send(dict, ack, nack) {
+      watch.sent.push({ dict, ack, nack });
+    },
+    ack() {
+      watch.sent[watch.sent.length - 1].ack();
+    },
+    nack() {
+      watch.sent[watch.sent.length - 1].nack();
+    }
+  };
+  return watch;
+}
+
+function queueFor(watch, clock) {
+  return new SendQueue(watch.send, { now: clock.now, setTimeout: clock.setTimeout, clearTimeout: clock.clearTimeout });
+}
+
+test('sends one message at a time, in order', () => {
+  const clock = fakeClock();
+  const watch = fakeWatch();
+  const queue = queueFor(watch, clock);
+  const results = [];
+  queue.push('record', () => ({ 19: [1] }), (delivered) => results.push(['record', delivered]));
+  queue.push('timeline', () => ({ 20: [2] }), (delivered) => results.push(['timeline', delivered]));
+  assert.strictEqual(watch.sent.length, 1);
+
+  clock.advance(120);
+  watch.ack();
+  assert.deepStrictEqual(watch.sent.map((s) => s.dict), [{ 19: [1] }, { 20: [2] }]);
+  watch.ack();
+  assert.deepStrictEqual(results, [['record', true], ['timeline', true]]);
+  assert.strictEqual(queue.stats.delivered, 2);
+  assert.strictEqual(queue.stats.maxLatencyMs, 120);
+});
+
+test('retries a NACK with backoff and gives up after MAX_ATTEMPTS', () => {
+  const clock = fakeClock();
+  const watch = fakeWatch();
+  const queue = queueFor(watch, clock);
+  let result = null;
+  queue.push('record', () => ({ 19: [1] }), (delivered) => { result = delivered; });
+
+  const gaps = [];
+  for (let attempt = 1; attempt < SendQueue.MAX_ATTEMPTS; attempt++) {
+    const sentAt = clock.time;
+    watch.nack();
+    const before = watch.sent.length;
+    while (watch.sent.length === before) clock.advance(100);
+    gaps.push(clock.time - sentAt);
+  }
+  assert.deepStrictEqual(gaps, [1000, 2000, 4000, 8000, 16000]);
+  assert.strictEqual(result, null);
+
+  watch.nack();
+  assert.strictEqual(result, false);
+  assert.strictEqual(watch.sent.length, SendQueue.MAX_ATTEMPTS);
+  assert.strictEqual(queue.stats.dropped, 1);
+  assert.strictEqual(queue.stats.nacks, SendQueue.MAX_ATTEMPTS);
+
+  // The queue moves on to the next message
+  queue.push('record', () => ({ 19: [2] }));
+  assert.deepStrictEqual(watch.sent[watch.sent.length - 1].dict, { 19: [2] });
+});
+
+test('counts no answer as a timeout and ignores a late one', () => {
+  const clock = fakeClock();
+  const watch = fakeWatch();
+  const queue = queueFor(watch, clock);
+  const results = [];
+  queue.push('record', () => ({ 19: [1] }), (delivered) => results.push(delivered));
+  const first = watch.sent[0];
+
+  clock.advance(SendQueue.TIMEOUT_MS + 1000);
+  assert.strictEqual(queue.stats.timeouts, 1);
+  assert.strictEqual(watch.sent.length, 2);
+  first.ack(); // Too late to count
+  assert.deepStrictEqual(results, []);
+  watch.ack();
+  assert.deepStrictEqual(results, [true]);
+  assert.strictEqual(queue.stats.delivered, 1);
+});
+
+test('a newer record replaces one still waiting for its turn', () => {
+  const clock = fakeClock();
+  const watch = fakeWatch();
+  const queue = queueFor(watch, clock);
+  const results = [];
+  queue.push('timeline', () => ({ 20: [1] }));
+  queue.push('record', () => ({ 19: [1] }), (delivered) => results.push(['old', delivered]));
+  queue.push('record', () => ({ 19: [2] }), (delivered) => results.push(['new', delivered]));
+  assert.strictEqual(queue.stats.replaced, 1);
+
+  watch.ack();
+  watch.ack();
+  assert.deepStrictEqual(watch.sent.map((s) => s.dict), [{ 20: [1] }, { 19: [2] }]);
+  assert.deepStrictEqual(results, [['old', true], ['new', true]]);
+});
+
+test('a message already tried is not replaced', () => {
+  const clock = fakeClock();
+  const watch = fakeWatch();
+  const queue = queueFor(watch, clock);
+  queue.push('record', () => ({ 19: [1] }));
+  watch.nack(); // Waiting to be retried, but already sent once
+  queue.push('record', () => ({ 19: [2] }));
+  assert.strictEqual(queue.stats.replaced, 0);
+
+  clock.advance(1000);
+  watch.ack();
+  watch.ack();
+  assert.deepStrictEqual(watch.sent.map((s) => s.dict), [{ 19: [1] }, { 19: [1] }, { 19: [2] }]);
+});
+
+test('skips a message whose builder finds nothing to send', () => {
+  const clock = fakeClock();
+  const watch = fakeWatch();
+  const queue = queueFor(watch, clock);
+  let result = null;
+  queue.push('record', () => null, (delivered) => { result = delivered; });
+  assert.strictEqual(result, true);
+  assert.strictEqual(watch.sent.length, 0);
+});
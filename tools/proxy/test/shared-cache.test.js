@@ -0,0 +1,96 @@
+// node --test: the cache tier shared by cluster workers, over an in-process
+// stand-in for the IPC channel.
+
+const test = require('node:test');
+const assert = require('node:assert');
+const { EventEmitter } = require('node:events');
+
+const { SharedCacheHost, RemoteCache } = require('../shared-cache');
+
+// Two ends of an IPC channel: messages arrive asynchronously, serialised
+function channel() {
+  const primarySide = new EventEmitter();
+  const workerSide = new EventEmitter();
+  const deliver = (to) => (message) => setImmediate(() => to.emit('message', JSON.parse(JSON.stringify(message))));
+  primarySide.send = deliver(workerSide);
+  workerSide.send = deliver(primarySide);
+  return { primarySide, workerSide };
+}
+
+function startWorkers(host, count) {
+  return Array.from({ length: count }, () => {
+    const { primarySide, workerSide } = channel();
+    host.attach(primarySide);
+    return { primarySide, weather: new RemoteCache('weather', workerSide), place: new RemoteCache('place', workerSide) };
+  });
+}
+
+test('a key is loaded once across workers, then served from the primary', async () => {
+  const host = new SharedCacheHost(100);
+  const workers = startWorkers(host, 4);
+  let loads = 0;
+  const loader = () => new Promise((resolve) => setTimeout(() => resolve({ n: ++loads }), 20));
+
+  const results = await Promise.all(workers.flatMap((w) => [
+    w.weather.load('1,2', 1000, loader), w.weather.load('1,2', 1000, loader)
+  ]));
+  assert.strictEqual(loads, 1);
+  assert.ok(results.every((r) => r.value.n === 1 && !r.hit));
+
+  const again = await workers[3].weather.load('1,2', 1000, loader);
+  assert.deepStrictEqual(again, { value: { n: 1 }, hit: true, stale: false });
+  assert.strictEqual(host.cache('weather').size, 1);
+
+  const outcomes = workers.reduce((sum, w) => sum + w.weather.misses + w.weather.coalesced, 0);
+  assert.strictEqual(outcomes, 8);
+});
+
+test('caches of the same worker do not mix up replies', async () => {
+  const host = new SharedCacheHost(100);
+  const [worker] = startWorkers(host, 1);
+  const [weather, place] = await Promise.all([
+    worker.weather.load('k', 1000, async () => 'rain'),
+    worker.place.load('k', 1000, async () => 'Ely')
+  ]);
+  assert.strictEqual(weather.value, 'rain');
+  assert.strictEqual(place.value, 'Ely');
+});
+
+test('stale entries are answered at once and refreshed by one worker', async () => {
+  let now = 0;
+  const host = new SharedCacheHost(100, () => now);
+  const workers = startWorkers(host, 3);
+  await workers[0].weather.load('k', 1000, async () => 'old', 60000);
+  await new Promise((resolve) => setTimeout(resolve, 5)); // Let the fill reach the primary
+
+  now = 2000;
+  let refreshes = 0;
+  const refresh = () => new Promise((resolve) => setTimeout(() => resolve(`new${++refreshes}`), 20));
+  const answers = await Promise.all(workers.map((w) => w.weather.load('k', 1000, refresh, 60000)));
+  assert.ok(answers.every((a) => a.value === 'old' && a.stale));
+
+  await new Promise((resolve) => setTimeout(resolve, 60));
+  assert.strictEqual(refreshes, 1);
+  assert.strictEqual((await workers[2].weather.load('k', 1000, refresh, 60000)).value, 'new1');
+});
+
+test('failures reach waiting workers and are not cached', async () => {
+  const host = new SharedCacheHost(100);
+  const workers = startWorkers(host, 2);
+  const failing = () => new Promise((resolve, reject) => setTimeout(() => reject(new Error('upstream HTTP 503')), 20));
+  const results = await Promise.allSettled(workers.map((w) => w.place.load('k', 1000, failing)));
+  assert.ok(results.every((r) => r.status === 'rejected' && /503/.test(r.reason.message)));
+  assert.strictEqual(host.cache('place').size, 0);
+  assert.strictEqual((await workers[1].place.load('k', 1000, async () => 'Ely')).value, 'Ely');
+});
+
+test('a worker exiting mid-load releases the workers waiting on it', async () => {
+  const host = new SharedCacheHost(100);
+  const workers = startWorkers(host, 2);
+  workers[0].weather.load('k', 1000, () => new Promise(() => {})); // Never finishes
+  await new Promise((resolve) => setTimeout(resolve, 10));
+  const waiting = workers[1].weather.load('k', 1000, async () => 'unused');
+  await new Promise((resolve) => setTimeout(resolve, 10));
+  host.detach(workers[0].primarySide);
+  await assert.rejects(waiting, /exited/);
+});
@@ -0,0 +1,99 @@
+// node --test: the circuit breaker, and stale answers while upstream is down.
+
+const test = require('node:test');
+const assert = require('node:assert');
+
+const { CircuitBreaker, CircuitOpenError, upstreamName, CLOSED, OPEN, HALF_OPEN } = require('../upstream');
+const { TtlCache } = require('../cache');
+const { createConditions } = require('../conditions');
+
+const fail = async () => { throw new Error('upstream HTTP 503'); };
+const succeed = async () => 'ok';
+
+test('opens after repeated failures and fails fast while open', async () => {
+  let now = 0;
+  const breaker = new CircuitBreaker('forecast', { failureThreshold: 3, cooldownMs: 1000, now: () => now });
+  await assert.rejects(breaker.run(fail));
+  assert.strictEqual(await breaker.run(succeed), 'ok'); // A success resets the count
+  for (let i = 0; i < 3; i++) await assert.rejects(breaker.run(fail), /503/);
+  assert.strictEqual(breaker.state, OPEN);
+
+  let called = false;
+  await assert.rejects(breaker.run(async () => { called = true; }), CircuitOpenError);
+  assert.strictEqual(called, false);
+});
+
+test('lets one trial through after the cooldown', async () => {
+  let now = 0;
+  const breaker = new CircuitBreaker('reverse', { failureThreshold: 1, cooldownMs: 1000, now: () => now });
+  await assert.rejects(breaker.run(fail));
+  now = 1000;
+
+  // A failed trial opens it for another cooldown
+  await assert.rejects(breaker.run(fail), /503/);
+  assert.strictEqual(breaker.state, OPEN);
+  now = 1999;
+  await assert.rejects(breaker.run(succeed), CircuitOpenError);
+
+  // Only one trial at a time; its success closes the circuit
+  now = 2000;
+  let release;
+  const trial = breaker.run(() => new Promise((resolve) => { release = resolve; }));
+  assert.strictEqual(breaker.state, HALF_OPEN);
+  await assert.rejects(breaker.run(succeed), CircuitOpenError);
+  release('ok');
+  assert.strictEqual(await trial, 'ok');
+  assert.strictEqual(breaker.state, CLOSED);
+});
+
+test('names upstreams by their last path segment', () => {
+  assert.strictEqual(upstreamName('https://api.open-meteo.com/v1/forecast?latitude=1'), 'forecast');
+  assert.strictEqual(upstreamName('http://127.0.0.1:8090/v1/reverse?latitude=1'), 'reverse');
+});
+
+test('expired entries are served stale and refreshed in the background', async () => {
+  let now = 0;
+  const cache = new TtlCache(10, () => now);
+  let loads = 0;
+  const loader = async () => ++loads;
+
+  await cache.load('k', 1000, loader, 5000);
+  now = 2000;
+  assert.deepStrictEqual(await cache.load('k', 1000, loader, 5000), { value: 1, hit: true, stale: true });
+  await new Promise(setImmediate);
+  assert.deepStrictEqual(await cache.load('k', 1000, loader, 5000), { value: 2, hit: true, stale: false });
+
+  // A failed refresh leaves the stale value in place until staleMs runs out
+  now = 4000;
+  assert.deepStrictEqual(await cache.load('k', 1000, fail, 5000), { value: 2, hit: true, stale: true });
+  await new Promise(setImmediate);
+  assert.strictEqual((await cache.load('k', 1000, fail, 5000)).value, 2);
+  now = 8000;
+  await assert.rejects(cache.load('k', 1000, fail, 5000), /503/);
+  assert.deepStrictEqual([cache.hits, cache.staleHits, cache.misses], [1, 3, 2]);
+});
+
+test('conditions answer stale at once while upstream is failing', async () => {
+  let now = 0;
+  let healthy = true;
+  let slowCalls = 0;
+  const fetchJson = async (url) => {
+    if (!healthy) {
+      slowCalls++;
+      await new Promise((resolve) => setTimeout(resolve, 200));
+      throw new Error('timeout');
+    }
+    return url.includes('/v1/forecast') ? { temperature: 12.5 } : { results: [{ name: 'Ely' }] };
+  };
+  const conditions = createConditions({ fetchJson, openMeteoBase: 'http://up', geocodeBase: 'http://up', now: () => now });
+
+  await conditions(52.4, 0.26);
+  now = 10 * 60 * 1000; // Weather expired, place still fresh
+  healthy = false;
+  const started = Date.now();
+  const result = await conditions(52.4, 0.26);
+  assert.ok(Date.now() - started < 100, 'does not wait for the failing upstream');
+  assert.deepStrictEqual(result.cache, { weather: 'stale', place: 'hit' });
+  assert.strictEqual(result.weather.temperature, 12.5);
+  assert.strictEqual(slowCalls, 1);
+});
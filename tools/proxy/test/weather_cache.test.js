@@ -0,0 +1,76 @@
+// node --test: the companion's Open-Meteo reading cache
+// (src/pkjs/weather_cache.js), over an in-memory stand-in for localStorage
+// and a made-up clock.
+
+const test = require('node:test');
+const assert = require('node:assert');
+
+const WeatherCache = require('../../../src/pkjs/weather_cache');
+
+const MINUTE = 60 * 1000;
+const SLOT_START_S = 1760601600; // current.time of an Open-Meteo answer
+const SLOT_START = SLOT_START_S * 1000;
+const LAT = 52.7517;
+const LON = 0.3958;
+const READINGS = { pressure: 1013.2, temperature: 17.6, weatherCode: 2 };
+
+function memoryStorage(items) {
+  return {
+    items: items || {},
+    getItem(key) {
+      return key in this.items ? this.items[key] : null;
+    },
+    setItem(key, value) {
+      this.items[key] = String(value);
+    }
+  };
+}
+
+test('is fresh until the next slot is published', () => {
+  const cache = new WeatherCache(memoryStorage());
+  cache.put(LAT, LON, READINGS, [], SLOT_START_S, 900, SLOT_START + 3 * MINUTE);
+  const entry = cache.get(LAT, LON, SLOT_START + 10 * MINUTE);
+  assert.deepStrictEqual(entry.readings, READINGS);
+  assert.strictEqual(cache.isFresh(entry, SLOT_START + 16 * MINUTE - 1), true);
+
+  // Stale, but still there to show while a fetch replaces it
+  assert.strictEqual(cache.isFresh(entry, SLOT_START + 16 * MINUTE), false);
+  assert.ok(cache.get(LAT, LON, SLOT_START + 16 * MINUTE));
+});
+
+test('works out the slot from the clock when Open-Meteo sends none', () => {
+  const cache = new WeatherCache(memoryStorage());
+  cache.put(LAT, LON, READINGS, [], undefined, undefined, SLOT_START + 3 * MINUTE);
+  const entry = cache.get(LAT, LON, SLOT_START + 3 * MINUTE);
+  assert.strictEqual(entry.slotEnd, SLOT_START + 15 * MINUTE);
+});
+
+test('expires readings after a day', () => {
+  const cache = new WeatherCache(memoryStorage());
+  cache.put(LAT, LON, READINGS, [], SLOT_START_S, 900, SLOT_START);
+  assert.ok(cache.get(LAT, LON, SLOT_START + 24 * 60 * MINUTE - 1));
+  assert.strictEqual(cache.get(LAT, LON, SLOT_START + 24 * 60 * MINUTE), null);
+});
+
+test('shares readings within a 0.01 degree cell', () => {
+  const cache = new WeatherCache(memoryStorage());
+  cache.put(LAT, LON, READINGS, [], SLOT_START_S, 900, SLOT_START);
+  assert.ok(cache.get(LAT + 0.003, LON + 0.003, SLOT_START));
+  assert.strictEqual(cache.get(LAT + 0.01, LON, SLOT_START), null);
+});
+
+test('keeps the 8 most recent cells, across restarts', () => {
+  const storage = memoryStorage();
+  const cache = new WeatherCache(storage);
+  for (let i = 0; i < 10; i++) {
+    cache.put(LAT + i, LON, { pressure: 1000 + i }, [], SLOT_START_S, 900, SLOT_START + i);
+  }
+  const restored = new WeatherCache(storage);
+  assert.strictEqual(Object.keys(restored.entries).length, 8);
+  assert.strictEqual(restored.get(LAT + 1, LON, SLOT_START + 10), null);
+  assert.strictEqual(restored.get(LAT + 2, LON, SLOT_START + 10).readings.pressure, 1002);
+
+  // Unreadable storage starts empty rather than throwing
+  const broken = new WeatherCache(memoryStorage({ just_weather_responses: '{not json' }));
+  assert.strictEqual(broken.get(LAT, LON, SLOT_START), null);
+});
@@ -0,0 +1,44 @@
+// node --test: the companion's record packer (src/pkjs/weather_record.js),
+// here its settings version and how deltas carry it.
+
+const test = require('node:test');
+const assert = require('node:assert');
+
+const WeatherRecord = require('../../../src/pkjs/weather_record');
+
+const SETTINGS = {
+  temperature_unit: 'celsius',
+  wind_unit: 'mph',
+  precipitation_unit: 'mm',
+  update_countdown: true,
+  step_unit: 'miles'
+};
+
+test('sends the settings version after the next fetch, before the location', () => {
+  const bytes = WeatherRecord.pack({ settings: SETTINGS, settingsVersion: 0x0102, nextFetch: 900, location: 'Ely' }, 0);
+  const present = WeatherRecord.FIELD.UNITS | WeatherRecord.FIELD.SETTINGS | WeatherRecord.FIELD.NEXT_FETCH |
+    WeatherRecord.FIELD.SETTINGS_VERSION | WeatherRecord.FIELD.LOCATION;
+  assert.deepStrictEqual(bytes, [
+    WeatherRecord.VERSION, 0, present & 0xFF, present >> 8,
+    0x00, 0x0a, 0x84, 0x03, 0x02, 0x01, 3, 0x45, 0x6c, 0x79
+  ]);
+
+  // Only alongside the settings it numbers
+  assert.ok(!('settingsVersion' in WeatherRecord.encode({ settingsVersion: 3, pressure: 1013.2 })));
+});
+
+test('leaves out settings the watch has acknowledged by version', () => {
+  const acked = WeatherRecord.encode({ pressure: 1013.2, settings: SETTINGS, settingsVersion: 4 });
+  const resend = WeatherRecord.encode({ pressure: 1012.9, settings: SETTINGS, settingsVersion: 4 });
+  assert.deepStrictEqual(WeatherRecord.changes(resend, acked), { pressure: 10129 });
+});
+
+test('sends units, settings and version together for a new version', () => {
+  const acked = WeatherRecord.encode({ pressure: 1013.2, settings: SETTINGS, settingsVersion: 4 });
+  const changed = Object.assign({}, SETTINGS, { wind_unit: 'kph' });
+  const update = WeatherRecord.encode({ pressure: 1013.2, settings: changed, settingsVersion: 5 });
+  assert.deepStrictEqual(WeatherRecord.changes(update, acked), { units: 0x02, settings: 0x0a, settingsVersion: 5 });
+
+  // The watch does not have it yet after a failed send
+  assert.deepStrictEqual(WeatherRecord.changes(update, null), update);
+});
@@ -0,0 +1,81 @@
+// Upstream connection handling: keep-alive agents so requests reuse warm
+// sockets, and a circuit breaker per upstream so a failing one is skipped
+// straight away instead of every caller waiting out the timeout.
+
+const http = require('http');
+const https = require('https');
+
+// Bounded pools: enough sockets for a burst of cache misses, a few kept
+// warm between them
+const AGENT_OPTIONS = { keepAlive: true, maxSockets: 64, maxFreeSockets: 16, timeout: 30000 };
+
+// For node-fetch's agent option, which may be a function of the parsed URL
+function keepAliveAgents(options = AGENT_OPTIONS) {
+  const agents = { 'http:': new http.Agent(options), 'https:': new https.Agent(options) };
+  const agentFor = (url) => agents[url.protocol];
+  agentFor.destroy = () => Object.values(agents).forEach((agent) => agent.destroy());
+  return agentFor;
+}
+
+// Upstreams are told apart by the last path segment: forecast or reverse
+function upstreamName(url) {
+  return url.split('?')[0].split('/').pop();
+}
+
+class CircuitOpenError extends Error {
+  constructor(name) {
+    super(`upstream ${name} circuit open`);
+    this.name = 'CircuitOpenError';
+  }
+}
+
+const CLOSED = 'closed';
+const OPEN = 'open';
+const HALF_OPEN = 'half-open';
+
+// Closed: calls go through, and failureThreshold failures in a row open the
+// circuit. Open: calls fail at once with CircuitOpenError for cooldownMs.
+// Half-open: one trial call goes through; success closes the circuit,
+// failure opens it for another cooldown.
+class CircuitBreaker {
+  constructor(name, { failureThreshold = 5, cooldownMs = 30000, now = Date.now } = {}) {
+    this.name = name;
+    this.failureThreshold = failureThreshold;
+    this.cooldownMs = cooldownMs;
+    this.now = now;
+    this.state = CLOSED;
+    this.failures = 0;
+    this.openedAt = 0;
+    this.trialRunning = false;
+  }
+
+  async run(request) {
+    if (this.state === OPEN && this.now() - this.openedAt >= this.cooldownMs) {
+      this.state = HALF_OPEN;
+    }
+    if (this.state === OPEN || (this.state === HALF_OPEN && this.trialRunning)) {
+      throw new CircuitOpenError(this.name);
+    }
+    const trial = this.state === HALF_OPEN;
+    this.trialRunning = trial;
+    try {
+      const value = await request();
+      this.state = CLOSED;
+      this.failures = 0;
+      return value;
+    } catch (e) {
+      this.failures++;
+      if (trial || this.failures >= this.failureThreshold) {
+        this.state = OPEN;
+        this.openedAt = this.now();
+      }
+      throw e;
+    } finally {
+      if (trial) this.trialRunning = false;
+    }
+  }
+}
+
+module.exports = {
+  keepAliveAgents, upstreamName, CircuitBreaker, CircuitOpenError, CLOSED, OPEN, HALF_OPEN
+};